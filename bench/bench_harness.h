@@ -0,0 +1,146 @@
+/*
+Minimal self-contained microbenchmark harness in the style of Google Benchmark, so that the benchmarks build and run
+offline with nothing but a C++17 compiler.
+Each benchmark is a function that receives a state object with the number of iterations to run. The number of iterations
+is calibrated once so that a run lasts at least the minimum time, and the same number is then used for every repetition.
+The reported time is the median over the repetitions, which keeps the output stable enough to be compared across commits.
+
+Command line options:
+    --filter=<substring>     only run the benchmarks whose name contains the substring
+    --min_time=<seconds>     minimum duration of the calibrated run (default 0.2)
+    --repetitions=<n>        number of timed repetitions (default 5)
+    --format=<console|csv>   output format (default console)
+*/
+
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+    class state {
+    private:
+        size_t iterations{};
+        size_t items_processed{};
+    public:
+        state(const size_t& iterations_in) : iterations{ iterations_in } {}
+        size_t get_iterations() const noexcept { return iterations; }
+        size_t get_items_processed() const noexcept { return items_processed; }
+        //Number of items (moves, positions, nodes...) processed over all the iterations, to report a throughput
+        void set_items_processed(const size_t& items) noexcept { items_processed = items; }
+    };
+
+    struct benchmark {
+        std::string name;
+        std::function<void(state&)> function;
+    };
+
+    inline std::vector<benchmark>& registry() {
+        static std::vector<benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    inline void register_benchmark(const std::string& name, const std::function<void(state&)>& function) {
+        registry().push_back({ name, function });
+    }
+
+    //Prevent the compiler from optimising away a value that is computed but otherwise unused
+    template <class c_type> inline void do_not_optimize(const c_type& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static const void* volatile sink;
+        sink = &value;
+#endif
+    }
+
+    namespace detail {
+        inline double run_once(const benchmark& bm, const size_t& iterations, size_t& items_processed) {
+            state bm_state{ iterations };
+            auto start = std::chrono::steady_clock::now();
+            bm.function(bm_state);
+            auto end = std::chrono::steady_clock::now();
+            items_processed = bm_state.get_items_processed();
+            return std::chrono::duration<double>(end - start).count();
+        }
+
+        inline bool starts_with(const std::string& argument, const std::string& prefix) {
+            return argument.compare(0, prefix.size(), prefix) == 0;
+        }
+    }
+
+    inline int run_benchmarks(int argc, char** argv) {
+        std::string filter;
+        double min_time{ 0.2 };
+        int repetitions{ 5 };
+        bool csv{ false };
+        for (int i{ 1 }; i < argc; i++) {
+            std::string argument{ argv[i] };
+            if (detail::starts_with(argument, "--filter=")) {
+                filter = argument.substr(9);
+            }
+            else if (detail::starts_with(argument, "--min_time=")) {
+                min_time = std::atof(argument.substr(11).c_str());
+            }
+            else if (detail::starts_with(argument, "--repetitions=")) {
+                repetitions = std::max(1, std::atoi(argument.substr(14).c_str()));
+            }
+            else if (argument == "--format=csv") {
+                csv = true;
+            }
+            else if (argument != "--format=console") {
+                std::fprintf(stderr, "Unknown option %s\n", argument.c_str());
+                return 1;
+            }
+        }
+
+        if (csv) {
+            std::printf("name,iterations,ns_per_iteration,items_per_second\n");
+        }
+        else {
+            std::printf("%-52s %15s %12s %16s\n", "Benchmark", "Time", "Iterations", "Throughput");
+            std::printf("%s\n", std::string(98, '-').c_str());
+        }
+        for (const auto& bm : registry()) {
+            if (!filter.empty() && bm.name.find(filter) == std::string::npos) {
+                continue;
+            }
+            //Calibrate the number of iterations, growing it until a run takes at least min_time
+            size_t iterations{ 1 };
+            size_t items_processed{};
+            double elapsed{ detail::run_once(bm, iterations, items_processed) };
+            while (elapsed < min_time && iterations < (size_t{ 1 } << 40)) {
+                double factor{ elapsed > 0 ? 1.4 * min_time / elapsed : 10.0 };
+                iterations = static_cast<size_t>(iterations * std::min(10.0, std::max(2.0, factor)));
+                elapsed = detail::run_once(bm, iterations, items_processed);
+            }
+            std::vector<double> timings;
+            for (int repetition{}; repetition < repetitions; repetition++) {
+                timings.push_back(detail::run_once(bm, iterations, items_processed));
+            }
+            std::sort(timings.begin(), timings.end());
+            double median{ timings[timings.size() / 2] };
+            double ns_per_iteration{ 1e9 * median / iterations };
+            double items_per_second{ items_processed ? items_processed / median : 0.0 };
+            if (csv) {
+                std::printf("%s,%zu,%.2f,%.0f\n", bm.name.c_str(), iterations, ns_per_iteration, items_per_second);
+            }
+            else if (items_per_second > 0) {
+                std::printf("%-52s %12.1f ns %12zu %12.3fM/s\n", bm.name.c_str(), ns_per_iteration, iterations, items_per_second / 1e6);
+            }
+            else {
+                std::printf("%-52s %12.1f ns %12zu\n", bm.name.c_str(), ns_per_iteration, iterations);
+            }
+            std::fflush(stdout);
+        }
+        return 0;
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+/*
+Fixed corpus of positions shared by the benchmarks, so that numbers from different commits are measured on the same input.
+The positions cover the opening, middlegame and endgame and only use the rules implemented by the board
+(no castling rights, en passant squares or promotions are needed).
+*/
+
+#ifndef BENCH_POSITIONS_H
+#define BENCH_POSITIONS_H
+
+#include "enum_attributes.h"
+#include <array>
+#include <string_view>
+
+namespace bench {
+    struct corpus_position {
+        std::string_view name;
+        std::string_view fen;
+    };
+
+    constexpr std::array<corpus_position, 8> position_corpus{ {
+        { "start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1" },
+        { "open_game", "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w - - 2 3" },
+        { "italian", "r1bqk2r/pppp1ppp/2n2n2/2b1p3/2B1P3/2NP1N2/PPP2PPP/R1BQK2R b - - 0 5" },
+        { "middlegame", "r2q1rk1/pp2bppp/2n1bn2/3p4/3P4/2NBBN2/PP3PPP/R2Q1RK1 w - - 4 10" },
+        { "tactical", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w - - 0 1" },
+        { "rook_endgame", "8/5pk1/6p1/8/3R4/6P1/r4PK1/8 w - - 0 40" },
+        { "queen_endgame", "6k1/5p2/6p1/8/8/6PP/5QK1/3q4 b - - 0 45" },
+        { "pawn_endgame", "8/8/4k3/3p1p2/3P1P2/4K3/8/8 w - - 0 50" },
+    } };
+
+    //Colour to move, read from the second field of the FEN string
+    constexpr piece_colour colour_to_move(const std::string_view& fen) {
+        size_t space{ fen.find(' ') };
+        return (space != std::string_view::npos && space + 1 < fen.size() && fen[space + 1] == 'b') ? piece_colour::black : piece_colour::white;
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,766 @@
+/*
+Microbenchmarks of the engine primitives, run over the fixed corpus of positions in bench_positions.h:
+    -get_allowed_moves of each piece type
+    -allowed_moves_getter for each of the 8 sliding steps
+    -coordinate conversions
+    -board::check_for_check, board::get_all_pieces_allowed_moves, has_any_legal_move, count_legal_moves, format_moves and draw (full frames and redraws of the changed cells only)
+    -move application (the same sequence of board calls as the game loop in main.cpp)
+    -legality queries answered one board at a time, and with legality_batch on one thread and on a thread pool
+    -static evaluation (evaluations per second), and the incremental material and piece-square update on make/unmake
+    -position move generation (pseudo-legal and legal) and attack detection
+    -static exchange evaluation of every capture, and move ordering
+    -the first legal move and all the legal moves handed out by the staged move picker, to compare with generate_legal_moves
+    -quiescence search nodes per second, with and without the quiet checks, and a depth 3 search with quiescence
+    -repetition and fifty-move-rule checks of the position history, with a full window of reversible moves
+    -opening book lookups (hits and misses) and weighted move choice, in a book of one million entries
+    -endgame tablebase probes, in tables of 3 pieces
+    -the wait for all the allowed moves after the prompt, generated on the spot or precomputed in the background
+    -saving a game to its checkpoint file after a move, and restoring it from the file
+    -taking back a move and playing it again, and jumping to random plies of a long game
+Build on Linux (from the repository root):
+    g++ -std=c++17 -O2 -Iinclude -Ibench bench/microbenchmarks.cpp $(find src -name '*.cpp' ! -name main.cpp) -o microbenchmarks
+*/
+
+#include "bench_harness.h"
+#include "bench_positions.h"
+#include "board.h"
+#include "piece.h"
+#include "coordinate_transforms.h"
+#include "enum_attributes.h"
+#include "allowed_moves_getter.h"
+#include "position.h"
+#include "legality_batch.h"
+#include "thread_pool.h"
+#include "evaluation.h"
+#include "occupancy.h"
+#include "frame_renderer.h"
+#include "position_history.h"
+#include "opening_book.h"
+#include "tablebase.h"
+#include "game_session.h"
+#include "move_precomputer.h"
+#include "game_checkpoint.h"
+#include "move_ordering.h"
+#include "move_picker.h"
+#include "search.h"
+#include <array>
+#include <cstdio>
+#include <random>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    using board_coordinates_t = std::pair<char, int>;
+
+    struct corpus_entry {
+        std::string fen;
+        piece_colour colour_turn;
+        std::unique_ptr<board> gameboard;
+        std::array<board_occupation, 64> board_matrix;
+        std::vector<std::unique_ptr<piece>> pieces; //Copies of the pieces on the board, to call their member functions directly
+    };
+
+    std::vector<corpus_entry>& corpus() {
+        static std::vector<corpus_entry> entries;
+        if (entries.empty()) {
+            for (const auto& position : bench::position_corpus) {
+                corpus_entry entry;
+                entry.fen = std::string(position.fen);
+                entry.colour_turn = bench::colour_to_move(position.fen);
+                entry.gameboard = std::make_unique<board>(entry.fen);
+                for (int location{ 1 }; location <= 64; location++) {
+                    entry.board_matrix[location - 1] = entry.gameboard->get_element(location);
+                    if (entry.board_matrix[location - 1] != board_occupation::empty) {
+                        board_coordinates_t coords{ coordinates::to_board_coordinates(location) };
+                        entry.pieces.push_back(create_piece(entry.gameboard->get_piece_symbol(coords), coords,
+                            static_cast<piece_colour>(entry.board_matrix[location - 1])));
+                    }
+                }
+                entries.push_back(std::move(entry));
+            }
+        }
+        return entries;
+    }
+
+    void register_piece_benchmark(const std::string& name, const piece_symbol& symbol) {
+        bench::register_benchmark("piece_get_allowed_moves/" + name, [symbol](bench::state& state) {
+            size_t moves{};
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const auto& entry : corpus()) {
+                    for (const auto& corpus_piece : entry.pieces) {
+                        if (corpus_piece->get_symbol() == symbol) {
+                            std::list<int> allowed_moves{ corpus_piece->get_allowed_moves(entry.board_matrix) };
+                            moves += allowed_moves.size();
+                            bench::do_not_optimize(allowed_moves);
+                        }
+                    }
+                }
+            }
+            state.set_items_processed(moves);
+        });
+    }
+
+    template <int step> void register_getter_benchmark(const std::string& name) {
+        bench::register_benchmark("allowed_moves_getter/" + name, [](bench::state& state) {
+            allowed_moves_getter<step> getter;
+            size_t moves{};
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const auto& entry : corpus()) {
+                    for (int location{ 1 }; location <= 64; location++) {
+                        if (entry.board_matrix[location - 1] != static_cast<board_occupation>(entry.colour_turn)) {
+                            continue;
+                        }
+                        std::list<int> allowed_moves{ getter.get_allowed_moves(location, entry.board_matrix, opposite_colour(entry.colour_turn)) };
+                        moves += allowed_moves.size();
+                        bench::do_not_optimize(allowed_moves);
+                    }
+                }
+            }
+            state.set_items_processed(moves);
+        });
+    }
+
+    //Same sequence of calls as the game loop in main.cpp to move a piece
+    void apply_move(board& gameboard, const board_coordinates_t& old_coords, const board_coordinates_t& new_coords, const piece_colour& colour_turn) {
+        int old_location{ coordinates::flatten_board_coordinates(old_coords) };
+        int new_location{ coordinates::flatten_board_coordinates(new_coords) };
+        board_occupation old_occupation{ gameboard.get_element(old_location) };
+        if (static_cast<int>(gameboard.get_element(new_location)) == static_cast<int>(opposite_colour(colour_turn))) {
+            gameboard.capture_piece(new_coords, colour_turn);
+        }
+        gameboard.set_piece_location(old_coords, new_coords);
+        gameboard.set_element(old_location) = board_occupation::empty;
+        gameboard.set_element(new_location) = old_occupation;
+        gameboard.store_move(new_coords);
+    }
+
+    //Every pseudo-legal move of the corpus positions, legal or not, as legality queries
+    const std::vector<legality_query>& legality_queries() {
+        static std::vector<legality_query> queries;
+        if (queries.empty()) {
+            for (const auto& entry : corpus()) {
+                position query_position{ entry.fen };
+                move_list moves;
+                query_position.generate_pseudo_legal_moves(moves);
+                for (const chess_move& candidate_move : moves) {
+                    queries.push_back({ query_position, candidate_move });
+                }
+            }
+        }
+        return queries;
+    }
+
+    void register_benchmarks() {
+        register_piece_benchmark("pawn", piece_symbol::pawn);
+        register_piece_benchmark("rook", piece_symbol::rook);
+        register_piece_benchmark("knight", piece_symbol::knight);
+        register_piece_benchmark("bishop", piece_symbol::bishop);
+        register_piece_benchmark("king", piece_symbol::king);
+        register_piece_benchmark("queen", piece_symbol::queen);
+
+        register_getter_benchmark<1>("right");
+        register_getter_benchmark<-1>("left");
+        register_getter_benchmark<8>("up");
+        register_getter_benchmark<-8>("down");
+        register_getter_benchmark<9>("up_right");
+        register_getter_benchmark<-9>("down_left");
+        register_getter_benchmark<7>("up_left");
+        register_getter_benchmark<-7>("down_right");
+
+        bench::register_benchmark("coordinates/flatten_board_coordinates", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const char& column : coordinates::alphabetical_string) {
+                    for (int row{ 1 }; row <= 8; row++) {
+                        bench::do_not_optimize(coordinates::flatten_board_coordinates({ column, row }));
+                    }
+                }
+            }
+            state.set_items_processed(64 * state.get_iterations());
+        });
+        bench::register_benchmark("coordinates/to_board_coordinates", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (int location{ 1 }; location <= 64; location++) {
+                    bench::do_not_optimize(coordinates::to_board_coordinates(location));
+                }
+            }
+            state.set_items_processed(64 * state.get_iterations());
+        });
+        bench::register_benchmark("coordinates/get_column_number", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (int location{ 1 }; location <= 64; location++) {
+                    bench::do_not_optimize(coordinates::get_column_number(location));
+                }
+            }
+            state.set_items_processed(64 * state.get_iterations());
+        });
+
+        bench::register_benchmark("board/check_for_check", [](bench::state& state) {
+            //Use every piece of the colour that just moved as the piece that made the last move
+            size_t calls{};
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (auto& entry : corpus()) {
+                    for (const auto& corpus_piece : entry.pieces) {
+                        if (corpus_piece->get_colour() == entry.colour_turn) {
+                            continue;
+                        }
+                        bool last_move_check{ false };
+                        bench::do_not_optimize(entry.gameboard->check_for_check(corpus_piece->get_location(), last_move_check));
+                        calls++;
+                    }
+                }
+            }
+            state.set_items_processed(calls);
+        });
+        bench::register_benchmark("board/get_all_pieces_allowed_moves", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const auto& entry : corpus()) {
+                    bench::do_not_optimize(entry.gameboard->get_all_pieces_allowed_moves(entry.colour_turn, false, 0));
+                }
+            }
+            state.set_items_processed(corpus().size() * state.get_iterations());
+        });
+        bench::register_benchmark("board/has_any_legal_move", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const auto& entry : corpus()) {
+                    bench::do_not_optimize(entry.gameboard->has_any_legal_move(entry.colour_turn, false, 0));
+                }
+            }
+            state.set_items_processed(corpus().size() * state.get_iterations());
+        });
+        bench::register_benchmark("board/count_legal_moves", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const auto& entry : corpus()) {
+                    bench::do_not_optimize(entry.gameboard->count_legal_moves(entry.colour_turn, false, 0));
+                }
+            }
+            state.set_items_processed(corpus().size() * state.get_iterations());
+        });
+        bench::register_benchmark("board/format_moves", [](bench::state& state) {
+            //Only done when the user asks for all the allowed moves
+            std::vector<std::vector<board_move>> corpus_moves;
+            for (const auto& entry : corpus()) {
+                corpus_moves.push_back(entry.gameboard->get_all_pieces_allowed_moves(entry.colour_turn, false, 0));
+            }
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const auto& moves : corpus_moves) {
+                    bench::do_not_optimize(board::format_moves(moves));
+                }
+            }
+            state.set_items_processed(corpus_moves.size() * state.get_iterations());
+        });
+        bench::register_benchmark("board/draw_full_frame", [](bench::state& state) {
+            //Frame built from scratch, as for the first frame, without writing it to the console
+            frame_renderer renderer;
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const auto& entry : corpus()) {
+                    renderer.invalidate();
+                    entry.gameboard->draw(renderer, font::MS_Gothic, entry.colour_turn, false);
+                    bench::do_not_optimize(renderer.render().size());
+                }
+            }
+            state.set_items_processed(corpus().size() * state.get_iterations());
+        });
+        bench::register_benchmark("board/draw_selected_piece_full_frame", [](bench::state& state) {
+            frame_renderer renderer;
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const auto& entry : corpus()) {
+                    renderer.invalidate();
+                    entry.gameboard->draw(renderer, font::MS_Gothic, entry.colour_turn, entry.pieces.front()->get_location(), false);
+                    bench::do_not_optimize(renderer.render().size());
+                }
+            }
+            state.set_items_processed(corpus().size() * state.get_iterations());
+        });
+        bench::register_benchmark("board/draw_diff_frame", [](bench::state& state) {
+            //Alternate the selected piece, so each frame only redraws the two highlighted tiles
+            std::vector<frame_renderer> renderers(corpus().size());
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (size_t index{}; index < corpus().size(); index++) {
+                    const corpus_entry& entry{ corpus()[index] };
+                    const auto& selected_piece{ i % 2 == 0 ? entry.pieces.front() : entry.pieces.back() };
+                    entry.gameboard->draw(renderers[index], font::MS_Gothic, entry.colour_turn, selected_piece->get_location(), false);
+                    bench::do_not_optimize(renderers[index].render().size());
+                }
+            }
+            state.set_items_processed(corpus().size() * state.get_iterations());
+        });
+        bench::register_benchmark("board/apply_move", [](bench::state& state) {
+            //Move the first movable piece of each corpus position back and forth. The boards are rebuilt every
+            //few hundred moves so that the moves history does not grow with the number of iterations
+            const size_t moves_per_rebuild{ 512 };
+            size_t moves{};
+            for (const auto& entry : corpus()) {
+                board_coordinates_t old_coords;
+                board_coordinates_t new_coords;
+                bool found_move{ false };
+                for (const auto& corpus_piece : entry.pieces) {
+                    if (corpus_piece->get_colour() != entry.colour_turn || corpus_piece->get_symbol() == piece_symbol::pawn) {
+                        continue;
+                    }
+                    for (const int& move : entry.gameboard->get_piece_allowed_moves(corpus_piece->get_location(), false, 0)) {
+                        if (entry.gameboard->get_element(move) == board_occupation::empty) {
+                            old_coords = corpus_piece->get_location();
+                            new_coords = coordinates::to_board_coordinates(move);
+                            found_move = true;
+                            break;
+                        }
+                    }
+                    if (found_move) {
+                        break;
+                    }
+                }
+                if (!found_move) {
+                    continue;
+                }
+                auto gameboard{ std::make_unique<board>(entry.fen) };
+                for (size_t i{}; i < state.get_iterations(); i++) {
+                    if (i % moves_per_rebuild == 0) {
+                        gameboard = std::make_unique<board>(entry.fen);
+                    }
+                    apply_move(*gameboard, old_coords, new_coords, entry.colour_turn);
+                    apply_move(*gameboard, new_coords, old_coords, entry.colour_turn);
+                    moves += 2;
+                }
+            }
+            state.set_items_processed(moves);
+        });
+
+        bench::register_benchmark("legality/board_per_query", [](bench::state& state) {
+            //What a caller has to do without the batch API: build a board and get the allowed moves of the piece
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const auto& query : legality_queries()) {
+                    board query_board{ query.query_position.to_fen() };
+                    std::list<int> allowed_moves{ query_board.get_piece_allowed_moves(coordinates::to_board_coordinates(query.candidate_move.from + 1), false, 0) };
+                    bench::do_not_optimize(std::find(allowed_moves.begin(), allowed_moves.end(), query.candidate_move.to + 1) != allowed_moves.end());
+                }
+            }
+            state.set_items_processed(legality_queries().size() * state.get_iterations());
+        });
+        bench::register_benchmark("legality/batch_single_thread", [](bench::state& state) {
+            legality_batch batch;
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                bench::do_not_optimize(batch.evaluate(legality_queries()).count());
+            }
+            state.set_items_processed(legality_queries().size() * state.get_iterations());
+        });
+        bench::register_benchmark("legality/batch_thread_pool", [](bench::state& state) {
+            //Large batches, so that the work is split among all the threads of the pool
+            static std::vector<legality_query> large_batch;
+            while (large_batch.size() < 100000) {
+                large_batch.insert(large_batch.end(), legality_queries().begin(), legality_queries().end());
+            }
+            static thread_pool pool{ std::thread::hardware_concurrency() };
+            legality_batch batch{ &pool };
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                bench::do_not_optimize(batch.evaluate(large_batch).count());
+            }
+            state.set_items_processed(large_batch.size() * state.get_iterations());
+        });
+
+        static std::vector<position> corpus_positions;
+        for (const auto& entry : corpus()) {
+            corpus_positions.emplace_back(entry.fen);
+        }
+        bench::register_benchmark("evaluation/evaluate", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const position& corpus_position : corpus_positions) {
+                    bench::do_not_optimize(evaluation::evaluate(corpus_position));
+                }
+            }
+            state.set_items_processed(corpus_positions.size() * state.get_iterations());
+        });
+        bench::register_benchmark("evaluation/material_pst", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const position& corpus_position : corpus_positions) {
+                    bench::do_not_optimize(evaluation::material_pst(corpus_position, corpus_position.get_colour_turn()));
+                }
+            }
+            state.set_items_processed(corpus_positions.size() * state.get_iterations());
+        });
+        bench::register_benchmark("evaluation/material_pst_from_scratch", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const position& corpus_position : corpus_positions) {
+                    bench::do_not_optimize(evaluation::material_pst_from_scratch(corpus_position));
+                }
+            }
+            state.set_items_processed(corpus_positions.size() * state.get_iterations());
+        });
+        bench::register_benchmark("position/generate_pseudo_legal_moves", [](bench::state& state) {
+            move_list moves;
+            size_t moves_generated{};
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const position& corpus_position : corpus_positions) {
+                    corpus_position.generate_pseudo_legal_moves(moves);
+                    moves_generated += moves.size();
+                }
+            }
+            state.set_items_processed(moves_generated);
+        });
+        bench::register_benchmark("position/generate_legal_moves", [](bench::state& state) {
+            move_list moves;
+            size_t moves_generated{};
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const position& corpus_position : corpus_positions) {
+                    corpus_position.generate_legal_moves(moves);
+                    moves_generated += moves.size();
+                }
+            }
+            state.set_items_processed(moves_generated);
+        });
+        bench::register_benchmark("position/is_attacked", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const position& corpus_position : corpus_positions) {
+                    for (int square{}; square < 64; square++) {
+                        bench::do_not_optimize(corpus_position.is_attacked(square, corpus_position.get_colour_turn()));
+                    }
+                }
+            }
+            state.set_items_processed(64 * corpus_positions.size() * state.get_iterations());
+        });
+        bench::register_benchmark("position/make_unmake", [](bench::state& state) {
+            //Includes the incremental update of the material and piece-square score
+            size_t moves_made{};
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (position corpus_position : corpus_positions) {
+                    move_list moves;
+                    corpus_position.generate_pseudo_legal_moves(moves);
+                    for (const chess_move& pseudo_legal_move : moves) {
+                        std::uint8_t captured{ corpus_position.make_move(pseudo_legal_move) };
+                        bench::do_not_optimize(corpus_position);
+                        corpus_position.unmake_move(pseudo_legal_move, captured);
+                    }
+                    moves_made += moves.size();
+                }
+            }
+            state.set_items_processed(moves_made);
+        });
+        //The captures of the corpus positions and of the positions one move later, where there are more exchanges
+        static std::vector<std::pair<position, chess_move>> corpus_captures;
+        for (const position& corpus_position : corpus_positions) {
+            move_list moves;
+            corpus_position.generate_pseudo_legal_moves(moves);
+            for (const chess_move& first_move : moves) {
+                position next_position{ corpus_position };
+                next_position.make_move(first_move);
+                move_list replies;
+                next_position.generate_pseudo_legal_moves(replies);
+                for (const chess_move& reply : replies) {
+                    if (move_ordering::is_capture(next_position, reply)) {
+                        corpus_captures.push_back({ next_position, reply });
+                    }
+                }
+            }
+        }
+        bench::register_benchmark("position/see", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const auto& [capture_position, capture] : corpus_captures) {
+                    bench::do_not_optimize(capture_position.see(capture));
+                }
+            }
+            state.set_items_processed(corpus_captures.size() * state.get_iterations());
+        });
+        bench::register_benchmark("ordering/order_moves", [](bench::state& state) {
+            move_list moves;
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const position& corpus_position : corpus_positions) {
+                    corpus_position.generate_pseudo_legal_moves(moves);
+                    move_ordering::order_moves(corpus_position, moves);
+                    bench::do_not_optimize(moves);
+                }
+            }
+            state.set_items_processed(corpus_positions.size() * state.get_iterations());
+        });
+        //The first move is what a node that cuts off at once costs; all the moves, a node that searches them all
+        bench::register_benchmark("picker/first_move", [](bench::state& state) {
+            chess_move picked_move;
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const position& corpus_position : corpus_positions) {
+                    move_picker picker{ corpus_position };
+                    bench::do_not_optimize(picker.next(picked_move));
+                }
+            }
+            state.set_items_processed(corpus_positions.size() * state.get_iterations());
+        });
+        bench::register_benchmark("picker/all_moves", [](bench::state& state) {
+            chess_move picked_move;
+            size_t moves_picked{};
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const position& corpus_position : corpus_positions) {
+                    move_picker picker{ corpus_position };
+                    while (picker.next(picked_move)) {
+                        moves_picked++;
+                    }
+                }
+            }
+            state.set_items_processed(moves_picked);
+        });
+        //Quiescence search of each corpus position with a full window, so that nothing is cut off at the root
+        for (const bool& quiescence_checks : { false, true }) {
+            std::string suffix{ quiescence_checks ? "_with_checks" : "" };
+            bench::register_benchmark("search/quiescence" + suffix, [quiescence_checks](bench::state& state) {
+                searcher quiescence_searcher{ search_settings{ quiescence_checks } };
+                for (size_t i{}; i < state.get_iterations(); i++) {
+                    for (position corpus_position : corpus_positions) {
+                        bench::do_not_optimize(quiescence_searcher.quiescence(corpus_position, -searcher::mate_score - 1, searcher::mate_score + 1, 0));
+                    }
+                }
+                state.set_items_processed(quiescence_searcher.get_statistics().quiescence_nodes);
+            });
+        }
+        bench::register_benchmark("search/depth_3", [](bench::state& state) {
+            //Nodes of the main search and of the quiescence search
+            searcher depth_searcher;
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const position& corpus_position : corpus_positions) {
+                    bench::do_not_optimize(depth_searcher.search(corpus_position, 3));
+                }
+            }
+            state.set_items_processed(depth_searcher.get_statistics().nodes + depth_searcher.get_statistics().quiescence_nodes);
+        });
+
+        //99 reversible moves after the last capture or pawn move: the longest window before a fifty-move draw
+        static position_history long_history;
+        for (std::uint64_t ply{}; ply < 100; ply++) {
+            long_history.push(0x9E3779B97F4A7C15ULL * (ply + 1), ply == 0);
+        }
+        bench::register_benchmark("history/is_repetition", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                bench::do_not_optimize(long_history.is_repetition());
+            }
+            state.set_items_processed(state.get_iterations());
+        });
+        bench::register_benchmark("history/push_is_repetition_pop", [](bench::state& state) {
+            //As the search would do it at every node
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                long_history.push(i, false);
+                bench::do_not_optimize(long_history.is_repetition() || long_history.is_fifty_move_draw());
+                long_history.pop();
+            }
+            state.set_items_processed(state.get_iterations());
+        });
+
+        //A book of one million random entries plus the legal moves of the corpus positions, written to a temporary file
+        static opening_book book;
+        {
+            std::vector<book_entry> book_entries;
+            std::mt19937_64 random_generator{ 1 };
+            for (size_t i{}; i < 1000000; i++) {
+                book_entries.push_back({ random_generator(), 8, 16, 1 });
+            }
+            for (const position& corpus_position : corpus_positions) {
+                move_list moves;
+                corpus_position.generate_legal_moves(moves);
+                for (size_t i{}; i < moves.size(); i++) {
+                    book_entries.push_back({ corpus_position.get_hash(), moves[i].from, moves[i].to, static_cast<std::uint16_t>(i + 1) });
+                }
+            }
+            const std::string book_path{ "microbenchmarks_book.bin" };
+            opening_book::write(book_path, book_entries);
+            book = opening_book{ book_path };
+            std::remove(book_path.c_str()); //the mapping stays valid
+        }
+        bench::register_benchmark("book/find_hit", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const position& corpus_position : corpus_positions) {
+                    size_t number_of_moves;
+                    bench::do_not_optimize(book.find(corpus_position.get_hash(), number_of_moves));
+                    bench::do_not_optimize(number_of_moves);
+                }
+            }
+            state.set_items_processed(corpus_positions.size() * state.get_iterations());
+        });
+        bench::register_benchmark("book/find_miss", [](bench::state& state) {
+            std::uint64_t hash{ 12345 };
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                hash = hash * 6364136223846793005ULL + 1442695040888963407ULL;
+                size_t number_of_moves;
+                bench::do_not_optimize(book.find(hash, number_of_moves));
+            }
+            state.set_items_processed(state.get_iterations());
+        });
+        bench::register_benchmark("book/pick_move", [](bench::state& state) {
+            //Includes the legal move generation that validates the book moves
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const position& corpus_position : corpus_positions) {
+                    chess_move chosen_move;
+                    bench::do_not_optimize(book.pick_move(corpus_position, i, chosen_move));
+                }
+            }
+            state.set_items_processed(corpus_positions.size() * state.get_iterations());
+        });
+
+        //Generated here rather than in the benchmark, so that it does not count in the calibration run
+        static tablebase endgame_tablebase;
+        static std::vector<position> endgame_positions;
+        {
+            thread_pool pool;
+            for (const char* material : { "KRK", "KQK", "KPK" }) {
+                endgame_tablebase.generate(material, pool);
+            }
+            for (const char* fen : { "8/8/8/3k4/8/8/8/KR6 w - - 0 1", "8/8/8/8/8/2k5/8/K6r w - - 0 1",
+                "4k3/8/8/8/8/8/3Q4/4K3 b - - 0 1", "8/8/3k4/8/8/8/4P3/4K3 w - - 0 1" }) {
+                endgame_positions.push_back(position{ fen });
+            }
+        }
+        bench::register_benchmark("tablebase/probe", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const position& endgame_position : endgame_positions) {
+                    tablebase_result result;
+                    bench::do_not_optimize(endgame_tablebase.probe(endgame_position, result));
+                    bench::do_not_optimize(result);
+                }
+            }
+            state.set_items_processed(endgame_positions.size() * state.get_iterations());
+        });
+
+        //What the player waits for after asking for all the moves: generating them, or taking the ones computed in the
+        //background during the think time
+        static game_session opening_session;
+        static move_precomputer precomputed_moves;
+        precomputed_moves.start(opening_session);
+        bench::register_benchmark("session/prompt_moves_generated", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                bench::do_not_optimize(opening_session.get_all_allowed_moves());
+            }
+            state.set_items_processed(state.get_iterations());
+        });
+        bench::register_benchmark("session/prompt_moves_precomputed", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                bench::do_not_optimize(precomputed_moves.get().all_allowed_moves.size());
+            }
+            state.set_items_processed(state.get_iterations());
+        });
+        bench::register_benchmark("session/precompute_start_cancel", [](bench::state& state) {
+            //Cost of a move made before the background computation finished
+            move_precomputer cancelled_moves;
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                cancelled_moves.start(opening_session);
+                cancelled_moves.cancel();
+            }
+            state.set_items_processed(state.get_iterations());
+        });
+
+        //A game of 60 plies, saved without waiting for the disk as the server does
+        static game_session played_session;
+        for (int ply{}; ply < 60 && !played_session.is_game_over(); ply++) {
+            std::vector<board_move> moves{ played_session.get_all_allowed_moves() };
+            const board_move& chosen{ moves[(ply * 7) % moves.size()] };
+            played_session.make_move(chosen.from, chosen.to);
+        }
+        static checkpoint_file checkpoint{ "microbenchmarks.checkpoint" };
+        std::remove("microbenchmarks.checkpoint"); //the mapping stays valid
+        checkpoint.save(played_session);
+        bench::register_benchmark("checkpoint/save", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                checkpoint.save(played_session);
+            }
+            state.set_items_processed(state.get_iterations());
+        });
+        bench::register_benchmark("checkpoint/restore", [](bench::state& state) {
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                game_session restored_session{ *checkpoint.get_last_snapshot() };
+                bench::do_not_optimize(restored_session.get_colour_turn());
+            }
+            state.set_items_processed(state.get_iterations());
+        });
+
+        //Navigation through a game of up to 400 plies
+        static game_session long_session;
+        for (int ply{}; ply < 400 && !long_session.is_game_over(); ply++) {
+            std::vector<board_move> moves{ long_session.get_all_allowed_moves() };
+            const board_move& chosen{ moves[(ply * 7) % moves.size()] };
+            long_session.make_move(chosen.from, chosen.to);
+        }
+        bench::register_benchmark("session/take_back_and_replay", [](bench::state& state) {
+            size_t last_ply{ long_session.get_moves().size() };
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                long_session.take_back();
+                long_session.go_to_ply(last_ply);
+            }
+            state.set_items_processed(2 * state.get_iterations());
+        });
+        bench::register_benchmark("session/go_to_random_ply", [](bench::state& state) {
+            std::mt19937 random_generator{ 7 };
+            size_t number_of_plies{ long_session.get_moves().size() };
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                long_session.go_to_ply(random_generator() % (number_of_plies + 1));
+            }
+            state.set_items_processed(state.get_iterations());
+        });
+
+        //The occupancy kernels at every SIMD level the processor supports
+        static std::vector<position> position_batch;
+        for (size_t i{}; i < 512; i++) {
+            position_batch.push_back(corpus_positions[i % corpus_positions.size()]);
+        }
+        for (int level{}; level <= static_cast<int>(occupancy::get_supported_simd_level()); level++) {
+            occupancy::simd_level simd_level{ static_cast<occupancy::simd_level>(level) };
+            std::string suffix{ std::string("/") + occupancy::simd_level_name(simd_level) };
+            bench::register_benchmark("occupancy/from_board_matrix" + suffix, [simd_level](bench::state& state) {
+                occupancy::set_simd_level(simd_level);
+                for (size_t i{}; i < state.get_iterations(); i++) {
+                    for (const corpus_entry& entry : corpus()) {
+                        bench::do_not_optimize(occupancy::from_board_matrix(entry.board_matrix));
+                    }
+                }
+                state.set_items_processed(corpus().size() * state.get_iterations());
+            });
+            bench::register_benchmark("occupancy/from_squares" + suffix, [simd_level](bench::state& state) {
+                occupancy::set_simd_level(simd_level);
+                for (size_t i{}; i < state.get_iterations(); i++) {
+                    for (const position& corpus_position : corpus_positions) {
+                        bench::do_not_optimize(occupancy::from_squares(corpus_position.get_squares()));
+                    }
+                }
+                state.set_items_processed(corpus_positions.size() * state.get_iterations());
+            });
+            bench::register_benchmark("occupancy/count_equal_positions" + suffix, [simd_level](bench::state& state) {
+                occupancy::set_simd_level(simd_level);
+                for (size_t i{}; i < state.get_iterations(); i++) {
+                    bench::do_not_optimize(occupancy::count_equal_positions(corpus_positions.back(), position_batch));
+                }
+                state.set_items_processed(position_batch.size() * state.get_iterations());
+            });
+            bench::register_benchmark("occupancy/batch_mobility" + suffix, [simd_level](bench::state& state) {
+                occupancy::set_simd_level(simd_level);
+                std::vector<int> mobility;
+                for (size_t i{}; i < state.get_iterations(); i++) {
+                    occupancy::batch_mobility(position_batch, mobility);
+                    bench::do_not_optimize(mobility);
+                }
+                state.set_items_processed(position_batch.size() * state.get_iterations());
+            });
+        }
+        bench::register_benchmark("occupancy/board_matrix_scan", [](bench::state& state) {
+            //The same occupancy masks, read square by square from the board as the rest of the program does
+            for (size_t i{}; i < state.get_iterations(); i++) {
+                for (const corpus_entry& entry : corpus()) {
+                    std::uint64_t white{}, black{};
+                    for (int location{ 1 }; location <= 64; location++) {
+                        board_occupation tile{ entry.gameboard->get_element(location) };
+                        white |= std::uint64_t{ tile == board_occupation::white_piece } << (location - 1);
+                        black |= std::uint64_t{ tile == board_occupation::black_piece } << (location - 1);
+                    }
+                    bench::do_not_optimize(white);
+                    bench::do_not_optimize(black);
+                }
+            }
+            state.set_items_processed(corpus().size() * state.get_iterations());
+        });
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        register_benchmarks();
+        return bench::run_benchmarks(argc, argv);
+    }
+    catch (const std::exception& bench_err) {
+        std::cerr << bench_err.what() << std::endl;
+        return 1;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+/*
+Time-to-depth benchmark of the search. Every position of the benchmark corpus (bench_positions.h) is searched to the
+same depth with several sets of the selective features of the searcher (search.h):
+    -none of them (alpha-beta with the quiescence search only)
+    -all of them
+    -all of them but one, for each feature, to show the nodes and the time that feature saves
+For each set, it prints the total time and nodes to reach the depth on the whole corpus, the speedup over the search
+without any feature, the counters of the features (how often each one applied) and the share of the cutoffs made by the
+first move searched, which measures the move ordering.
+Options:
+    --depth=<n>     depth of the searches (default 6)
+    --quick         only the sets with none and with all of the features
+Build on Linux (from the repository root):
+    g++ -std=c++17 -O2 -Iinclude -Ibench bench/search_benchmark.cpp $(find src -name '*.cpp' ! -name main.cpp) -o search_benchmark
+    ./search_benchmark --depth=6
+*/
+
+#include "bench_positions.h"
+#include "position.h"
+#include "search.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct feature_set {
+        std::string name;
+        search_settings settings;
+    };
+
+    search_settings with_all_features(const bool& enabled) {
+        search_settings settings;
+        settings.null_move_pruning = enabled;
+        settings.late_move_reductions = enabled;
+        settings.futility_pruning = enabled;
+        settings.check_extensions = enabled;
+        settings.aspiration_windows = enabled;
+        return settings;
+    }
+
+    std::vector<feature_set> make_feature_sets(const bool& quick) {
+        std::vector<feature_set> sets{ { "none", with_all_features(false) }, { "all", with_all_features(true) } };
+        if (!quick) {
+            sets.push_back({ "all but null move", with_all_features(true) });
+            sets.back().settings.null_move_pruning = false;
+            sets.push_back({ "all but reductions", with_all_features(true) });
+            sets.back().settings.late_move_reductions = false;
+            sets.push_back({ "all but futility", with_all_features(true) });
+            sets.back().settings.futility_pruning = false;
+            sets.push_back({ "all but check ext.", with_all_features(true) });
+            sets.back().settings.check_extensions = false;
+            sets.push_back({ "all but aspiration", with_all_features(true) });
+            sets.back().settings.aspiration_windows = false;
+        }
+        return sets;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int depth{ 6 };
+    bool quick{ false };
+    for (int i{ 1 }; i < argc; i++) {
+        if (std::strncmp(argv[i], "--depth=", 8) == 0) {
+            depth = std::max(1, std::atoi(argv[i] + 8));
+        }
+        else if (std::strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        }
+        else {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    std::vector<position> corpus_positions;
+    for (const bench::corpus_position& entry : bench::position_corpus) {
+        corpus_positions.emplace_back(std::string{ entry.fen });
+    }
+
+    std::cout << "Time to depth " << depth << " on " << corpus_positions.size() << " positions" << std::endl;
+    std::cout << std::left << std::setw(20) << "Features" << std::right << std::setw(12) << "Time (s)" << std::setw(14)
+        << "Nodes" << std::setw(10) << "Speedup" << "  Counters" << std::endl;
+    double time_without_features{};
+    for (const feature_set& set : make_feature_sets(quick)) {
+        searcher set_searcher{ set.settings };
+        auto start{ std::chrono::steady_clock::now() };
+        for (const position& corpus_position : corpus_positions) {
+            set_searcher.search(corpus_position, depth);
+        }
+        double elapsed{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+        if (set.name == "none") {
+            time_without_features = elapsed;
+        }
+        const search_statistics& statistics{ set_searcher.get_statistics() };
+        std::cout << std::left << std::setw(20) << set.name << std::right << std::fixed << std::setprecision(3)
+            << std::setw(12) << elapsed << std::setw(14) << statistics.nodes + statistics.quiescence_nodes
+            << std::setprecision(1) << std::setw(9) << time_without_features / elapsed << "x"
+            << "  null move " << statistics.null_move_cutoffs << "/" << statistics.null_move_searches
+            << ", reduced " << statistics.reduced_moves << " (" << statistics.reduction_researches << " searched again)"
+            << ", futile " << statistics.futility_pruned << ", check ext. " << statistics.check_extensions
+            << ", aspiration fails " << statistics.aspiration_researches
+            << ", first move cutoffs " << std::setprecision(1) << 100 * statistics.first_move_cutoff_rate() << "%" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+/*
+Startup benchmark of the engine. It checks two things:
+    -that no code of the engine runs before main: the static initialisers of the executable (the entries of its
+     .init_array section) are listed by name, and any translation unit initialiser (_GLOBAL__sub_I_<file>) is reported
+     as a failure. The benchmark itself includes no header with static objects (e.g. <iostream>), so every such entry
+     comes from the engine sources linked with it
+    -how long it takes to launch a process linked with the whole engine and let it exit, on average over many launches
+Only Linux (ELF) executables are supported.
+Build on Linux (from the repository root), and do not strip the executable, as the check reads its symbol table:
+    g++ -std=c++17 -O2 -Iinclude bench/startup_benchmark.cpp $(find src -name '*.cpp' ! -name main.cpp) -o startup_benchmark
+    ./startup_benchmark --launches=500
+The exit code is 1 if the engine has static constructors.
+*/
+
+#include "position.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <elf.h>
+#include <link.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char** environ;
+
+//Bounds of the .init_array section, defined by the linker
+extern "C" {
+    extern void (*__init_array_start[])(int, char**, char**) __attribute__((weak));
+    extern void (*__init_array_end[])(int, char**, char**) __attribute__((weak));
+}
+
+namespace {
+    struct function_symbol {
+        std::uint64_t address;
+        std::string name;
+    };
+
+    int find_load_bias(dl_phdr_info* info, size_t, void* load_bias) {
+        //The first object reported is the executable itself
+        *static_cast<std::uintptr_t*>(load_bias) = info->dlpi_addr;
+        return 1;
+    }
+
+    //Functions of the static symbol table of the running executable, at their address in memory
+    std::vector<function_symbol> read_function_symbols() {
+        std::vector<function_symbol> symbols;
+        std::FILE* executable{ std::fopen("/proc/self/exe", "rb") };
+        if (!executable) {
+            return symbols;
+        }
+        std::vector<char> contents;
+        char buffer[65536];
+        size_t bytes_read;
+        while ((bytes_read = std::fread(buffer, 1, sizeof(buffer), executable)) > 0) {
+            contents.insert(contents.end(), buffer, buffer + bytes_read);
+        }
+        std::fclose(executable);
+        if (contents.size() < sizeof(Elf64_Ehdr) || std::memcmp(contents.data(), ELFMAG, SELFMAG) != 0 || contents[EI_CLASS] != ELFCLASS64) {
+            return symbols;
+        }
+        std::uintptr_t load_bias{};
+        dl_iterate_phdr(find_load_bias, &load_bias);
+
+        const Elf64_Ehdr* header{ reinterpret_cast<const Elf64_Ehdr*>(contents.data()) };
+        const Elf64_Shdr* sections{ reinterpret_cast<const Elf64_Shdr*>(contents.data() + header->e_shoff) };
+        for (int section{}; section < header->e_shnum; section++) {
+            if (sections[section].sh_type != SHT_SYMTAB) {
+                continue;
+            }
+            const Elf64_Sym* table{ reinterpret_cast<const Elf64_Sym*>(contents.data() + sections[section].sh_offset) };
+            const char* names{ contents.data() + sections[sections[section].sh_link].sh_offset };
+            size_t number_of_symbols{ sections[section].sh_size / sizeof(Elf64_Sym) };
+            for (size_t symbol{}; symbol < number_of_symbols; symbol++) {
+                if (ELF64_ST_TYPE(table[symbol].st_info) == STT_FUNC && table[symbol].st_value != 0) {
+                    symbols.push_back({ load_bias + table[symbol].st_value, names + table[symbol].st_name });
+                }
+            }
+        }
+        return symbols;
+    }
+
+    //Returns the number of translation unit initialisers found
+    int report_static_initialisers() {
+        if (!__init_array_start || !__init_array_end) {
+            std::printf("Static initialisers: the linker did not define the bounds of .init_array\n");
+            return 0;
+        }
+        std::vector<function_symbol> symbols{ read_function_symbols() };
+        size_t number_of_entries{ static_cast<size_t>(__init_array_end - __init_array_start) };
+        int translation_unit_initialisers{};
+        std::printf("Static initialisers (.init_array entries): %zu\n", number_of_entries);
+        for (size_t entry{}; entry < number_of_entries; entry++) {
+            std::uint64_t address{ reinterpret_cast<std::uintptr_t>(__init_array_start[entry]) };
+            auto symbol{ std::find_if(symbols.begin(), symbols.end(), [&address](const function_symbol& candidate) {
+                return candidate.address == address;
+            }) };
+            std::string name{ symbol != symbols.end() ? symbol->name : "<unknown>" };
+            bool from_translation_unit{ name.rfind("_GLOBAL__sub_I_", 0) == 0 };
+            translation_unit_initialisers += from_translation_unit;
+            std::printf("    %-40s %s\n", name.c_str(), from_translation_unit ? "STATIC CONSTRUCTOR" : "(runtime)");
+        }
+        return translation_unit_initialisers;
+    }
+
+    //Average and median wall time of launching the executable with --probe and waiting for it to exit
+    void time_launches(const char* executable_path, const int& launches) {
+        std::vector<double> launch_times;
+        char probe_argument[]{ "--probe" };
+        char* arguments[]{ const_cast<char*>(executable_path), probe_argument, nullptr };
+        for (int launch{}; launch < launches; launch++) {
+            auto start{ std::chrono::steady_clock::now() };
+            pid_t child;
+            if (posix_spawn(&child, executable_path, nullptr, nullptr, arguments, environ) != 0) {
+                std::printf("Could not launch %s\n", executable_path);
+                return;
+            }
+            int status{};
+            waitpid(child, &status, 0);
+            launch_times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        }
+        double total{};
+        for (const double& launch_time : launch_times) {
+            total += launch_time;
+        }
+        std::nth_element(launch_times.begin(), launch_times.begin() + launches / 2, launch_times.end());
+        std::printf("Process launch to exit over %d launches: mean %.1f us, median %.1f us\n",
+            launches, total / launches, launch_times[launches / 2]);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--probe") == 0) {
+        //Time to the first legal moves, so that the probe uses the engine as a real request would
+        position start;
+        move_list moves;
+        start.generate_legal_moves(moves);
+        return moves.size() == 20 ? 0 : 2;
+    }
+    int launches{ 200 };
+    for (int i{ 1 }; i < argc; i++) {
+        if (std::strncmp(argv[i], "--launches=", 11) == 0) {
+            launches = std::max(1, std::atoi(argv[i] + 11));
+        }
+    }
+    int translation_unit_initialisers{ report_static_initialisers() };
+    time_launches("/proc/self/exe", launches);
+    if (translation_unit_initialisers > 0) {
+        std::printf("FAILED: %d translation units have static constructors\n", translation_unit_initialisers);
+        return 1;
+    }
+    std::printf("OK: the engine has no static constructors\n");
+    return 0;
+}
+#else
+int main() {
+    std::printf("The startup benchmark only supports Linux\n");
+    return 0;
+}
+#endif
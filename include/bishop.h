@@ -1,7 +1,7 @@
 /*
 Luis Fernandez - 10 April 2020
-Declaration of bishop piece. It overloads the pure virtual functions of the piece abstract base class.
-It has a default and a parametrised constructor, as well as a destructor.
+Declaration of bishop piece. It overloads the pure virtual function of the piece abstract base class.
+It has a default and two parametrised constructors (starting column or arbitrary board coordinates), as well as a destructor.
 */
 
 #ifndef BISHOP_H
@@ -16,9 +16,9 @@ class bishop : public piece {
 public:
     bishop();
     bishop(const char& column, const piece_colour& colour_in);
+    bishop(const std::pair<char, int>& location_in, const piece_colour& colour_in);
     ~bishop();
     std::list<int> get_allowed_moves(const std::array<board_occupation, 64>& board_matrix) const;
-    std::string get_symbol_string(const bool& on_white_tile) const noexcept;
 };
 
 #endif
\ No newline at end of file
@@ -9,13 +9,25 @@ the member functions of the pieces can be accessed from this class.
 
 #include "enum_attributes.h"
 #include "console_visualisation.h"
+#include "position_history.h"
 #include <vector>
 #include <list>
 #include <array>
 #include <string>
 #include <map>
+#include <memory>
+#include <cstdint>
 
 class piece; //Forward declaration of the piece class to use it in the board's member data
+class position;
+class frame_renderer;
+struct occupancy_masks;
+
+//A move of a piece, with the locations (from 1 to 64) it moves from and to
+struct board_move {
+    int from{};
+    int to{};
+};
 
 class board {
 private:
@@ -25,26 +37,69 @@ private:
     std::array<board_occupation, 64> board_matrix{};
     std::vector<std::string> moves_history{};
     std::map<std::pair<char, int>, int> piece_location_to_index_dictionary;
+    position_history history{}; //hashes of the positions of the game, for the draws by repetition and fifty-move rule
+
+    void draw(frame_renderer& renderer, const font& chosen_font, const piece_colour& colour_turn, const std::pair<char, int>* selected_piece_coords, const bool& check) const;
+
+    //Legality of a move of a piece: it must not leave the king of its colour (found at original_king_coords) in check
+    std::pair<char, int> get_king_coords(const piece_colour& colour) const;
+    bool is_move_legal(const piece& moving_piece, const int& move, const std::pair<char, int>& original_king_coords, const bool& last_move_check, const int& last_move) const;
 public:
     board();
+    board(const std::string& fen); //Set up the position from the piece placement field of a FEN string
+    board(const std::array<std::uint8_t, 64>& squares); //Set up the pieces from their codes (see position.h), from a1 to h8
     ~board();
 
     //get and set elements of the board matrix
     board_occupation get_element(const int& element) const;
     board_occupation& set_element(const int& element);
+    occupancy_masks get_occupancy() const; //one 64-bit mask per colour, bit i for location i + 1
+
+    //get the symbol of the piece at the given board coordinates
+    piece_symbol get_piece_symbol(const std::pair<char, int>& piece_board_coords) const;
 
     //set and get the moves of the pieces
-    std::list<std::string> get_all_pieces_allowed_moves(const piece_colour& colour_turn, const bool& last_move_check, const int& last_move) const;
+    //The moves of each piece are next to each other, in the order of the pieces map. No string is built until they are shown
+    std::vector<board_move> get_all_pieces_allowed_moves(const piece_colour& colour_turn, const bool& last_move_check, const int& last_move) const;
     std::list<int> get_piece_allowed_moves(const std::pair<char, int>& piece_board_coords, const bool& last_move_check, const int& last_move) const;
+    //Same legality rules as get_piece_allowed_moves, without building any list. The first one stops at the first legal move
+    bool has_any_legal_move(const piece_colour& colour_turn, const bool& last_move_check, const int& last_move) const;
+    int count_legal_moves(const piece_colour& colour_turn, const bool& last_move_check, const int& last_move) const;
     void set_piece_location(const std::pair<char, int>& piece_board_coords, const std::pair<char, int>& new_coordinates);
 
     bool check_for_check(const std::pair<char, int>& last_move_opposite_team, bool& last_move_check); //check if king is in check
     piece_symbol capture_piece(const std::pair<char, int>& new_piece_coords, const piece_colour& colour_turn); //send piece to cemetery
     void store_move(const std::pair<char, int>& new_board_coords); //store move in move_history
+    //Restore the rest of a saved game: the captured pieces in the order they were captured, the moves history (the piece
+    //that moved and where it moved to) and the positions of the game
+    void add_to_cemetery(const piece_colour& colour, const piece_symbol& symbol);
+    void store_move(const piece_colour& colour, const piece_symbol& symbol, const std::pair<char, int>& new_board_coords);
+    //Navigate through a game: take back the last move, from old_board_coords to new_board_coords (the last piece captured
+    //comes back if it captured one), replace all the pieces at once, and forget the last moves and captures. The history
+    //of positions is left unchanged, as the caller restores it with set_history
+    void take_back_move(const std::pair<char, int>& old_board_coords, const std::pair<char, int>& new_board_coords, const bool& captured);
+    void set_pieces(const std::array<std::uint8_t, 64>& squares); //same as the constructor from the codes of the pieces
+    void truncate_moves_and_cemetery(const size_t& number_of_moves, const size_t& number_of_captures);
+    const position_history& get_history() const noexcept { return history; }
+    void set_history(const position_history& saved_history) noexcept { history = saved_history; }
+
+    //Copy of the pieces as a position, e.g. to probe the endgame tablebase
+    position to_position(const piece_colour& colour_turn) const;
+    //Zobrist hash of the pieces and the colour turn, equal to the one of a position with the same pieces (see position.h)
+    std::uint64_t get_hash(const piece_colour& colour_turn) const;
+    //Record the position reached after each move (and the starting one), with the colour to move next. The halfmove
+    //clock starts again after a capture or a pawn move
+    void record_position(const piece_colour& colour_turn, const bool& capture_or_pawn_move);
+    int get_halfmove_clock() const noexcept;
+    bool is_fifty_move_draw() const noexcept;
+    bool is_threefold_repetition() const noexcept;
+
+    //Moves written as "a2→b3", sorted alphabetically, to show them to the user
+    static std::vector<std::string> format_moves(const std::vector<board_move>& moves);
 
-    //Two overloads to show the board, the second one highlighting a selected piece
-    void show(const font& chosen_font, const piece_colour& colour_turn, const bool& check) const;
-    void show(const font& chosen_font, const piece_colour& colour_turn, const std::pair<char, int>& piece_coords, const bool& check) const;
+    //Two overloads to draw the board in the next frame of the renderer, the second one highlighting a selected piece
+    void draw(frame_renderer& renderer, const font& chosen_font, const piece_colour& colour_turn, const bool& check) const;
+    void draw(frame_renderer& renderer, const font& chosen_font, const piece_colour& colour_turn, const std::pair<char, int>& piece_coords, const bool& check) const;
 };
 
 #endif
\ No newline at end of file
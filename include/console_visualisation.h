@@ -1,16 +1,18 @@
 ﻿/*
 This folder defines classes, functions and constants which aid in the consolue visualisation of the game.
 The two fonts that support Unicode symbols are NSimSun and MS_Gothic, and depending on which one is used some symbols
-print differently. Therefore, a dictionary is created that takes in a pair of font class object a string indicating the
-desired unicode symbol, and returns the corresponding symbol. This is used in the main.cpp file for output.
+print differently. Therefore, a table indexed by font and glyph id gives the corresponding symbol. The symbols of the
+pieces are in another table, indexed by piece colour, piece symbol and tile colour. Both tables are built at compile
+time and shared by all the files that include this header.
 Symbols which do not change depending on font are also defined as constants.
 */
 
 #ifndef CONSOLE_VISUALISATION_H
 #define CONSOLE_VISUALISATION_H
 
-#include <map>
-#include <string>
+#include "enum_attributes.h"
+#include <array>
+#include <string_view>
 
 enum class font {
     NSimSun,
@@ -26,36 +28,39 @@ enum class font_colour {
     black_white_back = 240
 };
 
-namespace {
-    const std::map<std::pair<font, std::string>, std::string> create_board_symbols_dictionary() {
-
-        std::map<std::pair<font, std::string>, std::string> symbols_dictionary;
-
-        symbols_dictionary.insert({ {font::NSimSun,"white_tile"},u8"█" });
-        symbols_dictionary.insert({ {font::MS_Gothic, "white_tile"},u8"██" });
-
-        symbols_dictionary.insert({ {font::NSimSun,"line"},u8"—" });
-        symbols_dictionary.insert({ {font::MS_Gothic,"line"},u8"——" });
+//Glyphs of the board that depend on the font, indexed by font and glyph id
+enum class board_glyph {
+    white_tile,
+    line,
+    small_line,
+    top_line,
+    bottom_line,
+};
 
-        symbols_dictionary.insert({ {font::NSimSun,"small_line"},u8"-" });
-        symbols_dictionary.insert({ {font::MS_Gothic,"small_line"},u8"—" });
+inline constexpr std::array<std::array<std::string_view, 5>, 2> board_symbols{ {
+    { u8"█", u8"—", u8"-", u8"▔", u8"▁" }, //NSimSun
+    { u8"██", u8"——", u8"—", u8"▔▔", u8"▁▁" }, //MS_Gothic
+} };
 
-        symbols_dictionary.insert({ {font::NSimSun,"top_line"},u8"▔" });
-        symbols_dictionary.insert({ {font::MS_Gothic,"top_line"},u8"▔▔" });
+constexpr std::string_view get_board_symbol(const font& chosen_font, const board_glyph& glyph) noexcept {
+    return board_symbols[static_cast<size_t>(chosen_font)][static_cast<size_t>(glyph)];
+}
 
-        symbols_dictionary.insert({ {font::NSimSun,"bottom_line"},u8"▁" });
-        symbols_dictionary.insert({ {font::MS_Gothic,"bottom_line"},u8"▁▁" });
+//Symbols of the pieces, indexed by piece colour, piece symbol and tile colour (black, white). A piece on a white tile
+//is drawn with the symbol of its own colour, and on a black tile with the symbol of the opposite colour
+inline constexpr std::array<std::array<std::array<std::string_view, 2>, 6>, 2> piece_symbols{ {
+    { { { u8"♟", u8"♙" }, { u8"♜", u8"♖" }, { u8"♞", u8"♘" }, { u8"♝", u8"♗" }, { u8"♚", u8"♔" }, { u8"♛", u8"♕" } } }, //white
+    { { { u8"♙", u8"♟" }, { u8"♖", u8"♜" }, { u8"♘", u8"♞" }, { u8"♗", u8"♝" }, { u8"♔", u8"♚" }, { u8"♕", u8"♛" } } }, //black
+} };
 
-        return symbols_dictionary;
-    }
+constexpr std::string_view get_piece_symbol_string(const piece_colour& colour, const piece_symbol& symbol, const bool& on_white_tile) noexcept {
+    return piece_symbols[static_cast<size_t>(colour)][static_cast<size_t>(symbol)][on_white_tile];
 }
 
-const std::map<std::pair<font, std::string>, std::string> board_symbols{ create_board_symbols_dictionary() };
-
-constexpr std::string_view top_left_corner{ u8"┌" };
-constexpr std::string_view top_right_corner{ u8"┐" };
-constexpr std::string_view bottom_left_corner{ u8"└" };
-constexpr std::string_view bottom_right_corner{ u8"┘" };
+inline constexpr std::string_view top_left_corner{ u8"┌" };
+inline constexpr std::string_view top_right_corner{ u8"┐" };
+inline constexpr std::string_view bottom_left_corner{ u8"└" };
+inline constexpr std::string_view bottom_right_corner{ u8"┘" };
 
 void change_font_colour(const font_colour& colour);
 
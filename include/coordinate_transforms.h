@@ -1,41 +1,33 @@
 /*
 Luis Fernandez - 26 March 2020
-This code contains the declaration of the dictionaries used to transform from alphabetical to numerical column notation,
+This code contains the constexpr functions used to transform from alphabetical to numerical column notation,
 as well as functions to convert from location in 8x8 board matrix to 1D array and viceversa. 
 */
 
 #ifndef COORDINATETRANSFORMATIONS_H
 #define COORDINATETRANSFORMATIONS_H
 
-#include <iostream>
-#include <map>
-#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
 
 namespace coordinates {
-    const std::string alphabetical_string{"abcdefgh"};
+    inline constexpr std::string_view alphabetical_string{ "abcdefgh" };
 
-    template <class c_type_1, class c_type_2> const std::map<c_type_2, c_type_1> 
-    reverse_dictionary(const std::map<c_type_1, c_type_2>& map_to_reverse) {
-        std::map<c_type_2, c_type_1> reversed_dict;
-        for (const auto& value_pair : map_to_reverse) {
-            reversed_dict[value_pair.second] = value_pair.first;
+    //Column number (1 to 8) of a column letter ('a' to 'h'), and the other way round. They throw std::out_of_range otherwise
+    constexpr int column_number(const char& column_letter) {
+        if (column_letter < 'a' || column_letter > 'h') {
+            throw std::out_of_range("Error: column must be a letter between 'a' and 'h'.");
         }
-        return reversed_dict;
+        return column_letter - 'a' + 1;
     }
-
-    namespace {
-        const std::map<char, int> create_alphabetical_dictionary() {
-            std::map<char, int> alphabetical_dict;
-            for (size_t i{}; i < 8; i++) {
-                alphabetical_dict[alphabetical_string[i]] = i + 1;
-            }
-            return alphabetical_dict;
+    constexpr char column_letter(const int& column_number) {
+        if (column_number < 1 || column_number > 8) {
+            throw std::out_of_range("Error: column must be a number between 1 and 8.");
         }
+        return alphabetical_string[column_number - 1];
     }
 
-    const std::map<char, int> alphabetical_dictionary{ create_alphabetical_dictionary() };
-    const std::map<int, char> numerical_dictionary{ reverse_dictionary(alphabetical_dictionary) };
-
     const bool in_board_range(const int& location);
     int flatten_board_coordinates(const std::pair<char, int>& coordinates);
     std::pair<char, int> to_board_coordinates(const int& location);
@@ -1,13 +1,13 @@
 /*
 This header file defines enumerated classes to be used as attributes of the pieces (colour and symbol) and of the board (occupation).
-There are also two constant maps, one to obtain the opposite piece_colour and another to obtain a string of the colour given a piece_colour object.
+There are also two constexpr functions, one to obtain the opposite piece_colour and another to obtain a string of the colour given a piece_colour object.
+Nothing in this header needs to be initialised when the program starts.
 */
 
 #ifndef ENUM_ATTRIBUTES_H
 #define ENUM_ATTRIBUTES_H
 
-#include <map>
-#include <iostream>
+#include <string_view>
 
 enum class piece_colour : int {
 	white, //0
@@ -29,9 +29,11 @@ enum class board_occupation : int {
 	black_piece, //1
 };
 
-const std::map<piece_colour, piece_colour> opposite_colour{ {piece_colour::white,piece_colour::black},
-															{piece_colour::black, piece_colour::white} };
-const std::map<piece_colour, std::string> colour_string_map{ {piece_colour::white,"white"},
-															 {piece_colour::black,"black"} };
+constexpr piece_colour opposite_colour(const piece_colour& colour) noexcept {
+	return colour == piece_colour::white ? piece_colour::black : piece_colour::white;
+}
+constexpr std::string_view colour_string(const piece_colour& colour) noexcept {
+	return colour == piece_colour::white ? "white" : "black";
+}
 
 #endif
@@ -0,0 +1,27 @@
+/*
+This file contains the declaration of the static evaluation of a position. The score is given in centipawns from the
+point of view of the colour turn, and is made of three terms:
+    -material and piece-square tables: kept up to date incrementally by the position on every move, so it costs nothing here
+    -mobility: number of moves of the knights, bishops, rooks and queens compared to a typical number
+    -king safety: squares next to the king attacked by the other colour, and pawns sheltering the king (middlegame only)
+*/
+
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "position.h"
+#include "enum_attributes.h"
+
+namespace evaluation {
+    int evaluate(const position& game_position);
+
+    //Terms of the evaluation, all from the point of view of the given colour
+    int material_pst(const position& game_position, const piece_colour& colour);
+    int mobility(const position& game_position, const piece_colour& colour);
+    int king_safety(const position& game_position, const piece_colour& colour);
+
+    //Material and piece-square score recomputed by looping over the squares, to check the incremental one of the position
+    material_pst_score material_pst_from_scratch(const position& game_position);
+}
+
+#endif
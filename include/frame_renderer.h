@@ -0,0 +1,61 @@
+/*
+This file contains the declaration of the frame renderer, which draws the board on the console.
+A frame is a list of lines, and each line a list of cells (a piece of text with a colour, starting at a known column of
+the console). The board fills a frame with board::draw and the renderer writes it with a single write to the standard
+output. The first frame clears the screen and is written in full. After that, only the cells that differ from the
+last frame written are sent, each one preceded by an ANSI escape sequence that moves the cursor to it, so that the
+console no longer has to be cleared with system("cls") between turns.
+The cursor positions are counted from the top of the console, so they only land on the board while it has not scrolled.
+The text printed below the frame between two frames (prompts, lists of moves, errors and what the user types) is counted
+with count_printed_text, and the next frame is drawn in full once that text could have scrolled the console, or after
+the console was resized.
+All the memory used (cells and output buffer) is kept from one frame to the next.
+*/
+
+#ifndef FRAME_RENDERER_H
+#define FRAME_RENDERER_H
+
+#include "console_visualisation.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct frame_cell {
+    std::string text;
+    font_colour colour{ font_colour::white };
+    int column{ 1 }; //Console column where the cell starts, counting from 1
+};
+
+class frame_renderer {
+private:
+    std::vector<std::vector<frame_cell>> current_frame;
+    std::vector<std::vector<frame_cell>> previous_frame;
+    std::vector<size_t> current_cells_per_line;
+    std::vector<size_t> previous_cells_per_line;
+    std::string output;
+    bool full_redraw{ true };
+    size_t rows_printed_below{}; //console rows taken by the text printed after the last frame
+    size_t printed_column{}; //column of that text where the next character goes, counting from 0
+    size_t console_rows{}; //size of the console when the last frame was rendered
+    size_t console_columns{};
+public:
+    frame_renderer();
+
+    //Start a new frame with the given number of lines
+    void begin_frame(const size_t& number_of_lines);
+    //Append a cell at the end of a line and return its text (empty) to be filled in place
+    std::string& add_cell(const size_t& line, const int& column, const font_colour& colour = font_colour::white);
+    void add_cell(const size_t& line, const int& column, std::string_view text, const font_colour& colour = font_colour::white);
+
+    //Build the bytes that turn the last frame into the current one. The current frame becomes the last frame
+    const std::string& render();
+    //Render and write the result to the standard output with a single write. The cursor is left below the board
+    void present();
+
+    //Count text written to the console below the frame, including what the user typed and its new line
+    void count_printed_text(std::string_view text) noexcept;
+    //Draw the next frame from scratch, e.g. after output that was not counted may have scrolled the console
+    void invalidate() noexcept { full_redraw = true; }
+};
+
+#endif
@@ -0,0 +1,75 @@
+/*
+This file contains the declaration of the game checkpoint, a file that keeps the last state of a game in progress so
+that it can be resumed after the process dies. The state is a snapshot of fixed layout, in the byte order of the
+machine that wrote it: the pieces on the board, the moves played (which also give the captured pieces) and the
+positions since the last capture or pawn move (for the draws by repetition), together with the colour turn and the
+check status. Restoring a game sets the pieces up directly instead of replaying its moves.
+The file is memory-mapped and holds two snapshots, each one in its own pages. Each save overwrites the older one and
+makes it valid last (with a sequence number and a checksum of the snapshot), so if the process dies while saving, the
+other snapshot is still complete and is the one restored.
+*/
+
+#ifndef GAME_CHECKPOINT_H
+#define GAME_CHECKPOINT_H
+
+#include "game_session.h"
+#include "mapped_file.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+struct game_snapshot {
+    static constexpr std::uint32_t current_format{ 0x43434b31 }; //"CCK1"
+    static constexpr size_t max_recent_positions{ 128 }; //more than the halfmove clock of a game that is not over
+    //Longest game possible: without promotions there are at most 126 captures and pawn moves (30 captures, and 6 moves of
+    //each of the 16 pawns), and at most 99 other moves before each one of them and after the last one
+    static constexpr size_t max_moves{ 12800 };
+
+    std::uint64_t sequence; //0 while it is being written, and higher for newer snapshots
+    std::uint64_t checksum; //of the snapshot from the sequence to the last move stored
+    std::uint32_t format;
+    std::uint32_t number_of_moves;
+    std::uint8_t colour_turn;
+    std::uint8_t check;
+    std::uint8_t last_move_check;
+    std::uint8_t last_move;
+    std::uint8_t state;
+    std::uint8_t unused;
+    std::uint16_t number_of_recent_positions;
+    std::array<std::uint8_t, 64> squares; //piece codes (see position.h), from a1 to h8
+    std::array<std::uint16_t, max_recent_positions> recent_halfmove_clocks; //oldest first, the last one is the current position
+    std::array<std::uint64_t, max_recent_positions> recent_hashes;
+    std::array<session_move, max_moves> moves; //oldest first
+};
+
+static_assert(std::is_trivially_copyable_v<game_snapshot> && std::is_standard_layout_v<game_snapshot>,
+    "A game snapshot must be a plain block of memory to be mapped from the checkpoint file.");
+
+class checkpoint_file {
+private:
+    mapped_file file;
+    std::uint64_t last_sequence{};
+    bool synchronous{ false };
+
+    game_snapshot& get_snapshot(const std::uint64_t& sequence) const noexcept;
+public:
+    //Map the checkpoint file, creating it if it does not exist. With synchronous set, each save waits until the snapshot
+    //is on the disk, so that it also survives a crash of the system. It throws std::runtime_error if the file cannot be
+    //created or mapped, or is not a checkpoint file
+    checkpoint_file(const std::string& path, const bool& synchronous_in = false);
+    checkpoint_file(checkpoint_file&& other) noexcept;
+    checkpoint_file& operator=(checkpoint_file&& other) noexcept;
+    checkpoint_file(const checkpoint_file&) = delete;
+    checkpoint_file& operator=(const checkpoint_file&) = delete;
+
+    //Newest complete snapshot of the file, or nullptr if there is none (e.g. the file was just created)
+    const game_snapshot* get_last_snapshot() const noexcept;
+    //Write the state of the game over the older snapshot
+    void save(const game_session& session);
+
+    static size_t file_size() noexcept;
+};
+
+#endif
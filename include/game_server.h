@@ -0,0 +1,104 @@
+/*
+This file contains the declaration of the game server, which hosts many independent games (game sessions) in one
+process. Clients connect to a Unix domain socket and send one command per line; an epoll loop on a single thread reads
+the commands of every connection, and the work on the games (move generation, applying moves) runs on a thread pool.
+The commands of one game run one at a time and in order; different games run in parallel. Games are not owned by the
+connection that created them, so they survive reconnections and can be played from two connections.
+
+Protocol (squares such as e2, every answer is one line starting with "ok" or "error"):
+    new                         -> ok <game>
+    select <game> <square>      -> ok <game> <squares the piece can move to>
+    moves <game>                -> ok <game> <moves such as e2e4>
+    move <game> <from> <to>     -> ok <game> <state>[ check]      (state as in game_session::state_string)
+    takeback <game> [<plies>]   -> ok <game> <ply> <state>[ check] (one ply if not given)
+    goto <game> <ply>           -> ok <game> <ply> <state>[ check] (0 for the start, up to the last move taken back)
+    fen <game>                  -> ok <game> <FEN of the position>
+    close <game>                -> ok <game>
+    stats                       -> ok sessions=<n> connections=<n> moves=<n> move_latency_us_p50=<t> ... rss_kib=<n>
+The latencies are measured from reading a move command to queueing its answer, over the last moves served.
+Given a checkpoint directory, each game is saved to its own checkpoint file there (<game>.checkpoint, see
+game_checkpoint.h) when it is created and after each move, takeback or goto, and resume_games() restores the games
+saved by an earlier server, with the same numbers, so that restarting the server does not lose them. Closing a game
+removes its file.
+Only Linux is supported.
+*/
+
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+#include "game_session.h"
+#include "tablebase.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class thread_pool;
+
+class game_server {
+private:
+    struct connection;
+    struct session_slot;
+    struct request;
+    //Answer of a command run on the thread pool, handed back to the epoll loop
+    struct completion {
+        std::uint32_t session_id{};
+        std::uint64_t connection_id{};
+        std::string answer;
+        bool is_move{ false };
+        std::chrono::steady_clock::time_point received;
+    };
+
+    thread_pool& pool;
+    tablebase endgame_tablebase; //3-piece tables, generated when the server starts
+    std::string socket_path;
+    std::string checkpoint_directory; //empty if the games are not saved
+    int listen_fd{ -1 };
+    int epoll_fd{ -1 };
+    int wake_fd{ -1 }; //eventfd written by the workers and by stop()
+    std::atomic<bool> stopping{ false };
+
+    std::unordered_map<std::uint64_t, std::unique_ptr<connection>> connections;
+    std::unordered_map<std::uint32_t, std::unique_ptr<session_slot>> sessions;
+    std::uint64_t next_connection_id{ 2 }; //0 and 1 are the listening socket and the eventfd in the epoll data
+    std::uint32_t next_session_id{ 1 };
+    size_t commands_in_flight{};
+
+    std::mutex completions_mutex;
+    std::vector<completion> completions;
+
+    std::vector<float> move_latencies_us; //ring of the last moves served
+    size_t moves_served{};
+
+    std::string checkpoint_path(const std::uint32_t& session_id) const;
+    void accept_connections();
+    void read_connection(connection& client);
+    void write_connection(connection& client);
+    void close_connection(const std::uint64_t& connection_id);
+    void handle_line(connection& client, const std::string& line);
+    void send_answer(const std::uint64_t& connection_id, const std::string& answer);
+    //Start the next queued command of a game if none is running
+    void run_next_command(const std::uint32_t& session_id);
+    void handle_completions();
+    std::string stats_answer();
+public:
+    //Listen on socket_path (an existing socket file there is replaced). It throws std::runtime_error if it cannot
+    game_server(const std::string& socket_path, thread_pool& pool, const std::string& checkpoint_directory_in = "");
+    ~game_server();
+    game_server(const game_server&) = delete;
+    game_server& operator=(const game_server&) = delete;
+
+    //Restore the games of the checkpoint directory, before run(). Returns the number of games restored; the files that
+    //are not valid checkpoints are skipped
+    size_t resume_games();
+    //Serve clients until stop() is called. The commands already running are finished before it returns
+    void run();
+    //Thread safe, e.g. from a signal handler thread or from a test driving the server
+    void stop() noexcept;
+};
+
+#endif
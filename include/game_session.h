@@ -0,0 +1,132 @@
+/*
+This file contains the declaration of the game session class. A session is one game: the board and the state the game
+loop keeps between turns (the colour turn, the check status and the last move), together with the rules that end the
+game. Moves are applied with the same sequence of board calls as the original game loop, so both the console game and
+the game server play through it.
+The session can go back to any ply (move of one team) of the game and forward again to the moves taken back, until
+another move is played. Each move keeps a small record of the session after it (an undo stack), so that taking it back
+or playing it again generates no moves, and the pieces are kept every snapshot_interval plies, so that any ply is
+reached from the nearest snapshot with fewer than snapshot_interval moves, however long the game.
+*/
+
+#ifndef GAME_SESSION_H
+#define GAME_SESSION_H
+
+#include "board.h"
+#include "enum_attributes.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class tablebase;
+struct game_snapshot;
+
+enum class game_state {
+    playing,
+    checkmate, //the colour turn is checkmated
+    stalemate,
+    fifty_move_draw,
+    threefold_repetition,
+    tablebase_draw,
+    king_captured,
+};
+
+//A move played in a session: the locations (from 1 to 64) it was played from and to, and the codes (see position.h) of
+//the piece that moved and of the piece it captured (0 if none)
+struct session_move {
+    std::uint8_t from{};
+    std::uint8_t to{};
+    std::uint8_t moved_piece{};
+    std::uint8_t captured_piece{};
+};
+
+//Allowed moves of the colour turn, with the moves of each piece next to each other as in
+//board::get_all_pieces_allowed_moves, so that the moves of a selected piece are a range of them
+struct turn_moves {
+    std::vector<board_move> all_allowed_moves;
+    std::array<std::uint8_t, 65> piece_moves_begin{}; //indexed by location, from 1 to 64
+    std::array<std::uint8_t, 65> piece_moves_end{};
+
+    std::vector<int> get_piece_allowed_moves(const int& location) const;
+};
+
+class game_session {
+public:
+    static constexpr size_t snapshot_interval{ 16 };
+private:
+    //The session after a ply: the flags of the game loop, the pieces captured so far and the last position of the history
+    struct ply_record {
+        std::uint64_t hash{};
+        std::uint16_t halfmove_clock{};
+        std::uint8_t number_of_captures{};
+        std::uint8_t last_move{};
+        bool check{};
+        bool last_move_check{};
+        game_state state{};
+    };
+
+    std::unique_ptr<board> gameboard;
+    piece_colour colour_turn{ piece_colour::white };
+    bool check{ false };
+    bool last_move_check{ false };
+    int last_move{};
+    game_state state{ game_state::playing };
+    std::vector<session_move> moves; //the moves played and, after them, the moves taken back
+    size_t current_ply{}; //number of moves played
+    //One record per ply from the start (ply 0) to the last move, and the pieces every snapshot_interval plies. A restored
+    //game has none of them until it is navigated, when it is played again from the start once to record them
+    std::vector<ply_record> plies;
+    std::vector<std::array<std::uint8_t, 64>> snapshots;
+
+    void update_state();
+    void play_on_board(const session_move& move);
+    void record_ply(const bool& captured);
+    void restore_ply();
+    void prepare_navigation();
+    void take_back_last_move();
+    void play_next_move();
+public:
+    game_session();
+    //Restore a saved game (see game_checkpoint.h). It throws std::invalid_argument if the snapshot is not valid
+    explicit game_session(const game_snapshot& snapshot);
+    ~game_session();
+    game_session(game_session&&) noexcept;
+    game_session& operator=(game_session&&) noexcept;
+
+    const board& get_board() const noexcept { return *gameboard; }
+    const piece_colour& get_colour_turn() const noexcept { return colour_turn; }
+    bool in_check() const noexcept { return check; }
+    game_state get_state() const noexcept { return state; }
+    bool is_game_over() const noexcept { return state != game_state::playing; }
+    size_t get_ply() const noexcept { return current_ply; }
+    //All the moves of the game, including the ones taken back after the current ply
+    const std::vector<session_move>& get_moves() const noexcept { return moves; }
+
+    //Allowed moves of all the pieces of the colour turn, and of the piece at a location (from 1 to 64) of the colour turn.
+    //The second one throws std::invalid_argument if there is no such piece
+    std::vector<board_move> get_all_allowed_moves() const;
+    std::vector<int> get_piece_allowed_moves(const int& location) const;
+    //Both at once, one piece at a time. It stops and returns false as soon as cancelled is set, e.g. from another thread
+    bool compute_turn_moves(turn_moves& moves, const std::atomic<bool>& cancelled) const;
+
+    //Move the piece of the colour turn at from to the location to (both from 1 to 64) and pass the turn. It throws
+    //std::invalid_argument if the game is over or the move is not allowed, leaving the session unchanged. The move is
+    //looked up in allowed_moves if they are given (they must be the moves of this turn), instead of generating them.
+    //Playing a move after taking moves back forgets the moves taken back
+    void make_move(const int& from, const int& to, const turn_moves* allowed_moves = nullptr);
+    //Take back the last moves, or go to a ply from 0 (the starting position) to the number of moves of the game,
+    //including the ones taken back. They throw std::out_of_range if there is no such ply
+    void take_back(const size_t& number_of_plies = 1);
+    void go_to_ply(const size_t& ply);
+    //End the game in a draw if the tablebase has the material and shows that neither team can win
+    void check_tablebase(const tablebase& endgame_tablebase);
+
+    //Write the state of the game up to the current ply to a snapshot, all but its sequence and checksum
+    void save(game_snapshot& snapshot) const;
+
+    static const char* state_string(const game_state& state) noexcept;
+};
+
+#endif
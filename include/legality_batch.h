@@ -0,0 +1,53 @@
+/*
+This file contains the declaration of the batched legality queries. Each query is a position and a candidate move, and
+the answer is one bit telling whether the move is legal in that position.
+The queries are answered on position objects, so no board (and none of its 32 heap-allocated pieces) is built for them.
+The scratch memory used to answer the queries is kept by the legality_batch object and reused from one call to the next.
+If a thread pool is given, the queries are split into chunks of whole 64-bit words of the result, so that threads never
+write to the same word.
+*/
+
+#ifndef LEGALITY_BATCH_H
+#define LEGALITY_BATCH_H
+
+#include "position.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <vector>
+
+struct legality_query {
+    position query_position;
+    chess_move candidate_move;
+};
+
+class result_bitset {
+private:
+    std::vector<std::uint64_t> words;
+    size_t number_of_bits{};
+public:
+    result_bitset(const size_t& number_of_bits_in = 0);
+    size_t size() const noexcept { return number_of_bits; }
+    bool test(const size_t& index) const noexcept { return (words[index / 64] >> (index % 64)) & 1; }
+    void set(const size_t& index) noexcept { words[index / 64] |= std::uint64_t{ 1 } << (index % 64); }
+    size_t count() const noexcept; //number of bits set
+    const std::vector<std::uint64_t>& get_words() const noexcept { return words; }
+};
+
+//Scratch memory reused by all the queries answered on the same slice of the work
+struct legality_scratch {
+    move_list piece_moves;
+};
+
+//Answer a single query. Moves from an empty square or from a piece that is not of the colour turn are not legal
+bool is_legal_move(const position& query_position, const chess_move& candidate_move, legality_scratch& scratch);
+
+class legality_batch {
+private:
+    thread_pool* pool{ nullptr };
+    std::vector<legality_scratch> scratch_arena; //One entry per slice of the thread pool
+public:
+    legality_batch(thread_pool* pool_in = nullptr);
+    result_bitset evaluate(const std::vector<legality_query>& queries);
+};
+
+#endif
\ No newline at end of file
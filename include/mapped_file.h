@@ -0,0 +1,51 @@
+/*
+This file contains the declaration of the mapped file, a file mapped into memory and shared with the other processes
+that map it, used by the opening book (read-only) and by the game checkpoint (read-write). The file is closed as soon
+as it is mapped, as the mapping keeps it open, and unmapped when the mapped file is destroyed.
+*/
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+class mapped_file {
+public:
+    enum class access {
+        read_only, //the file must exist. Lookups are expected at random, so the system does not read ahead
+        read_write, //the file is created if it does not exist
+    };
+    enum class status {
+        mapped,
+        not_opened,
+        not_mapped, //opened but too short, of another size or the mapping failed
+    };
+private:
+    void* mapping{ nullptr };
+    size_t mapping_size{};
+#ifdef _WIN32
+    void* mapping_handle{ nullptr };
+#endif
+    status file_status{ status::not_opened };
+
+    void close() noexcept;
+public:
+    mapped_file() = default; //nothing mapped
+    //Map the whole file, or with a size, a file of exactly that size (an empty file opened read-write is extended to it
+    //first). It does not throw: get_status() tells whether the file was mapped
+    mapped_file(const std::string& path, const access& file_access, const size_t& size = 0) noexcept;
+    ~mapped_file();
+    mapped_file(mapped_file&& other) noexcept;
+    mapped_file& operator=(mapped_file&& other) noexcept;
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    status get_status() const noexcept { return file_status; }
+    void* data() const noexcept { return mapping; }
+    size_t size() const noexcept { return mapping_size; }
+    //Wait until the pages written so far are on the disk
+    void flush() const noexcept;
+};
+
+#endif
@@ -0,0 +1,70 @@
+/*
+This file contains the declaration of the mate solver, which proves (or refutes) that the side to move can force
+checkmate within a number of moves, for composing and checking puzzles. It uses proof-number search: the tree of the
+solution is grown one node at a time, always expanding the node that would go furthest to prove or disprove the mate
+(the most-proving node). Each node keeps two numbers:
+    -proof number: the fewest nodes still to be proven to prove the mate from it
+    -disproof number: the fewest nodes still to be disproven to show there is no mate from it
+The attacker needs one of its moves to mate (the smallest proof number of its children) and the defender needs one of
+its moves to escape (the smallest disproof number of its children). The attacker only plays moves that give check, so
+the defender always answers with one of its evasions and the tree stays narrow. New nodes start from the number of
+moves of the side to move (the more evasions, the harder to prove; the more checks, the harder to disprove).
+The moves come from the position (position.h), which follows the rules of the board. The nodes live in a table of a
+fixed size, allocated once from the memory budget; if the table fills up before the mate is proven or disproven, the
+search stops and says so. There are no transpositions: a position reached by two lines is two nodes.
+*/
+
+#ifndef MATE_SOLVER_H
+#define MATE_SOLVER_H
+
+#include "position.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct mate_solver_settings {
+    int max_moves{ 7 }; //moves of the attacker, the last one giving mate
+    size_t memory_budget{ size_t{ 256 } << 20 }; //bytes of the node table
+};
+
+enum class mate_status {
+    proven, //the side to move mates in at most max_moves moves
+    disproven, //it cannot force mate with checks within max_moves moves
+    out_of_memory, //the node table filled up first
+};
+
+struct mate_result {
+    mate_status status{ mate_status::disproven };
+    //If proven: the moves of both sides from the position to the mate, with the defender holding out the longest
+    //and the attacker mating the soonest within the proof
+    std::vector<chess_move> solution;
+    std::uint64_t nodes{}; //nodes created, each one with the moves of its side generated
+    double seconds{};
+};
+
+class mate_solver {
+private:
+    struct node {
+        std::uint32_t proof{};
+        std::uint32_t disproof{};
+        std::uint32_t parent{};
+        std::uint32_t first_child{};
+        std::uint16_t number_of_children{};
+        chess_move move; //move that led to the node
+        bool expanded{ false };
+    };
+
+    mate_solver_settings settings;
+    std::vector<node> nodes; //the root first, and the children of each node next to each other
+
+    bool expand(const std::uint32_t& node_index, const int& ply, position& node_position);
+    void update_numbers(const std::uint32_t& node_index, const bool& attacker);
+    //Plies from a proven node to the mate along the solution
+    int mate_distance(const std::uint32_t& node_index, const bool& attacker) const;
+public:
+    explicit mate_solver(const mate_solver_settings& settings_in = {});
+
+    mate_result solve(const position& root);
+};
+
+#endif
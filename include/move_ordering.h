@@ -0,0 +1,29 @@
+/*
+This file contains the declaration of the move ordering, which decides in which order a search tries the moves of a
+position (the sooner a good move is tried, the more of the others alpha-beta can skip):
+    -captures that win or keep material, first those with the best static exchange evaluation (position::see) and,
+     among those that exchange the same material, the most valuable victim taken by the least valuable attacker
+    -quiet moves, in the order they were generated
+    -captures that lose material, the least losing first
+*/
+
+#ifndef MOVE_ORDERING_H
+#define MOVE_ORDERING_H
+
+#include "position.h"
+#include <array>
+
+namespace move_ordering {
+    //Score of a capture: its static exchange evaluation, with MVV/LVA breaking ties. Negative if it loses material
+    int capture_score(const position& game_position, const chess_move& capture) noexcept;
+    //MVV/LVA alone, cheaper than capture_score, for captures already known to win or keep material
+    int mvv_lva(const position& game_position, const chess_move& capture) noexcept;
+    bool is_capture(const position& game_position, const chess_move& candidate_move) noexcept;
+
+    //Put the moves of the position in the order above
+    void order_moves(const position& game_position, move_list& moves);
+    //Sort moves by decreasing score (scores[i] is the score of moves[i]), keeping the order of equal scores
+    void sort_by_score(move_list& moves, std::array<int, 256>& scores) noexcept;
+}
+
+#endif
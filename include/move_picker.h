@@ -0,0 +1,72 @@
+/*
+This file contains the declaration of the move picker, which hands the moves of a position to a search one at a time,
+in stages, generating each group of moves only once the moves before it are used up:
+    1. the hash move (the best move stored for the position by an earlier search), if it can be played here
+    2. the captures, generated together: those that win or keep material (position::see at least 0) are handed out by
+       MVV/LVA, and those that lose material are put aside for the last stage
+    3. the killer moves of the ply (quiet moves that refuted other moves at the same depth), if they can be played here
+    4. the countermove (the quiet move that last refuted the move just played by the other side), if it can be played
+    5. the quiet moves, generated together and handed out by their history score
+    6. the captures that lose material
+The killers, the countermove and the history scores come from the tables of the search (ordering_tables.h).
+Each move is checked for legality only when it is handed out, and no move is handed out twice. A search usually stops
+at one of the first moves of a node (a cutoff), so most nodes never generate their quiet moves.
+*/
+
+#ifndef MOVE_PICKER_H
+#define MOVE_PICKER_H
+
+#include "position.h"
+#include <array>
+#include <cstdint>
+
+//What the search knows about the moves of a node besides its position
+struct move_picker_hints {
+    chess_move hash_move{ no_move };
+    std::array<chess_move, 2> killers{ no_move, no_move };
+    chess_move countermove{ no_move };
+    //History scores of the quiet moves of the colour turn, indexed by from * 64 + to. Without them, the quiet moves are
+    //handed out in the order they are generated
+    const std::array<int, 64 * 64>* history{ nullptr };
+};
+
+class move_picker {
+public:
+    enum class stage {
+        hash_move,
+        generate_captures,
+        good_captures,
+        killers,
+        countermove,
+        generate_quiet_moves,
+        quiet_moves,
+        bad_captures,
+        done,
+    };
+private:
+    const position& picked_position;
+    move_picker_hints hints;
+    stage current_stage{ stage::hash_move };
+    stage picked_stage{ stage::hash_move }; //stage of the last move handed out
+    move_list captures;
+    move_list quiet_moves;
+    std::array<int, 256> scores;
+    size_t next_move{}; //index in the list of the current stage
+    size_t bad_captures_end{}; //the bad captures are moved to the start of the captures, which were already handed out
+    size_t next_killer{};
+
+    bool is_hint(const chess_move& candidate_move) const noexcept;
+    bool is_playable(const chess_move& candidate_move) const;
+public:
+    //The position must outlive the picker and not change while it is used
+    move_picker(const position& picked_position_in, const move_picker_hints& hints_in = {});
+    move_picker(const move_picker&) = delete;
+    move_picker& operator=(const move_picker&) = delete;
+
+    //Next legal move of the position, or false once they have all been handed out
+    bool next(chess_move& picked_move);
+    //Stage the last move came from, e.g. for a search that reduces the quiet moves but not the captures or killers
+    stage get_stage() const noexcept { return picked_stage; }
+};
+
+#endif
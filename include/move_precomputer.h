@@ -0,0 +1,49 @@
+/*
+This file contains the declaration of the move precomputer. While the player thinks about the next move, it computes
+the allowed moves of the colour turn on a background thread, so that asking for all the moves or selecting a piece is
+answered from the ready result. Starting it again for the next turn, or cancelling it, stops the computation in progress
+after the piece it is working on.
+Once the moves are ready, it can also generate the endgame tables of the materials that the captures of the colour turn
+lead to, so that a table is ready as soon as the game reaches its material. The tables are not cancelled, as one of
+them may be needed right after the move: starting or cancelling the precomputer waits for them (the tables of 3 pieces
+take well under a second).
+*/
+
+#ifndef MOVE_PRECOMPUTER_H
+#define MOVE_PRECOMPUTER_H
+
+#include "game_session.h"
+#include "tablebase.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <future>
+
+class move_precomputer {
+private:
+    thread_pool worker{ 1 };
+    std::future<bool> pending; //false if the computation was cancelled
+    std::future<void> pending_tables;
+    std::atomic<bool> cancelled{ false };
+    turn_moves moves; //only written by the worker while pending is valid
+    bool ready{ false };
+public:
+    move_precomputer() = default;
+    ~move_precomputer();
+    move_precomputer(const move_precomputer&) = delete;
+    move_precomputer& operator=(const move_precomputer&) = delete;
+
+    //Start computing the moves of the colour turn of the session, cancelling the previous computation. The session must
+    //not change (e.g. by a move) until cancel() is called or the precomputer is started again or destroyed
+    void start(const game_session& session);
+    //The same, and then generate on tablebase_pool the tables of 3 pieces that the captures of the colour turn lead to,
+    //unless they were generated before. The tablebase must not be used either until cancel() is called or the
+    //precomputer is started again or destroyed
+    void start(const game_session& session, tablebase& endgame_tablebase, thread_pool& tablebase_pool);
+    void cancel() noexcept;
+    //Moves of the last session started, waiting for them if they are not ready yet. It throws std::logic_error if the
+    //precomputer was not started or was cancelled before they were ready. The moves it returns stay valid until the
+    //next start()
+    const turn_moves& get();
+};
+
+#endif
@@ -0,0 +1,53 @@
+/*
+This file contains the declaration of the packed occupancy kernels. They turn the board matrix (64 enums of 4 bytes) or
+the squares of a position (64 bytes) into one 64-bit mask per colour, where bit i stands for square i (board location
+i + 1), and work on those masks in bulk:
+    -occupancy masks per colour, from a board matrix or from the squares of a position
+    -popcounts of many masks at once, used to count the mobility of a batch of positions
+    -equality of positions, one against one or one against a batch
+Each kernel has an AVX2, an SSE2 and a scalar version. The fastest one supported by the processor is chosen at runtime
+the first time a kernel is called; set_simd_level() forces a lower level (e.g. to compare them in the benchmarks).
+*/
+
+#ifndef OCCUPANCY_H
+#define OCCUPANCY_H
+
+#include "enum_attributes.h"
+#include "position.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+struct occupancy_masks {
+    std::uint64_t white{};
+    std::uint64_t black{};
+};
+
+namespace occupancy {
+    enum class simd_level {
+        scalar,
+        sse2,
+        avx2,
+    };
+
+    simd_level get_supported_simd_level() noexcept;
+    simd_level get_simd_level() noexcept;
+    void set_simd_level(const simd_level& level) noexcept; //Levels above the supported one are lowered to it
+    const char* simd_level_name(const simd_level& level) noexcept;
+
+    occupancy_masks from_board_matrix(const std::array<board_occupation, 64>& board_matrix) noexcept;
+    occupancy_masks from_squares(const std::array<std::uint8_t, 64>& squares) noexcept;
+
+    //counts[i] = number of bits set in masks[i]
+    void popcount_batch(const std::uint64_t* masks, const size_t& number_of_masks, std::uint8_t* counts) noexcept;
+
+    //Same pieces on the same squares and same colour turn
+    bool positions_equal(const position& lhs, const position& rhs) noexcept;
+    size_t count_equal_positions(const position& needle, const std::vector<position>& batch) noexcept;
+
+    //Squares the pieces of the colour turn (except the pawns) can move to, whether or not the moves leave the king in
+    //check, for each position of the batch
+    void batch_mobility(const std::vector<position>& positions, std::vector<int>& mobility);
+}
+
+#endif
\ No newline at end of file
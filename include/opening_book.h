@@ -0,0 +1,88 @@
+/*
+This file contains the declaration of the opening book, a binary file of moves indexed by the hash of the position they
+are played from (see zobrist.h), that gives the first moves of a game without searching.
+The book is not Polyglot-compatible: the hashes are the ones of this engine (Polyglot keys also hash castling and en
+passant rights, which do not exist under these rules), but the layout is similar. The file is a 16-byte header
+followed by entries of 16 bytes sorted by hash, all in the byte order of the machine that wrote it:
+    header: magic "CCBOOK" 0 1 (8 bytes), number of entries (uint64)
+    entry:  hash (uint64), from square (uint8), to square (uint8), weight (uint16), 4 bytes unused
+The file is memory-mapped read-only and shared, so that the processes that open the same book on a host share a single
+copy in the page cache, and nothing is read until a lookup touches it. Lookups use interpolation search, since the
+hashes are spread uniformly, and fall back to binary search on the few entries left.
+*/
+
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include "mapped_file.h"
+#include "position.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct book_entry {
+    std::uint64_t hash{};
+    std::uint8_t from{};
+    std::uint8_t to{};
+    std::uint16_t weight{}; //relative frequency of the move among those of the position
+    std::uint32_t unused{};
+};
+
+static_assert(sizeof(book_entry) == 16, "Book entries must be 16 bytes to match the file format.");
+
+class opening_book {
+private:
+    mapped_file file;
+    const book_entry* entries{ nullptr };
+    size_t number_of_entries{};
+
+    void close() noexcept;
+    const book_entry* lower_bound(const std::uint64_t& hash) const noexcept;
+public:
+    opening_book() = default; //empty book
+    //Map the book file. It throws std::runtime_error if the file cannot be opened or is not a valid book
+    opening_book(const std::string& path);
+    ~opening_book();
+    opening_book(opening_book&& other) noexcept;
+    opening_book& operator=(opening_book&& other) noexcept;
+    opening_book(const opening_book&) = delete;
+    opening_book& operator=(const opening_book&) = delete;
+
+    size_t size() const noexcept { return number_of_entries; }
+    bool empty() const noexcept { return number_of_entries == 0; }
+
+    //Entries of the position with the given hash, as a range of the mapped file (empty if the position is not in the book)
+    const book_entry* find(const std::uint64_t& hash, size_t& number_of_moves) const noexcept;
+
+    //Choose one of the book moves of the position, each with a probability proportional to its weight. random_value is
+    //any uniformly distributed number. Moves that are not legal in the position (e.g. after a hash collision) are
+    //skipped. Returns false if there is no book move
+    bool pick_move(const position& book_position, const std::uint64_t& random_value, chess_move& chosen_move) const;
+
+    //Write a book file with the given entries, in any order. Entries of the same move of the same position are merged by
+    //adding their weights. It throws std::runtime_error if the file cannot be written
+    static void write(const std::string& path, std::vector<book_entry> book_entries);
+};
+
+//Writes a book file one entry at a time, for books too big to be held in memory (see tools/book_builder.cpp). The
+//entries must be added sorted by hash, then by from and to square, with no move repeated. The file is only a valid book
+//once finish() has written the number of entries in the header. The functions throw std::runtime_error on failure
+class opening_book_writer {
+private:
+    std::FILE* file{ nullptr };
+    std::string path;
+    std::uint64_t number_of_entries{};
+public:
+    opening_book_writer(const std::string& path_in);
+    ~opening_book_writer();
+    opening_book_writer(const opening_book_writer&) = delete;
+    opening_book_writer& operator=(const opening_book_writer&) = delete;
+
+    void add(const book_entry& entry);
+    void finish();
+    std::uint64_t size() const noexcept { return number_of_entries; }
+};
+
+#endif
@@ -0,0 +1,74 @@
+/*
+This file contains the declaration of the tables the search learns its move ordering from, as it finds which quiet
+moves cut off the nodes (refute the move before them):
+    -killer moves: the last two quiet moves that cut off a node at each ply, likely to refute the other moves tried at
+     the same ply, as they are often threats that the moves of the other side did not address
+    -history: a score for each colour, origin and destination square (a butterfly table), raised for the quiet moves
+     that cut off a node and lowered for the quiet moves tried before them, by more the deeper the node. The updates
+     pull the score towards the bonus in proportion to how far it is from it (gravity), so that the scores stay within
+     max_history_score without rescaling, and recent results weigh more than old ones
+    -countermoves: the quiet move that last cut off a node reached by each move of the other side, indexed by the piece
+     that moved and its destination square
+Each search thread keeps its own tables, so they need no locking. They are aligned to cache lines, and a new search
+only clears the killers (512 bytes) and halves the history scores, which keeps what the last search learnt.
+*/
+
+#ifndef ORDERING_TABLES_H
+#define ORDERING_TABLES_H
+
+#include "position.h"
+#include "enum_attributes.h"
+#include <array>
+#include <cstdint>
+
+class killer_table {
+public:
+    static constexpr int max_ply{ 128 };
+private:
+    alignas(64) std::array<std::array<chess_move, 2>, max_ply> killers{};
+public:
+    const std::array<chess_move, 2>& get(const int& ply) const noexcept { return killers[ply]; }
+    //The new killer takes the first slot and the first one moves to the second, unless it is already the first
+    void add(const int& ply, const chess_move& cutoff_move) noexcept;
+    void clear() noexcept;
+};
+
+class history_table {
+public:
+    static constexpr int max_history_score{ 16384 };
+private:
+    alignas(64) std::array<std::array<int, 64 * 64>, 2> scores{}; //indexed by piece_colour, then from * 64 + to
+public:
+    //Scores of the moves of a colour, indexed by from * 64 + to, as the move picker takes them
+    const std::array<int, 64 * 64>& get(const piece_colour& colour) const noexcept { return scores[static_cast<int>(colour)]; }
+    //Raise (bonus above 0) or lower the score of a move. The bonus must be within max_history_score
+    void update(const piece_colour& colour, const chess_move& quiet_move, const int& bonus) noexcept;
+    void age() noexcept;
+    void clear() noexcept;
+
+    //Bonus of a cutoff at a depth: deeper cutoffs are rarer and say more about the move
+    static int depth_bonus(const int& depth) noexcept;
+};
+
+class countermove_table {
+private:
+    alignas(64) std::array<std::array<chess_move, 64>, 16> countermoves{}; //indexed by piece code, then square
+public:
+    //Countermove of the move that brought the piece with the given code to a square
+    const chess_move& get(const std::uint8_t& moved_piece, const int& to) const noexcept { return countermoves[moved_piece][to]; }
+    void set(const std::uint8_t& moved_piece, const int& to, const chess_move& cutoff_move) noexcept { countermoves[moved_piece][to] = cutoff_move; }
+    void clear() noexcept;
+};
+
+struct ordering_tables {
+    killer_table killers;
+    history_table history;
+    countermove_table countermoves;
+
+    //Before each search: the killers belong to the plies of the last search, the history is only aged
+    void new_search() noexcept;
+    //Before a new game, or to search a position as if it were the first one
+    void clear() noexcept;
+};
+
+#endif
@@ -1,12 +1,15 @@
 //Luis Fernandez - 30 March 2020
 //This code contains the declaration of the abstract base class piece, interface for all pieces.
-//The virtual member functions are those to return the allowed moves and the piece symbol as a string
+//The virtual member function is the one to return the allowed moves. The piece symbol as a string is the same for all pieces
 
 #ifndef PIECE_H
 #define PIECE_H
 
 #include "enum_attributes.h"
 #include <utility>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <list>
 #include <array>
 
@@ -18,6 +21,10 @@ protected:
     std::pair<char, int> location{};
     piece_colour colour{};
     piece_symbol symbol{};
+
+    //Piece at any location, for create_piece. It throws std::out_of_range if the location is off the board and
+    //std::invalid_argument if the colour is not valid
+    piece(const std::pair<char, int>& location_in, const piece_colour& colour_in, const piece_symbol& symbol_in);
 public:
     piece();
     virtual ~piece();
@@ -26,7 +33,11 @@ public:
     piece_colour get_colour() const noexcept;
     piece_symbol get_symbol() const noexcept;
     virtual std::list<int> get_allowed_moves(const std::array<board_occupation, 64>& board_matrix) const = 0;
-    virtual std::string get_symbol_string(const bool& on_white_tile) const noexcept = 0;
+    std::string_view get_symbol_string(const bool& on_white_tile) const noexcept; //from the shared table of piece symbols
 };
 
+//Factory to create a piece of any type at arbitrary board coordinates, to set up positions (e.g. from FEN or to take
+//back a capture). Unlike the constructors that take a column, the location is not restricted to the starting one
+std::unique_ptr<piece> create_piece(const piece_symbol& symbol, const std::pair<char, int>& location, const piece_colour& colour);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,119 @@
+/*
+This file contains the material values and piece-square tables of the evaluation, computed at compile time.
+The tables are written as seen from the white side of the board (row 8 at the top) and mirrored for the black pieces.
+There are two values per square, one for the middlegame and one for the endgame, which the evaluation blends according
+to the phase of the game (the non-pawn material left on the board).
+As there is no promotion, a pawn on the last rows is worth little more than one in the middle of the board.
+*/
+
+#ifndef PIECE_SQUARE_TABLES_H
+#define PIECE_SQUARE_TABLES_H
+
+#include "enum_attributes.h"
+#include <array>
+#include <cstdint>
+
+namespace evaluation_tables {
+    //Indexed by piece_symbol: pawn, rook, knight, bishop, king, queen
+    constexpr std::array<int, 6> material_value{ 100, 500, 320, 330, 0, 900 };
+    constexpr std::array<int, 6> phase_weight{ 0, 2, 1, 1, 0, 4 };
+    constexpr int max_phase{ 24 };
+
+    using square_table = std::array<int, 64>;
+
+    constexpr square_table pawn_table{
+         0,  0,  0,  0,  0,  0,  0,  0,
+        20, 20, 20, 20, 20, 20, 20, 20,
+        10, 10, 20, 30, 30, 20, 10, 10,
+         5,  5, 10, 25, 25, 10,  5,  5,
+         0,  0,  0, 20, 20,  0,  0,  0,
+         5, -5,-10,  0,  0,-10, -5,  5,
+         5, 10, 10,-20,-20, 10, 10,  5,
+         0,  0,  0,  0,  0,  0,  0,  0 };
+    constexpr square_table rook_table{
+         0,  0,  0,  0,  0,  0,  0,  0,
+         5, 10, 10, 10, 10, 10, 10,  5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+         0,  0,  0,  5,  5,  0,  0,  0 };
+    constexpr square_table knight_table{
+        -50,-40,-30,-30,-30,-30,-40,-50,
+        -40,-20,  0,  0,  0,  0,-20,-40,
+        -30,  0, 10, 15, 15, 10,  0,-30,
+        -30,  5, 15, 20, 20, 15,  5,-30,
+        -30,  0, 15, 20, 20, 15,  0,-30,
+        -30,  5, 10, 15, 15, 10,  5,-30,
+        -40,-20,  0,  5,  5,  0,-20,-40,
+        -50,-40,-30,-30,-30,-30,-40,-50 };
+    constexpr square_table bishop_table{
+        -20,-10,-10,-10,-10,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5, 10, 10,  5,  0,-10,
+        -10,  5,  5, 10, 10,  5,  5,-10,
+        -10,  0, 10, 10, 10, 10,  0,-10,
+        -10, 10, 10, 10, 10, 10, 10,-10,
+        -10,  5,  0,  0,  0,  0,  5,-10,
+        -20,-10,-10,-10,-10,-10,-10,-20 };
+    constexpr square_table queen_table{
+        -20,-10,-10, -5, -5,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5,  5,  5,  5,  0,-10,
+         -5,  0,  5,  5,  5,  5,  0, -5,
+          0,  0,  5,  5,  5,  5,  0, -5,
+        -10,  5,  5,  5,  5,  5,  0,-10,
+        -10,  0,  5,  0,  0,  0,  0,-10,
+        -20,-10,-10, -5, -5,-10,-10,-20 };
+    constexpr square_table king_middlegame_table{
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -20,-30,-30,-40,-40,-30,-30,-20,
+        -10,-20,-20,-20,-20,-20,-20,-10,
+         20, 20,  0,  0,  0,  0, 20, 20,
+         20, 30, 10,  0,  0, 10, 30, 20 };
+    constexpr square_table king_endgame_table{
+        -50,-40,-30,-20,-20,-30,-40,-50,
+        -30,-20,-10,  0,  0,-10,-20,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-30,  0,  0,  0,  0,-30,-30,
+        -50,-30,-30,-30,-30,-30,-30,-50 };
+
+    //Material plus piece-square value of a piece on a square, positive for white pieces and negative for black ones
+    struct square_value {
+        int middlegame{};
+        int endgame{};
+        int phase{};
+    };
+
+    constexpr std::array<std::array<square_value, 64>, 16> create_square_values() {
+        std::array<const square_table*, 6> middlegame_tables{ &pawn_table, &rook_table, &knight_table, &bishop_table, &king_middlegame_table, &queen_table };
+        std::array<const square_table*, 6> endgame_tables{ &pawn_table, &rook_table, &knight_table, &bishop_table, &king_endgame_table, &queen_table };
+        std::array<std::array<square_value, 64>, 16> values{};
+        for (int colour{}; colour < 2; colour++) {
+            for (int symbol{}; symbol < 6; symbol++) {
+                int code{ 1 + symbol + 8 * colour }; //same encoding as piece_code::make
+                int sign{ colour == 0 ? 1 : -1 };
+                for (int square{}; square < 64; square++) {
+                    //The tables start at a8, so white squares are flipped vertically and black ones are read as they are
+                    int table_index{ colour == 0 ? (7 - square / 8) * 8 + square % 8 : square };
+                    values[code][square].middlegame = sign * (material_value[symbol] + (*middlegame_tables[symbol])[table_index]);
+                    values[code][square].endgame = sign * (material_value[symbol] + (*endgame_tables[symbol])[table_index]);
+                    values[code][square].phase = phase_weight[symbol];
+                }
+            }
+        }
+        return values;
+    }
+
+    //Indexed by piece code and square. The entries of the empty code are all zero
+    constexpr std::array<std::array<square_value, 64>, 16> square_values{ create_square_values() };
+}
+
+#endif
\ No newline at end of file
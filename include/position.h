@@ -0,0 +1,148 @@
+/*
+This file contains the declaration of the position class, a compact value-type copy of the state of the game used as the
+fast path for move generation. Unlike the board, it does not allocate: a position is a 64-byte array of piece codes plus
+the colour turn, it can be copied freely and moves are made and unmade in place.
+It implements the same rules as the board (no castling, en passant or promotion: a pawn on the last row cannot move),
+and tools/movegen_stress.cpp checks that both generate the same moves.
+Squares are numbered from 0 (a1) to 63 (h8), i.e. the board location minus one, as in the board matrix.
+*/
+
+#ifndef POSITION_H
+#define POSITION_H
+
+#include "enum_attributes.h"
+#include <array>
+#include <cstdint>
+#include <string>
+
+//Piece codes stored in each square: 0 for an empty square, otherwise 1 + piece_symbol, plus 8 for the black pieces
+namespace piece_code {
+    constexpr std::uint8_t empty{ 0 };
+    constexpr std::uint8_t black_flag{ 8 };
+
+    constexpr std::uint8_t make(const piece_colour& colour, const piece_symbol& symbol) {
+        return static_cast<std::uint8_t>(1 + static_cast<int>(symbol) + (colour == piece_colour::black ? black_flag : 0));
+    }
+    constexpr piece_colour colour_of(const std::uint8_t& code) {
+        return (code & black_flag) ? piece_colour::black : piece_colour::white;
+    }
+    constexpr piece_symbol symbol_of(const std::uint8_t& code) {
+        return static_cast<piece_symbol>((code & 7) - 1);
+    }
+}
+
+struct chess_move {
+    std::uint8_t from{};
+    std::uint8_t to{};
+};
+
+//A move from a square to the same square stands for no move, e.g. when a position has no stored best move
+constexpr chess_move no_move{};
+
+constexpr bool operator==(const chess_move& lhs, const chess_move& rhs) {
+    return lhs.from == rhs.from && lhs.to == rhs.to;
+}
+constexpr bool operator!=(const chess_move& lhs, const chess_move& rhs) {
+    return !(lhs == rhs);
+}
+
+//Fixed-capacity list of moves, big enough for any position reachable under the rules of the board
+class move_list {
+private:
+    std::array<chess_move, 256> moves;
+    size_t number_of_moves{};
+public:
+    void push_back(const chess_move& new_move) noexcept { moves[number_of_moves++] = new_move; }
+    void clear() noexcept { number_of_moves = 0; }
+    size_t size() const noexcept { return number_of_moves; }
+    bool empty() const noexcept { return number_of_moves == 0; }
+    chess_move& operator[](const size_t& index) noexcept { return moves[index]; }
+    const chess_move& operator[](const size_t& index) const noexcept { return moves[index]; }
+    chess_move* begin() noexcept { return moves.data(); }
+    chess_move* end() noexcept { return moves.data() + number_of_moves; }
+    const chess_move* begin() const noexcept { return moves.data(); }
+    const chess_move* end() const noexcept { return moves.data() + number_of_moves; }
+};
+
+//Material plus piece-square score (white minus black) for the middlegame and the endgame, and phase of the game.
+//The position keeps it up to date on every change, so the evaluation does not have to loop over the pieces
+struct material_pst_score {
+    int middlegame{};
+    int endgame{};
+    int phase{};
+};
+
+class position {
+private:
+    std::array<std::uint8_t, 64> squares{};
+    std::array<int, 2> king_square{}; //indexed by piece_colour
+    piece_colour colour_turn{ piece_colour::white };
+    material_pst_score material_pst{};
+    std::uint64_t hash{}; //Zobrist hash of the pieces and the colour turn, see zobrist.h
+
+    void add_square_value(const std::uint8_t& code, const int& square, const int& sign) noexcept;
+
+    enum class move_kind {
+        all,
+        captures,
+        quiets,
+    };
+
+    //Generation specialised at compile time for each colour and kind of move. The public functions below dispatch to them
+    template <piece_colour By> bool is_attacked_by(const int& square) const noexcept;
+    template <piece_colour Us, move_kind Kind = move_kind::all> void generate_piece_moves_for(const int& from, move_list& moves) const;
+    template <piece_colour Us, move_kind Kind = move_kind::all> void generate_pseudo_legal_moves_for(move_list& moves) const;
+    template <piece_colour Us> void generate_legal_moves_for(move_list& moves) const;
+    //Square of the least valuable piece of colour By attacking square, ignoring the pieces on the squares set in
+    //removed (bit i for square i), or -1 if there is none
+    template <piece_colour By> int least_valuable_attacker(const int& square, const std::uint64_t& removed) const noexcept;
+public:
+    position(); //starting position
+    position(const std::string& fen);
+    //Set up a position from its squares, which must hold exactly one king of each colour
+    position(const std::array<std::uint8_t, 64>& squares_in, const piece_colour& colour_turn_in);
+
+    std::string to_fen() const;
+
+    std::uint8_t get_square(const int& square) const noexcept { return squares[square]; }
+    const std::array<std::uint8_t, 64>& get_squares() const noexcept { return squares; }
+    piece_colour get_colour_turn() const noexcept { return colour_turn; }
+    int get_king_square(const piece_colour& colour) const noexcept { return king_square[static_cast<int>(colour)]; }
+    const material_pst_score& get_material_pst() const noexcept { return material_pst; }
+    std::uint64_t get_hash() const noexcept { return hash; }
+
+    //Place or remove a piece directly (e.g. to set up or simplify positions). Kings cannot be removed.
+    void set_square(const int& square, const std::uint8_t& code);
+    void set_colour_turn(const piece_colour& colour) noexcept;
+
+    bool is_attacked(const int& square, const piece_colour& by_colour) const noexcept;
+    bool in_check() const noexcept;
+
+    //Moves that follow the movement rules of the pieces, whether or not they leave the own king in check.
+    //generate_piece_moves appends the moves of the piece on the given square, of either colour
+    void generate_piece_moves(const int& from, move_list& moves) const;
+    void generate_pseudo_legal_moves(move_list& moves) const;
+    void generate_legal_moves(move_list& moves) const;
+    //The pseudo-legal moves split in two, so that a search generates the quiet moves only if the captures are not enough
+    void generate_captures(move_list& moves) const;
+    void generate_quiet_moves(move_list& moves) const;
+    bool is_legal(const chess_move& pseudo_legal_move) const;
+    //Whether a move (e.g. one remembered from another position) follows the movement rules of a piece of the colour turn
+    bool is_pseudo_legal(const chess_move& candidate_move) const;
+
+    //Static exchange evaluation: material won (in centipawns, negative if lost) by the colour of the moving piece once
+    //all the captures on the destination square are played out, each colour capturing with its least valuable piece
+    //and free to stop when going on would lose material. The sliding pieces behind the pieces that capture join in
+    //(x-rays). No move is made, and pins are ignored. It works for quiet moves too (whether the piece would be lost)
+    int see(const chess_move& exchange_move) const noexcept;
+
+    //make_move returns the code of the captured piece (piece_code::empty if none), which unmake_move needs to restore it
+    std::uint8_t make_move(const chess_move& new_move) noexcept;
+    void unmake_move(const chess_move& old_move, const std::uint8_t& captured) noexcept;
+    //Pass the turn without moving (a null move, for null-move pruning in the search), and take the pass back. The side
+    //to move must not be in check
+    void make_null_move() noexcept;
+    void unmake_null_move() noexcept { make_null_move(); }
+};
+
+#endif
\ No newline at end of file
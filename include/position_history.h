@@ -0,0 +1,75 @@
+/*
+This file contains the declaration of the position history, which keeps the hashes of the positions reached in the
+game (or along a line of the search) to detect draws by repetition and by the fifty-move rule.
+The hashes are kept in a ring buffer of fixed capacity together with the halfmove clock of each position (the number
+of moves since the last capture or pawn move), so pushing and popping never allocate. Only the positions since the
+last capture or pawn move can repeat the current one, and only those with the same colour turn (every second one), so
+the repetition check compares at most halfmove clock / 2 hashes, without branching on anything but the loop counter.
+*/
+
+#ifndef POSITION_HISTORY_H
+#define POSITION_HISTORY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+class position_history {
+private:
+    static constexpr size_t capacity{ 256 }; //power of two, longer than the halfmove clock of a fifty-move draw plus a search line
+    static constexpr size_t index_mask{ capacity - 1 };
+
+    std::array<std::uint64_t, capacity> hashes{};
+    std::array<std::uint16_t, capacity> halfmove_clocks{};
+    size_t number_of_positions{}; //pushed and not popped, may exceed the capacity (the oldest ones are overwritten)
+
+    size_t last_index() const noexcept { return (number_of_positions - 1) & index_mask; }
+    //Number of earlier positions that may repeat the current one
+    size_t repetition_window() const noexcept;
+public:
+    void clear() noexcept { number_of_positions = 0; }
+    size_t size() const noexcept { return number_of_positions; }
+
+    //Add the position reached after a move. The halfmove clock starts again from 0 after a capture or a pawn move
+    void push(const std::uint64_t& hash, const bool& reset_halfmove_clock) noexcept {
+        std::uint16_t halfmove_clock{ static_cast<std::uint16_t>(
+            (reset_halfmove_clock || number_of_positions == 0) ? 0 : halfmove_clocks[last_index()] + 1) };
+        number_of_positions++;
+        hashes[last_index()] = hash;
+        halfmove_clocks[last_index()] = halfmove_clock;
+    }
+    //Remove the last position, e.g. when a move is unmade. The history must not be empty
+    void pop() noexcept { number_of_positions--; }
+    //Add a position with a known halfmove clock, e.g. to restore a saved history
+    void push_with_halfmove_clock(const std::uint64_t& hash, const int& halfmove_clock) noexcept {
+        number_of_positions++;
+        hashes[last_index()] = hash;
+        halfmove_clocks[last_index()] = static_cast<std::uint16_t>(halfmove_clock);
+    }
+
+    //The history must not be empty for the functions below
+    std::uint64_t get_last_hash() const noexcept { return hashes[last_index()]; }
+    int get_halfmove_clock() const noexcept { return halfmove_clocks[last_index()]; }
+    //The same for the position back positions before the last one (0 for the last one), e.g. to save the history. back
+    //must be lower than size() and than the capacity
+    std::uint64_t get_hash(const size_t& back) const noexcept { return hashes[(number_of_positions - 1 - back) & index_mask]; }
+    int get_halfmove_clock(const size_t& back) const noexcept { return halfmove_clocks[(number_of_positions - 1 - back) & index_mask]; }
+
+    //Whether the last position appeared before (a twofold repetition, which the search treats as a draw)
+    bool is_repetition() const noexcept {
+        const std::uint64_t& hash{ hashes[last_index()] };
+        size_t window{ repetition_window() };
+        bool repeated{ false };
+        for (size_t back{ 4 }; back <= window; back += 2) {
+            repeated |= hashes[(number_of_positions - 1 - back) & index_mask] == hash;
+        }
+        return repeated;
+    }
+    //Number of times the last position has appeared, counting the last one
+    int count_occurrences() const noexcept;
+    bool is_threefold_repetition() const noexcept { return count_occurrences() >= 3; }
+    //One hundred moves (fifty of each side) without a capture or a pawn move
+    bool is_fifty_move_draw() const noexcept { return get_halfmove_clock() >= 100; }
+};
+
+#endif
@@ -1,7 +1,7 @@
 /*
 Luis Fernandez - 10 April 2020
-Declaration of queen piece. It overloads the pure virtual functions of the piece abstract base class.
-It has a default and a parametrised constructor, as well as a destructor.
+Declaration of queen piece. It overloads the pure virtual function of the piece abstract base class.
+It has a default and two parametrised constructors (starting column or arbitrary board coordinates), as well as a destructor.
 */
 
 #ifndef QUEEN_H
@@ -16,9 +16,9 @@ class queen : public piece {
 public:
     queen();
     queen(const char& column, const piece_colour& colour_in);
+    queen(const std::pair<char, int>& location_in, const piece_colour& colour_in);
     ~queen();
     std::list<int> get_allowed_moves(const std::array<board_occupation, 64>& board_matrix) const;
-    std::string get_symbol_string(const bool& on_white_tile) const noexcept;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,126 @@
+/*
+This file contains the declaration of the searcher, an alpha-beta search of the position (see position.h) deepened one
+ply at a time up to a given depth, that ends every line in a quiescence search, so that the leaves are not evaluated in
+the middle of an exchange (the horizon effect: a search that stops right after a queen takes a pawn defended by another
+pawn sees a pawn won).
+The quiescence search only plays captures, generated without the quiet moves (position::generate_captures):
+    -stand pat: the side to move may decline every capture, so the static evaluation is a lower bound of the node, and
+     the node is cut off at once if it already reaches beta
+    -delta pruning: a capture is skipped if the piece it takes, plus a safety margin, cannot bring the evaluation up to
+     alpha, and the whole node if not even taking a queen could
+    -SEE pruning: captures that lose material (position::see below 0) are skipped
+A side in check cannot stand pat, so all its evasions are searched instead and checkmate is seen at the leaves. The
+quiet moves that give check can also be tried at the first ply of the quiescence search (search_settings).
+The main search is a principal variation search (the moves after the first one are searched with a null window, and
+again with the full window only if they turn out better), made selective by features that can each be switched off at
+runtime, to measure what each one is worth:
+    -null-move pruning: if the side to move is still above beta after passing the turn and a search reduced by
+     null_move_reduction plies, the node is cut off. Not in check, and not without pieces other than pawns (zugzwang)
+    -late move reductions: the quiet moves searched late in a node are searched one or two plies less deep, and again
+     at full depth if they beat alpha
+    -futility pruning: one and two plies from the horizon, the quiet moves that do not give check are skipped when the
+     static evaluation plus a margin cannot reach alpha
+    -check extensions: a node in check is searched one ply deeper
+    -aspiration windows: each iteration but the first ones is searched within a window around the score of the one
+     before, and again with a wider window if the score falls outside it
+The moves come from the move picker (move_picker.h), fed with the killer moves, history scores and countermoves the
+searcher learns as it goes (ordering_tables.h), which it keeps from one search to the next.
+Scores are in centipawns from the point of view of the side to move, as the evaluation; mate scores are mate_score
+minus the number of plies to the mate. The searcher keeps the hashes of the positions along the line searched
+(position_history.h), and scores 0 a position that repeats an earlier one of the line or ends a fifty-move draw. The
+positions of the game before the root are not known, so only the repetitions within the search are seen.
+*/
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "ordering_tables.h"
+#include "position.h"
+#include "position_history.h"
+#include <cstdint>
+
+struct search_settings {
+    bool quiescence_checks{ false }; //also try the quiet moves that give check at the first ply of the quiescence search
+    int delta_margin{ 200 }; //centipawns the positional terms may add on top of the material a capture wins
+    bool null_move_pruning{ true };
+    bool late_move_reductions{ true };
+    bool futility_pruning{ true };
+    bool check_extensions{ true };
+    bool aspiration_windows{ true };
+    int null_move_reduction{ 2 }; //plies, one more from depth 7
+    int futility_margin{ 150 }; //centipawns per ply from the horizon
+    int aspiration_window{ 40 }; //centipawns on each side of the last score
+};
+
+//Counters of the work done since they were last cleared. The nodes are counted once, either in the main search or in
+//the quiescence search. For each selective feature, how often it applied: the nodes it saved are measured by searching
+//with it switched off (bench/search_benchmark.cpp)
+struct search_statistics {
+    std::uint64_t nodes{};
+    std::uint64_t quiescence_nodes{};
+    std::uint64_t stand_pat_cutoffs{};
+    std::uint64_t delta_pruned{}; //captures and whole nodes
+    std::uint64_t see_pruned{};
+    std::uint64_t null_move_searches{};
+    std::uint64_t null_move_cutoffs{};
+    std::uint64_t reduced_moves{};
+    std::uint64_t reduction_researches{}; //reduced moves that beat alpha and were searched again at full depth
+    std::uint64_t futility_pruned{};
+    std::uint64_t check_extensions{};
+    std::uint64_t aspiration_researches{};
+    //Nodes of the main search cut off, and of those, the ones cut off by the first move searched: the closer the
+    //ratio is to 1, the better the moves are ordered
+    std::uint64_t beta_cutoffs{};
+    std::uint64_t first_move_cutoffs{};
+
+    double first_move_cutoff_rate() const noexcept {
+        return beta_cutoffs == 0 ? 0.0 : static_cast<double>(first_move_cutoffs) / static_cast<double>(beta_cutoffs);
+    }
+};
+
+struct search_result {
+    chess_move best_move{ no_move }; //no_move if the side to move has no legal move
+    int score{};
+};
+
+class searcher {
+public:
+    static constexpr int mate_score{ 32000 };
+    static constexpr int max_ply{ 128 };
+    //Scores beyond it are mates
+    static constexpr int mate_bound{ mate_score - max_ply };
+private:
+    search_settings settings;
+    search_statistics statistics;
+    ordering_tables tables;
+    position_history history; //positions from the root to the node searched
+
+    //Make or unmake a move (or the null move) of the search, and add or remove the position in the history
+    std::uint8_t make_move(position& game_position, const chess_move& new_move) noexcept;
+    void unmake_move(position& game_position, const chess_move& old_move, const std::uint8_t& captured) noexcept;
+    void make_null_move(position& game_position) noexcept;
+    void unmake_null_move(position& game_position) noexcept;
+
+    search_result search_root(position& root, int alpha, const int& beta, const int& depth, const chess_move& first_move);
+    //previous_move is the move that led to the position (no_move after a null move), for the countermoves
+    int alpha_beta(position& game_position, int alpha, const int& beta, int depth, const int& ply, const chess_move& previous_move);
+    //Learn from a quiet move that cut off a node, and from the quiet moves tried before it, which did not
+    void update_ordering_tables(const position& game_position, const chess_move& cutoff_move, const move_list& quiet_moves_tried, const int& depth, const int& ply, const chess_move& previous_move) noexcept;
+public:
+    explicit searcher(const search_settings& settings_in = {}) : settings{ settings_in } {}
+
+    //Best move of the position searched to a depth (in plies, at least 1) followed by the quiescence search. It throws
+    //std::invalid_argument if the depth is lower
+    search_result search(const position& root, const int& depth);
+    //Quiescence search of a position between alpha and beta (fail-soft: the score may fall outside them). ply is the
+    //distance to the root, for the mate scores. The position is the same on return
+    int quiescence(position& game_position, int alpha, const int& beta, const int& ply, const int& quiescence_ply = 0);
+
+    const search_settings& get_settings() const noexcept { return settings; }
+    const search_statistics& get_statistics() const noexcept { return statistics; }
+    void clear_statistics() noexcept { statistics = {}; }
+    //Forget the move ordering learnt from the searches so far, e.g. before searching the positions of another game
+    void clear_ordering_tables() noexcept { tables.clear(); }
+};
+
+#endif
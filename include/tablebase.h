@@ -0,0 +1,98 @@
+/*
+This file contains the declaration of the endgame tablebase, which knows the result with best play (win, draw or loss
+for the colour turn, and the number of plies to mate) of every position with up to 4 pieces, kings included.
+The tables are generated locally by retrograde analysis with the rules of position (and so of the board: no castling,
+en passant or promotion, so a pawn that reaches the last row stays there). No file is needed.
+Each table covers one material (e.g. "KQK" or "KRKP": the white pieces then the black ones, each starting with the king)
+and the same material with the colours swapped, by mirroring the board. The white king is kept in one symmetric part of
+the board (the a1-d1-d4 triangle without pawns, the a to d columns with pawns), so a table of 4 pieces without pawns has
+2 * 10 * 64^3 positions, and each position takes a single byte with its result and distance to mate.
+*/
+
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include "position.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class thread_pool;
+
+enum class tablebase_wdl {
+    loss,
+    draw,
+    win,
+};
+
+struct tablebase_result {
+    tablebase_wdl wdl{ tablebase_wdl::draw }; //for the colour turn
+    int plies_to_mate{}; //0 for draws, and for a checkmated colour turn
+};
+
+struct tablebase_table_info {
+    std::string material;
+    size_t positions{}; //legal positions of the table, without the ones equal by symmetry
+    size_t wins{}; //for the colour turn
+    size_t draws{};
+    size_t losses{};
+    int longest_mate{}; //in plies
+};
+
+class tablebase {
+private:
+    struct table;
+    //A material found in the tables, with the colours as in the table or swapped
+    struct table_reference {
+        const table* material_table{ nullptr };
+        bool colours_swapped{ false };
+    };
+    //Pieces of a position as the tables see them: the kings, and up to two other pieces sorted by code
+    struct piece_list {
+        int white_king{};
+        int black_king{};
+        int number_of_others{};
+        std::array<std::uint8_t, 2> codes{};
+        std::array<int, 2> squares{};
+        piece_colour colour_turn{ piece_colour::white };
+    };
+
+    std::vector<std::unique_ptr<table>> tables;
+    std::array<table_reference, 256> tables_by_material{}; //indexed by the key of the codes of the pieces other than the kings
+
+    //Value byte (see tablebase.cpp) of a position. Returns false if its material has no table
+    bool find_value(piece_list pieces, std::uint8_t& value) const noexcept;
+    void generate_table(table& new_table, thread_pool& pool);
+public:
+    static constexpr int max_pieces{ 4 };
+
+    tablebase();
+    ~tablebase();
+    tablebase(tablebase&&) noexcept;
+    tablebase& operator=(tablebase&&) noexcept;
+
+    //Generate the table of a material (e.g. "KQK" or "KRKP") and the tables of fewer pieces it leads to by captures,
+    //unless they were generated before. It throws std::invalid_argument if the material is not valid
+    void generate(const std::string& material, thread_pool& pool);
+    //Generate every table with up to number_of_pieces pieces
+    void generate_all(const int& number_of_pieces, thread_pool& pool);
+
+    //Name of the material of a position, with the stronger side first as in the tables (e.g. "KRK" for a lone white king
+    //against a king and a rook)
+    static std::string material_of(const position& probe_position);
+    bool has_table(const std::string& material) const;
+
+    //Result of the position with best play. Returns false if there is no table for its material. Two lone kings are
+    //always a draw
+    bool probe(const position& probe_position, tablebase_result& result) const;
+    //Legal move that keeps the best result: the fastest mate when winning, the slowest one when losing. Returns false if
+    //there is no table or no legal move
+    bool best_move(const position& probe_position, chess_move& chosen_move) const;
+
+    std::vector<tablebase_table_info> get_table_info() const;
+    size_t memory_usage() const noexcept;
+};
+
+#endif
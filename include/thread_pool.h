@@ -0,0 +1,55 @@
+/*
+This file contains the declaration of a fixed-size pool of worker threads with a shared queue of tasks.
+Tasks are submitted with submit(), which returns a future of the result, and parallel_for() splits a range of items into
+chunks that the workers take from a shared counter. Each of the parallel_for slices receives its own index, so that
+callers can keep one scratch buffer per slice instead of allocating inside the loop.
+*/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class thread_pool {
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex tasks_mutex;
+    std::condition_variable tasks_available;
+    bool stopping{ false };
+
+    void worker_loop();
+public:
+    thread_pool(const size_t& number_of_threads = std::thread::hardware_concurrency());
+    ~thread_pool();
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    size_t size() const noexcept { return workers.size(); }
+
+    template <class c_function> std::future<std::invoke_result_t<c_function>> submit(c_function&& function) {
+        auto task{ std::make_shared<std::packaged_task<std::invoke_result_t<c_function>()>>(std::forward<c_function>(function)) };
+        std::future<std::invoke_result_t<c_function>> result{ task->get_future() };
+        {
+            std::lock_guard<std::mutex> lock{ tasks_mutex };
+            tasks.emplace_back([task]() { (*task)(); });
+        }
+        tasks_available.notify_one();
+        return result;
+    }
+
+    //Call function(slice, begin, end) over [0, number_of_items) in chunks of chunk_size and wait for all of them.
+    //slice is in range from 0 to size() - 1 and no two concurrent calls share it.
+    void parallel_for(const size_t& number_of_items, const size_t& chunk_size,
+        const std::function<void(const size_t& slice, const size_t& begin, const size_t& end)>& function);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+/*
+This file contains the Zobrist keys used to hash positions, computed at compile time.
+The hash of a position is the XOR of the key of each piece on its square, plus the colour key when black moves, so it
+can be updated with two or three XORs per move instead of being computed again. As there is no castling or en passant,
+the pieces and the colour turn are all that tells two positions apart.
+The keys are indexed by piece code (see position.h) and square, and the key of an empty square is 0.
+*/
+
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <array>
+#include <cstdint>
+
+namespace zobrist {
+    //splitmix64, which gives well-spread 64-bit values from consecutive seeds
+    constexpr std::uint64_t mix(std::uint64_t seed) {
+        seed += 0x9E3779B97F4A7C15ULL;
+        seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+        return seed ^ (seed >> 31);
+    }
+
+    constexpr std::array<std::array<std::uint64_t, 64>, 16> create_piece_square_keys() {
+        std::array<std::array<std::uint64_t, 64>, 16> keys{};
+        for (int code{ 1 }; code < 16; code++) {
+            for (int square{}; square < 64; square++) {
+                keys[code][square] = mix(static_cast<std::uint64_t>(64 * code + square));
+            }
+        }
+        return keys;
+    }
+
+    inline constexpr std::array<std::array<std::uint64_t, 64>, 16> piece_square{ create_piece_square_keys() };
+    inline constexpr std::uint64_t black_to_move{ mix(0) };
+}
+
+#endif
@@ -19,7 +19,7 @@ bishop::bishop() {
 bishop::bishop(const char& column, const piece_colour& colour_in) {
     //std::cout << "Bishop parametrised constructor called." << std::endl;
     try {
-        int column_number{ coordinates::alphabetical_dictionary.at(column) };
+        int column_number{ coordinates::column_number(column) };
     }
     catch (const std::out_of_range&) {
         throw std::out_of_range("Error: columns must go from 'a' to 'h'.");
@@ -36,13 +36,18 @@ bishop::bishop(const char& column, const piece_colour& colour_in) {
     symbol = piece_symbol::bishop;
 }
 
+bishop::bishop(const std::pair<char, int>& location_in, const piece_colour& colour_in)
+    : piece{ location_in, colour_in, piece_symbol::bishop }
+{
+}
+
 bishop::~bishop() {
-    //std::cout << "Destructor of bishop of colour " << colour_string_map.at(colour) << " called at position " << location.first << location.second << "." << std::endl;
+    //std::cout << "Destructor of bishop of colour " << colour_string(colour) << " called at position " << location.first << location.second << "." << std::endl;
 }
 
 std::list<int> bishop::get_allowed_moves(const std::array<board_occupation, 64>& board_matrix) const {
     std::list<int> allowed_moves;
-    piece_colour colour_opposite{ opposite_colour.at(colour) };
+    piece_colour colour_opposite{ opposite_colour(colour) };
     int current_location{ coordinates::flatten_board_coordinates(location) };
 
     //Use objects from the allowed_moves_getter files
@@ -59,13 +64,4 @@ std::list<int> bishop::get_allowed_moves(const std::array<board_occupation, 64>&
     allowed_moves.splice(allowed_moves.end(), up_right.get_allowed_moves(current_location, board_matrix, colour_opposite));
 
     return allowed_moves;
-}
-
-std::string bishop::get_symbol_string(const bool& on_white_tile) const noexcept {
-    if (on_white_tile) {
-        return (colour == piece_colour::white) ? u8"♗" : u8"♝";
-    }
-    else {
-        return (colour == piece_colour::white) ? u8"♝" : u8"♗";
-    }
 }
\ No newline at end of file
@@ -10,13 +10,22 @@
 #include "coordinate_transforms.h"
 #include "enum_attributes.h"
 #include "console_visualisation.h"
+#include "occupancy.h"
+#include "frame_renderer.h"
+#include "position.h"
+#include "zobrist.h"
 #include <vector>
 #include <list>
 #include <array>
 #include <map>
 #include <exception>
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <cctype>
+#include <algorithm>
+#include <tuple>
+#include <cstdio>
+#include <cstdint>
 
 namespace {
     template <class c_type> void fill_pieces_column(std::vector<std::unique_ptr<piece>>& pieces_ingame, const size_t& column) {
@@ -28,6 +37,18 @@ namespace {
         pieces_ingame[column + 15] = std::make_unique<pawn>(coordinates::alphabetical_string[column - 1], piece_colour::black);
         pieces_ingame[column + 23] = std::make_unique<c_type>(coordinates::alphabetical_string[column - 1], piece_colour::black);
     }
+
+    piece_symbol fen_char_to_symbol(const char& fen_char) {
+        switch (std::tolower(fen_char)) {
+        case 'p': return piece_symbol::pawn;
+        case 'r': return piece_symbol::rook;
+        case 'n': return piece_symbol::knight;
+        case 'b': return piece_symbol::bishop;
+        case 'k': return piece_symbol::king;
+        case 'q': return piece_symbol::queen;
+        }
+        throw std::invalid_argument(std::string("Error: invalid FEN piece character '") + fen_char + "'.");
+    }
 }
 
 board::board() try : pieces_ingame(32) { //memory reservation
@@ -61,14 +82,93 @@ board::board() try : pieces_ingame(32) { //memory reservation
     piece_location_to_index_dictionary.clear();
 }
 catch (const std::bad_alloc&) {
-    std::cerr << "Memory error constructing board." << std::endl;
+    std::fputs("Memory error constructing board.\n", stderr);
     throw;
 }
 catch (const std::exception&) {
-    std::cerr << "Exception caught on board constructor." << std::endl;
+    std::fputs("Exception caught on board constructor.\n", stderr);
     throw;
 }
 
+board::board(const std::string& fen) {
+    //Only the piece placement field is read. The colour turn is kept by the caller, as in main.cpp
+    board_matrix.fill(board_occupation::empty);
+    std::string placement{ fen.substr(0, fen.find(' ')) };
+    std::map<piece_colour, int> number_of_kings{ {piece_colour::white,0},{piece_colour::black,0} };
+    int row{ 8 };
+    int column{ 1 };
+    for (const char& fen_char : placement) {
+        if (fen_char == '/') {
+            if (column != 9 || row == 1) {
+                throw std::invalid_argument("Error: FEN must describe 8 rows of 8 tiles.");
+            }
+            row--;
+            column = 1;
+            continue;
+        }
+        if (std::isdigit(static_cast<unsigned char>(fen_char))) {
+            column += fen_char - '0';
+        }
+        else {
+            piece_colour colour{ std::isupper(static_cast<unsigned char>(fen_char)) ? piece_colour::white : piece_colour::black };
+            piece_symbol symbol{ fen_char_to_symbol(fen_char) };
+            if (column > 8) {
+                throw std::invalid_argument("Error: FEN must describe 8 rows of 8 tiles.");
+            }
+            std::pair<char, int> piece_coords{ coordinates::column_letter(column), row };
+            if (symbol == piece_symbol::king) {
+                number_of_kings.at(colour)++;
+            }
+            pieces_map.insert({ piece_coords, create_piece(symbol, piece_coords, colour) });
+            board_matrix.at(coordinates::flatten_board_coordinates(piece_coords) - 1) = static_cast<board_occupation>(colour);
+            column++;
+        }
+        if (column > 9) {
+            throw std::invalid_argument("Error: FEN must describe 8 rows of 8 tiles.");
+        }
+    }
+    if (row != 1 || column != 9) {
+        throw std::invalid_argument("Error: FEN must describe 8 rows of 8 tiles.");
+    }
+    if (number_of_kings.at(piece_colour::white) != 1 || number_of_kings.at(piece_colour::black) != 1) {
+        throw std::invalid_argument("Error: FEN must contain exactly one king of each colour.");
+    }
+}
+
+board::board(const std::array<std::uint8_t, 64>& squares) {
+    set_pieces(squares);
+}
+
+void board::set_pieces(const std::array<std::uint8_t, 64>& squares) {
+    //Built aside and swapped in, so that the board is unchanged if the codes are not valid
+    std::map<std::pair<char, int>, std::unique_ptr<piece>> new_pieces_map;
+    std::array<board_occupation, 64> new_board_matrix;
+    new_board_matrix.fill(board_occupation::empty);
+    std::map<piece_colour, int> number_of_kings{ {piece_colour::white,0},{piece_colour::black,0} };
+    for (int square{}; square < 64; square++) {
+        const std::uint8_t& code{ squares[square] };
+        if (code == piece_code::empty) {
+            continue;
+        }
+        if (code > 15 || (code & 7) < 1 || (code & 7) > 6) {
+            throw std::invalid_argument("Error: invalid piece code.");
+        }
+        piece_colour colour{ piece_code::colour_of(code) };
+        piece_symbol symbol{ piece_code::symbol_of(code) };
+        std::pair<char, int> piece_coords{ coordinates::to_board_coordinates(square + 1) };
+        if (symbol == piece_symbol::king) {
+            number_of_kings.at(colour)++;
+        }
+        new_pieces_map.insert({ piece_coords, create_piece(symbol, piece_coords, colour) });
+        new_board_matrix[square] = static_cast<board_occupation>(colour);
+    }
+    if (number_of_kings.at(piece_colour::white) != 1 || number_of_kings.at(piece_colour::black) != 1) {
+        throw std::invalid_argument("Error: there must be exactly one king of each colour.");
+    }
+    pieces_map.swap(new_pieces_map);
+    board_matrix = new_board_matrix;
+}
+
 board::~board() {
     pieces_map.clear();
 }
@@ -87,48 +187,64 @@ board_occupation& board::set_element(const int& element) {
     return board_matrix.at(element - 1);
 }
 
-std::list<std::string> board::get_all_pieces_allowed_moves(const piece_colour& colour_turn, const bool& last_move_check, const int& last_move) const {
-    std::list<std::pair<char, int>> all_current_locations;
-    std::list<int> all_allowed_future_locations;
-    std::list<int> single_piece_allowed_future_locations;
+occupancy_masks board::get_occupancy() const {
+    return occupancy::from_board_matrix(board_matrix);
+}
+
+piece_symbol board::get_piece_symbol(const std::pair<char, int>& piece_board_coords) const {
+    if (pieces_map.count(piece_board_coords) == 0) {
+        throw std::out_of_range("Error: no piece to get symbol was found at the specified board coordinates.");
+    }
+    return pieces_map.at(piece_board_coords)->get_symbol();
+}
 
+std::vector<board_move> board::get_all_pieces_allowed_moves(const piece_colour& colour_turn, const bool& last_move_check, const int& last_move) const {
+    std::vector<board_move> all_allowed_moves;
+    all_allowed_moves.reserve(64);
     for (const auto& piece_pair : pieces_map) { //Loop over all pieces
         if (piece_pair.second->get_colour() == colour_turn) {
-            single_piece_allowed_future_locations = get_piece_allowed_moves(piece_pair.second->get_location(), last_move_check, last_move);
-            for (const int& future_location : single_piece_allowed_future_locations) { //Loop over the individual piece's moves
-                //Store the current location for as many allowed moves available.
-                //This is so below we can loop over both current and future locations simultaneously
-                all_current_locations.push_back(piece_pair.second->get_location());
+            int current_location{ coordinates::flatten_board_coordinates(piece_pair.first) };
+            for (const int& future_location : get_piece_allowed_moves(piece_pair.first, last_move_check, last_move)) {
+                all_allowed_moves.push_back({ current_location, future_location });
             }
-            all_allowed_future_locations.splice(all_allowed_future_locations.end(), single_piece_allowed_future_locations);
         }
     }
-    if (all_current_locations.size() != all_allowed_future_locations.size()) {
-        throw std::length_error("Fatal error: lists of current and future locations did not match in size.");
-    }
-
-    std::list<std::string> all_allowed_moves_string;
-    std::pair<char, int> future_board_coord;
-    std::ostringstream move_stringstream;
-    auto it_current_loc = all_current_locations.begin();
-    auto it_future_loc = all_allowed_future_locations.begin();
+    return all_allowed_moves;
+}
 
-    //Use a ostringstream to store all the allowed moves in a string of format "a2->b3".
-    for (; it_current_loc != all_current_locations.end() && it_future_loc != all_allowed_future_locations.end(); ++it_current_loc, ++it_future_loc) {
-        future_board_coord = coordinates::to_board_coordinates(*it_future_loc);
-        move_stringstream << (*it_current_loc).first << (*it_current_loc).second << u8"→" << future_board_coord.first << future_board_coord.second;
-        all_allowed_moves_string.push_back(move_stringstream.str());
-        move_stringstream.str(""); //clear stringstream
+std::vector<std::string> board::format_moves(const std::vector<board_move>& moves) {
+    //Sorting by column and then row of both locations gives the same order as sorting the strings
+    std::vector<board_move> sorted_moves{ moves };
+    auto sort_key = [](const board_move& move) {
+        std::pair<char, int> from{ coordinates::to_board_coordinates(move.from) };
+        std::pair<char, int> to{ coordinates::to_board_coordinates(move.to) };
+        return std::make_tuple(from.first, from.second, to.first, to.second);
+    };
+    std::sort(sorted_moves.begin(), sorted_moves.end(), [&sort_key](const board_move& lhs, const board_move& rhs) {
+        return sort_key(lhs) < sort_key(rhs);
+    });
+
+    std::vector<std::string> moves_strings;
+    moves_strings.reserve(sorted_moves.size());
+    for (const board_move& move : sorted_moves) {
+        std::pair<char, int> from{ coordinates::to_board_coordinates(move.from) };
+        std::pair<char, int> to{ coordinates::to_board_coordinates(move.to) };
+        std::string move_string;
+        move_string += from.first;
+        move_string += static_cast<char>('0' + from.second);
+        move_string += u8"→";
+        move_string += to.first;
+        move_string += static_cast<char>('0' + to.second);
+        moves_strings.push_back(std::move(move_string));
     }
-    all_allowed_moves_string.sort();
-    return all_allowed_moves_string;
+    return moves_strings;
 }
 
 bool board::check_for_check(const std::pair<char, int>& last_move_opposite_team, bool& last_move_check) {
     if (pieces_map.count(last_move_opposite_team) == 0) {
         throw std::out_of_range("The specified piece of opposite colour that last moved does not exist!");
     }
-    piece_colour colour_turn{ opposite_colour.at(pieces_map.at(last_move_opposite_team)->get_colour()) }; //current colour turn
+    piece_colour colour_turn{ opposite_colour(pieces_map.at(last_move_opposite_team)->get_colour()) }; //current colour turn
 
     std::pair<char, int> king_coords;
     for (const auto& piece_pair : pieces_map) { //Get coordinates of king
@@ -157,19 +273,17 @@ bool board::check_for_check(const std::pair<char, int>& last_move_opposite_team,
         if (inf_piece_loc == last_move_opposite_team) { //we have already checked the moves of the piece of opposite team that last moved
             continue;
         }
-        else if (inf_piece_symbol == piece_symbol::bishop || inf_piece_symbol == piece_symbol::queen) {
+        check_moves = false;
+        if (inf_piece_symbol == piece_symbol::bishop || inf_piece_symbol == piece_symbol::queen) {
             if (abs(inf_piece_loc.first - king_coords.first) == abs(inf_piece_loc.second - king_coords.second)) {
                 check_moves = true; //check moves of bishop (or queen) since they are in a position of potential check to the king
             }
         }
-        else if (inf_piece_symbol == piece_symbol::rook || inf_piece_symbol == piece_symbol::queen) {
+        if (inf_piece_symbol == piece_symbol::rook || inf_piece_symbol == piece_symbol::queen) {
             if (inf_piece_loc.first == king_coords.first || inf_piece_loc.second == king_coords.second) {
                 check_moves = true; //check moves of rook (or queen) since they are in a position of potential check to the king
             }
         }
-        else {
-            continue;
-        }
         if (check_moves) {
             inf_allowed_moves = piece_pair.second->get_allowed_moves(board_matrix);
             for (const int& move : inf_allowed_moves) {
@@ -182,91 +296,120 @@ bool board::check_for_check(const std::pair<char, int>& last_move_opposite_team,
     return false;
 }
 
-std::list<int> board::get_piece_allowed_moves(const std::pair<char, int>& piece_board_coords, const bool& last_move_check, const int& last_move) const {
-    if (pieces_map.count(piece_board_coords) == 0) {
-        throw std::out_of_range("Error: no piece to get allowed moves was found at the specified board coordinates.");
-    }
-    std::list<int> allowed_moves{ pieces_map.at(piece_board_coords)->get_allowed_moves(board_matrix) };
-    piece_colour colour_turn{ pieces_map.at(piece_board_coords)->get_colour() };
-    board_occupation current_occupation{ get_element(coordinates::flatten_board_coordinates(piece_board_coords)) };
-
-    std::pair<char, int> original_king_coords;
+std::pair<char, int> board::get_king_coords(const piece_colour& colour) const {
+    std::pair<char, int> king_coords;
     for (const auto& piece_pair : pieces_map) {
-        if (piece_pair.second->get_colour() == colour_turn && piece_pair.second->get_symbol() == piece_symbol::king) {
-            original_king_coords = piece_pair.second->get_location();
+        if (piece_pair.second->get_colour() == colour && piece_pair.second->get_symbol() == piece_symbol::king) {
+            king_coords = piece_pair.second->get_location();
         }
     }
+    return king_coords;
+}
+
+bool board::is_move_legal(const piece& moving_piece, const int& move, const std::pair<char, int>& original_king_coords, const bool& last_move_check, const int& last_move) const {
+    std::pair<char, int> piece_board_coords{ moving_piece.get_location() };
+    piece_colour colour_turn{ moving_piece.get_colour() };
+    int current_location{ coordinates::flatten_board_coordinates(piece_board_coords) };
+
+    std::array<board_occupation, 64> matrix_copy{ board_matrix };
+    matrix_copy.at(current_location - 1) = board_occupation::empty;
+    matrix_copy.at(move - 1) = board_matrix.at(current_location - 1);
 
-    std::array<board_occupation, 64> matrix_copy;
-    std::list<int> allowed_moves_reduced;
-    std::list<int> allowed_moves_to_check;
-    piece_symbol piece_symbol;
-    std::pair<char, int> piece_coords;
     std::pair<char, int> king_coords;
-    for (const int& move : allowed_moves) {
-        matrix_copy = board_matrix;
-        matrix_copy.at(coordinates::flatten_board_coordinates(piece_board_coords) - 1) = board_occupation::empty;
+    if (piece_board_coords == original_king_coords) {
+        king_coords = coordinates::to_board_coordinates(move);
+    }
+    else {
+        king_coords = original_king_coords;
+    }
 
-        if (piece_board_coords == original_king_coords) {
-            king_coords = coordinates::to_board_coordinates(move);
+    std::pair<char, int> piece_coords;
+    for (const auto& piece_pair : pieces_map) {
+        piece_coords = piece_pair.second->get_location();
+        //The move involves capturing this piece so don't check its moves
+        if (coordinates::flatten_board_coordinates(piece_coords) == move) {
+            continue;
         }
-        else {
-            king_coords = original_king_coords;
+        if (piece_pair.second->get_colour() == colour_turn) {
+            continue;
         }
-        matrix_copy.at(move - 1) = current_occupation;
-
+        piece_symbol piece_symbol{ piece_pair.second->get_symbol() };
         bool check_moves{ false };
-        bool found_move{ false };
-        bool move_is_allowed{ true };
-        for (const auto& piece_pair : pieces_map) {
-            piece_coords = piece_pair.second->get_location();
-            //The move involves capturing this piece so don't check its moves
-            if (coordinates::flatten_board_coordinates(piece_coords) == move) {
-                continue;
-            }
-            if (found_move) {
-                break;
-            }
-            if (piece_pair.second->get_colour() == colour_turn) {
-                continue;
-            }
-            piece_symbol = piece_pair.second->get_symbol();
-            check_moves = false;
-            //if the piece of opposite colour that last moved had put the king in check, cross-check its next moves
-            if (last_move_check && coordinates::flatten_board_coordinates(piece_coords) == last_move) {
-                check_moves = true;
-            }
-            else if (piece_symbol == piece_symbol::bishop || piece_symbol == piece_symbol::queen) {
+        //if the piece of opposite colour that last moved had put the king in check, cross-check its next moves
+        if (last_move_check && coordinates::flatten_board_coordinates(piece_coords) == last_move) {
+            check_moves = true;
+        }
+        else if (piece_symbol == piece_symbol::pawn || piece_symbol == piece_symbol::knight || piece_symbol == piece_symbol::king) {
+            check_moves = true; //pieces of short range only have a few moves, so always check whether they attack the king
+        }
+        else {
+            if (piece_symbol == piece_symbol::bishop || piece_symbol == piece_symbol::queen) {
                 if (abs(piece_coords.first - king_coords.first) == abs(piece_coords.second - king_coords.second)) {
                     check_moves = true; //check moves of bishop (or queen) since they are in a position of potential check to the king
                 }
             }
-            else if (piece_symbol == piece_symbol::rook || piece_symbol == piece_symbol::queen) {
+            if (piece_symbol == piece_symbol::rook || piece_symbol == piece_symbol::queen) {
                 if (piece_coords.first == king_coords.first || piece_coords.second == king_coords.second) {
                     check_moves = true; //check moves of rook (or queen) since they are in a position of potential check to the king
                 }
             }
-            else {
-                continue;
-            }
-            if (check_moves) {
-                allowed_moves_to_check = piece_pair.second->get_allowed_moves(matrix_copy);
-                for (const int& move_to_check : allowed_moves_to_check) {
-                    if (coordinates::to_board_coordinates(move_to_check) == king_coords) {
-                        move_is_allowed = false;
-                        found_move = true;
-                        break;
-                    }
+        }
+        if (check_moves) {
+            for (const int& move_to_check : piece_pair.second->get_allowed_moves(matrix_copy)) {
+                if (coordinates::to_board_coordinates(move_to_check) == king_coords) {
+                    return false; //the king would be in check after the move
                 }
             }
         }
-        if (move_is_allowed) {
+    }
+    return true;
+}
+
+std::list<int> board::get_piece_allowed_moves(const std::pair<char, int>& piece_board_coords, const bool& last_move_check, const int& last_move) const {
+    if (pieces_map.count(piece_board_coords) == 0) {
+        throw std::out_of_range("Error: no piece to get allowed moves was found at the specified board coordinates.");
+    }
+    const piece& moving_piece{ *pieces_map.at(piece_board_coords) };
+    std::pair<char, int> original_king_coords{ get_king_coords(moving_piece.get_colour()) };
+
+    std::list<int> allowed_moves_reduced;
+    for (const int& move : moving_piece.get_allowed_moves(board_matrix)) {
+        if (is_move_legal(moving_piece, move, original_king_coords, last_move_check, last_move)) {
             allowed_moves_reduced.push_back(move);
         }
     }
     return allowed_moves_reduced;
 }
 
+bool board::has_any_legal_move(const piece_colour& colour_turn, const bool& last_move_check, const int& last_move) const {
+    std::pair<char, int> original_king_coords{ get_king_coords(colour_turn) };
+    for (const auto& piece_pair : pieces_map) {
+        if (piece_pair.second->get_colour() != colour_turn) {
+            continue;
+        }
+        for (const int& move : piece_pair.second->get_allowed_moves(board_matrix)) {
+            if (is_move_legal(*piece_pair.second, move, original_king_coords, last_move_check, last_move)) {
+                return true; //stop at the first legal move
+            }
+        }
+    }
+    return false;
+}
+
+int board::count_legal_moves(const piece_colour& colour_turn, const bool& last_move_check, const int& last_move) const {
+    std::pair<char, int> original_king_coords{ get_king_coords(colour_turn) };
+    int number_of_moves{};
+    for (const auto& piece_pair : pieces_map) {
+        if (piece_pair.second->get_colour() != colour_turn) {
+            continue;
+        }
+        for (const int& move : piece_pair.second->get_allowed_moves(board_matrix)) {
+            number_of_moves += is_move_legal(*piece_pair.second, move, original_king_coords, last_move_check, last_move);
+        }
+    }
+    return number_of_moves;
+}
+
 void board::set_piece_location(const std::pair<char, int>& old_piece_coords, const std::pair<char, int>& new_piece_coords) {
     if (pieces_map.count(old_piece_coords) == 0){
         throw std::out_of_range("Error: no piece to set location was found at the specified board coordinates.");
@@ -292,228 +435,223 @@ void board::store_move(const std::pair<char, int>& new_piece_coords) {
     if (pieces_map.count(new_piece_coords) == 0) {
         throw std::out_of_range("Error: no moved piece to store move was found at the specified board coordinates.");
     }
-    std::string piece_symbol_string{ pieces_map.at(new_piece_coords)->get_symbol_string(false) };
+    const piece& moved_piece{ *pieces_map.at(new_piece_coords) };
+    store_move(moved_piece.get_colour(), moved_piece.get_symbol(), new_piece_coords);
+}
 
-    std::ostringstream move_stringstream; //Use ostringstream to concatenate move onto a string looking like "♗ a2"
-    move_stringstream << piece_symbol_string << " " << new_piece_coords.first << new_piece_coords.second;
-    moves_history.push_back(move_stringstream.str());
-    move_stringstream.str(""); //clear ostringstream
+void board::store_move(const piece_colour& colour, const piece_symbol& symbol, const std::pair<char, int>& new_board_coords) {
+    std::string move_string{ get_piece_symbol_string(colour, symbol, false) }; //a string looking like "♗ a2"
+    move_string += ' ';
+    move_string += new_board_coords.first;
+    move_string += static_cast<char>('0' + new_board_coords.second);
+    moves_history.push_back(std::move(move_string));
 }
 
-void board::show(const font& chosen_font, const piece_colour& colour_turn, const bool& check) const {
-    std::cout << "   ";
-    for (size_t letter_index{}; letter_index < 8; letter_index++) {
-        std::cout << coordinates::alphabetical_string[letter_index] << " ";
+void board::add_to_cemetery(const piece_colour& colour, const piece_symbol& symbol) {
+    cemetery.push_back(create_piece(symbol, { 'a', 1 }, colour)); //the location of a captured piece is never used
+}
+
+void board::take_back_move(const std::pair<char, int>& old_board_coords, const std::pair<char, int>& new_board_coords, const bool& captured) {
+    auto moved_piece{ pieces_map.find(new_board_coords) };
+    if (moved_piece == pieces_map.end() || pieces_map.count(old_board_coords) != 0 || (captured && cemetery.empty())) {
+        throw std::out_of_range("Error: the move to take back does not match the board.");
+    }
+    //The pieces check that they can move to a location, and a pawn cannot move back, so the piece is created again
+    piece_colour colour{ moved_piece->second->get_colour() };
+    pieces_map.insert({ old_board_coords, create_piece(moved_piece->second->get_symbol(), old_board_coords, colour) });
+    pieces_map.erase(moved_piece);
+    board_matrix.at(coordinates::flatten_board_coordinates(old_board_coords) - 1) = static_cast<board_occupation>(colour);
+    board_occupation& new_location{ board_matrix.at(coordinates::flatten_board_coordinates(new_board_coords) - 1) };
+    new_location = board_occupation::empty;
+    if (captured) {
+        const piece& captured_piece{ *cemetery.back() };
+        pieces_map.insert({ new_board_coords, create_piece(captured_piece.get_symbol(), new_board_coords, captured_piece.get_colour()) });
+        new_location = static_cast<board_occupation>(captured_piece.get_colour());
+        cemetery.pop_back();
+    }
+    if (!moves_history.empty()) {
+        moves_history.pop_back();
     }
-    std::cout << "\t\tMoves history" << "\t\t\tCemetery" << std::endl << " ";
+}
 
-    std::cout << top_left_corner;
-    for (size_t i{}; i < 8; i++) {
-        std::cout << board_symbols.at({ chosen_font,"line" }); //Use dictionary from "console_visualisation.h"
-    }
-    std::cout << board_symbols.at({ chosen_font,"small_line" }) << top_right_corner;
-    std::cout << std::endl;
-
-    size_t moves_history_index{ 1 }; //define this size_t variable to use as a counter of the moves performed
-    for (size_t row{ 8 }; row > 0; row--) {
-        std::cout << row << u8"││";
-        for (size_t column{ 1 }; column < 9; column++) {
-            bool on_white_tile{ (row + column) % 2 != 0 }; //check if piece is on a white or black tile
-            auto dictionary_it{ pieces_map.find({ coordinates::numerical_dictionary.at(column),row }) };
-            bool print_piece{ false };
-            if (dictionary_it != pieces_map.end()){ //There is a piece in the location
-                //check if found the checked king
-                if (check && dictionary_it->second->get_symbol() == piece_symbol::king && dictionary_it->second->get_colour() == colour_turn) {
-                    change_font_colour(on_white_tile ? font_colour::red_white_back : font_colour::red);
-                    std::cout << dictionary_it->second->get_symbol_string(on_white_tile) << " ";
-                    change_font_colour(font_colour::white);
-                }
-                else {
-                    if (on_white_tile) {
-                        change_font_colour(font_colour::black_white_back);
-                        std::cout << dictionary_it->second->get_symbol_string(on_white_tile) << (column == 8 && chosen_font == font::NSimSun ? u8"│" : " ");
-                        change_font_colour(font_colour::white);
-                    }
-                    else {
-                        std::cout << dictionary_it->second->get_symbol_string(on_white_tile) << (column == 8 && chosen_font == font::NSimSun ? u8"│" : " ");
-                    }
-                }
-                print_piece = true; //A piece was found and printed
-            }
-            if(!print_piece) { //The tile was empty
-                if (on_white_tile) {
-                    std::cout << board_symbols.at({ chosen_font,"white_tile" });
-                }
-                else {
-                    if (row == 8) {
-                        std::cout << board_symbols.at({ chosen_font,"top_line" });
-                    }
-                    else if (row == 1) {
-                        std::cout << board_symbols.at({ chosen_font,"bottom_line" });
-                    }
-                    else {
-                        std::cout << " " << (column == 8 && chosen_font == font::NSimSun ? u8"│" : " ");
-                    }
-                }
-            }
-        }
-        std::cout << (chosen_font == font::MS_Gothic ? u8"▏▏" : u8"│");
-        int moves_per_line{};
-        while (moves_history_index <= moves_history.size()) { //print as many as 4 allowed moves in this line
-            std::cout << '\t' << moves_history_index << "." << moves_history.at(moves_history_index - 1);
-            moves_history_index++;
-            moves_per_line++;
-            if (moves_per_line == 4) {
-                break;
-            }
-        }
-        while (5 - moves_per_line > 0) { //print some space to print the cemetery next to the allowed moves
-            std::cout << "\t";
-            moves_per_line++;
-        }
-        std::cout << " ";
-        for (const auto& captured_piece : cemetery) {
-            //Print the captured pieces in the same row as their initial row in the board
-            //This is 7 and 2 for the black and white pawns respectively, and 8 and 1 for the other type of pieces of black and white colour respectively
-            if (row == 8 && captured_piece->get_symbol() != piece_symbol::pawn && captured_piece->get_colour() == piece_colour::black) {
-                std::cout << captured_piece->get_symbol_string(false) << " ";
-            }
-            else if (row == 7 && captured_piece->get_symbol() == piece_symbol::pawn && captured_piece->get_colour() == piece_colour::black) {
-                std::cout << captured_piece->get_symbol_string(false) << " ";
-            }
-            else if (row == 2 && captured_piece->get_symbol() == piece_symbol::pawn && captured_piece->get_colour() == piece_colour::white) {
-                std::cout << captured_piece->get_symbol_string(false) << " ";
-            }
-            else if (row == 1 && captured_piece->get_symbol() != piece_symbol::pawn && captured_piece->get_colour() == piece_colour::white) {
-                std::cout << captured_piece->get_symbol_string(false) << " ";
-            }
-        }
-        std::cout << std::endl;
+void board::truncate_moves_and_cemetery(const size_t& number_of_moves, const size_t& number_of_captures) {
+    if (number_of_moves < moves_history.size()) {
+        moves_history.resize(number_of_moves);
+    }
+    if (number_of_captures < cemetery.size()) {
+        cemetery.resize(number_of_captures);
     }
+}
 
-    std::cout << " " << bottom_left_corner;
-    for (size_t i{}; i < 8; i++) {
-        std::cout << board_symbols.at({ chosen_font,"line" });
+position board::to_position(const piece_colour& colour_turn) const {
+    std::array<std::uint8_t, 64> squares{};
+    for (const auto& [piece_coords, board_piece] : pieces_map) {
+        squares[coordinates::flatten_board_coordinates(piece_coords) - 1] = piece_code::make(board_piece->get_colour(), board_piece->get_symbol());
     }
-    std::cout << board_symbols.at({ chosen_font,"small_line" }) << bottom_right_corner;
-    std::cout << std::endl;
+    return position{ squares, colour_turn };
+}
 
-    std::cout << "   ";
-    for (size_t letter_index{}; letter_index < 8; letter_index++) {
-        std::cout << coordinates::alphabetical_string[letter_index] << " ";
+std::uint64_t board::get_hash(const piece_colour& colour_turn) const {
+    std::uint64_t hash{ colour_turn == piece_colour::black ? zobrist::black_to_move : 0 };
+    for (const auto& [piece_coords, board_piece] : pieces_map) {
+        int square{ coordinates::flatten_board_coordinates(piece_coords) - 1 };
+        hash ^= zobrist::piece_square[piece_code::make(board_piece->get_colour(), board_piece->get_symbol())][square];
     }
-    std::cout << std::endl << std::endl;
+    return hash;
+}
+
+void board::record_position(const piece_colour& colour_turn, const bool& capture_or_pawn_move) {
+    history.push(get_hash(colour_turn), capture_or_pawn_move);
+}
+
+int board::get_halfmove_clock() const noexcept {
+    return history.size() ? history.get_halfmove_clock() : 0;
+}
+
+bool board::is_fifty_move_draw() const noexcept {
+    return history.size() && history.is_fifty_move_draw();
+}
+
+bool board::is_threefold_repetition() const noexcept {
+    return history.size() && history.is_threefold_repetition();
 }
 
-void board::show(const font& chosen_font, const piece_colour& colour_turn, const std::pair<char, int>& selected_piece_coords, const bool& check) const {
-    //Most of the code in this function is identical to the other overload above, so the appropriate comments can be found there.
-    //The difference is that this function takes as argument the board coordinates of a selected piece to highlight it
+void board::draw(frame_renderer& renderer, const font& chosen_font, const piece_colour& colour_turn, const bool& check) const {
+    draw(renderer, chosen_font, colour_turn, nullptr, check);
+}
+
+void board::draw(frame_renderer& renderer, const font& chosen_font, const piece_colour& colour_turn, const std::pair<char, int>& selected_piece_coords, const bool& check) const {
+    draw(renderer, chosen_font, colour_turn, &selected_piece_coords, check);
+}
+
+void board::draw(frame_renderer& renderer, const font& chosen_font, const piece_colour& colour_turn, const std::pair<char, int>* selected_piece_coords, const bool& check) const {
+    //The frame has 12 lines: the letters and the top border, the 8 rows of the board, and the bottom border and the letters.
+    //Each row has a cell for its number, one for each tile (2 console columns wide) and one for the right border, the
+    //moves history and the cemetery, so that a move only redraws the two tiles involved and the text next to the board
+    constexpr int first_tile_column{ 4 };
+    constexpr int tile_width{ 2 };
+
+    std::string_view white_tile{ get_board_symbol(chosen_font, board_glyph::white_tile) };
+    std::string_view line{ get_board_symbol(chosen_font, board_glyph::line) };
+    std::string_view small_line{ get_board_symbol(chosen_font, board_glyph::small_line) };
+    std::string_view top_line{ get_board_symbol(chosen_font, board_glyph::top_line) };
+    std::string_view bottom_line{ get_board_symbol(chosen_font, board_glyph::bottom_line) };
+    const char* last_column_separator{ chosen_font == font::NSimSun ? u8"│" : " " };
+
+    //Place the pieces on a plain array so each tile is found without searching the pieces map
+    std::array<const piece*, 64> tile_pieces{};
+    for (const auto& located_piece : pieces_map) {
+        tile_pieces[8 * (located_piece.first.second - 1) + (located_piece.first.first - 'a')] = located_piece.second.get();
+    }
 
-    std::cout << "   ";
+    renderer.begin_frame(12);
+    std::string& letters{ renderer.add_cell(0, 1) };
+    letters += "   ";
     for (size_t letter_index{}; letter_index < 8; letter_index++) {
-        std::cout << coordinates::alphabetical_string[letter_index] << " ";
+        letters += coordinates::alphabetical_string[letter_index];
+        letters += ' ';
     }
-    std::cout << "\t\tMoves history" << "\t\t\tCemetery" << std::endl << " ";
+    letters += "\t\tMoves history\t\t\tCemetery";
 
-    std::cout << top_left_corner;
+    std::string& top_border{ renderer.add_cell(1, 1) };
+    top_border += ' ';
+    top_border += top_left_corner;
     for (size_t i{}; i < 8; i++) {
-        std::cout << board_symbols.at({ chosen_font,"line" });
-    }
-    std::cout << board_symbols.at({ chosen_font,"small_line" }) << top_right_corner;
-    std::cout << std::endl;
-
-    int piece_index{};
-    size_t moves_history_index{ 1 };
-    for (size_t row{ 8 }; row > 0; row--) {
-        std::cout << row << u8"││";
-        for (size_t column{ 1 }; column < 9; column++) {
-            bool on_white_tile{ (row + column) % 2 != 0 };
-            auto dictionary_it{ pieces_map.find({ coordinates::numerical_dictionary.at(column),row }) };
-            bool print_piece{ false };
-            if (dictionary_it != pieces_map.end()) {
-                if (dictionary_it->second->get_location() == selected_piece_coords) { //The selected piece was found
-                    //The piece will be highlighted by printing it in green
-                    change_font_colour(on_white_tile ? font_colour::green_white_back : font_colour::green);
-                    std::cout << dictionary_it->second->get_symbol_string(on_white_tile) << " ";
-                    change_font_colour(font_colour::white);
-                }
-                //check if found the checked king
-                else if (check && dictionary_it->second->get_symbol() == piece_symbol::king && dictionary_it->second->get_colour() == colour_turn) {
-                    change_font_colour(on_white_tile ? font_colour::red_white_back : font_colour::red);
-                    std::cout << dictionary_it->second->get_symbol_string(on_white_tile) << " ";
-                    change_font_colour(font_colour::white);
+        top_border += line;
+    }
+    top_border += small_line;
+    top_border += top_right_corner;
+
+    size_t moves_history_index{ 1 }; //counter of the moves shown so far
+    for (int row{ 8 }; row > 0; row--) {
+        size_t frame_line{ static_cast<size_t>(10 - row) };
+        std::string& row_number{ renderer.add_cell(frame_line, 1) };
+        row_number += static_cast<char>('0' + row);
+        row_number += u8"││";
+        for (int column{ 1 }; column < 9; column++) {
+            bool on_white_tile{ (row + column) % 2 != 0 }; //check if the tile is white or black
+            int tile_column{ first_tile_column + tile_width * (column - 1) };
+            const piece* tile_piece{ tile_pieces[8 * (row - 1) + column - 1] };
+            if (tile_piece) { //There is a piece in the location
+                if (selected_piece_coords && tile_piece->get_location() == *selected_piece_coords) {
+                    //The selected piece is highlighted in green
+                    std::string& tile{ renderer.add_cell(frame_line, tile_column, on_white_tile ? font_colour::green_white_back : font_colour::green) };
+                    tile += tile_piece->get_symbol_string(on_white_tile);
+                    tile += ' ';
                 }
-                else { //There is a piece but it's not the selected one
-                    if (on_white_tile) {
-                        change_font_colour(font_colour::black_white_back);
-                        std::cout << dictionary_it->second->get_symbol_string(on_white_tile) << (column == 8 && chosen_font == font::NSimSun ? u8"│" : " ");
-                        change_font_colour(font_colour::white);
-                    }
-                    else {
-                        std::cout << dictionary_it->second->get_symbol_string(on_white_tile) << (column == 8 && chosen_font == font::NSimSun ? u8"│" : " ");
-                    }
-                }
-                print_piece = true;
-            }
-            if (!print_piece) {
-                if (on_white_tile) {
-                    std::cout << board_symbols.at({ chosen_font,"white_tile" });
+                else if (check && tile_piece->get_symbol() == piece_symbol::king && tile_piece->get_colour() == colour_turn) {
+                    //The checked king is highlighted in red
+                    std::string& tile{ renderer.add_cell(frame_line, tile_column, on_white_tile ? font_colour::red_white_back : font_colour::red) };
+                    tile += tile_piece->get_symbol_string(on_white_tile);
+                    tile += ' ';
                 }
                 else {
-                    if (row == 8) {
-                        std::cout << board_symbols.at({ chosen_font,"top_line" });
-                    }
-                    else if (row == 1) {
-                        std::cout << board_symbols.at({ chosen_font,"bottom_line" });
-                    }
-                    else {
-                        std::cout << " " << (column == 8 && chosen_font == font::NSimSun ? u8"│" : " ");
-                    }
+                    std::string& tile{ renderer.add_cell(frame_line, tile_column, on_white_tile ? font_colour::black_white_back : font_colour::white) };
+                    tile += tile_piece->get_symbol_string(on_white_tile);
+                    tile += column == 8 ? last_column_separator : " ";
                 }
             }
+            else if (on_white_tile) { //The tile is empty
+                renderer.add_cell(frame_line, tile_column, white_tile);
+            }
+            else if (row == 8) {
+                renderer.add_cell(frame_line, tile_column, top_line);
+            }
+            else if (row == 1) {
+                renderer.add_cell(frame_line, tile_column, bottom_line);
+            }
+            else {
+                std::string& tile{ renderer.add_cell(frame_line, tile_column) };
+                tile += ' ';
+                tile += column == 8 ? last_column_separator : " ";
+            }
         }
-        std::cout << (chosen_font == font::MS_Gothic ? u8"▏▏" : u8"│");
+
+        std::string& side_panel{ renderer.add_cell(frame_line, first_tile_column + 8 * tile_width) };
+        side_panel += chosen_font == font::MS_Gothic ? u8"▏▏" : u8"│";
         int moves_per_line{};
-        while (moves_history_index <= moves_history.size()) {
-            std::cout << '\t' << moves_history_index << "." << moves_history.at(moves_history_index - 1);
+        while (moves_history_index <= moves_history.size()) { //show as many as 4 moves in this line
+            side_panel += '\t';
+            side_panel += std::to_string(moves_history_index);
+            side_panel += '.';
+            side_panel += moves_history.at(moves_history_index - 1);
             moves_history_index++;
             moves_per_line++;
             if (moves_per_line == 4) {
                 break;
             }
         }
-        while (5 - moves_per_line > 0) {
-            std::cout << "\t";
+        while (5 - moves_per_line > 0) { //leave some space to show the cemetery next to the moves
+            side_panel += '\t';
             moves_per_line++;
         }
-        std::cout << " ";
+        side_panel += ' ';
         for (const auto& captured_piece : cemetery) {
-            if (row == 8 && captured_piece->get_symbol() != piece_symbol::pawn && captured_piece->get_colour() == piece_colour::black) {
-                std::cout << captured_piece->get_symbol_string(false) << " ";
-            }
-            else if (row == 7 && captured_piece->get_symbol() == piece_symbol::pawn && captured_piece->get_colour() == piece_colour::black) {
-                std::cout << captured_piece->get_symbol_string(false) << " ";
-            }
-            else if (row == 2 && captured_piece->get_symbol() == piece_symbol::pawn && captured_piece->get_colour() == piece_colour::white) {
-                std::cout << captured_piece->get_symbol_string(false) << " ";
-            }
-            else if (row == 1 && captured_piece->get_symbol() != piece_symbol::pawn && captured_piece->get_colour() == piece_colour::white) {
-                std::cout << captured_piece->get_symbol_string(false) << " ";
+            //Show the captured pieces in the same row as their initial row in the board
+            //This is 7 and 2 for the black and white pawns respectively, and 8 and 1 for the other type of pieces of black and white colour respectively
+            bool is_pawn{ captured_piece->get_symbol() == piece_symbol::pawn };
+            bool is_black{ captured_piece->get_colour() == piece_colour::black };
+            if ((row == 8 && !is_pawn && is_black) || (row == 7 && is_pawn && is_black) ||
+                (row == 2 && is_pawn && !is_black) || (row == 1 && !is_pawn && !is_black)) {
+                side_panel += captured_piece->get_symbol_string(false);
+                side_panel += ' ';
             }
         }
-        std::cout << std::endl;
     }
 
-    std::cout << " " << bottom_left_corner;
+    std::string& bottom_border{ renderer.add_cell(10, 1) };
+    bottom_border += ' ';
+    bottom_border += bottom_left_corner;
     for (size_t i{}; i < 8; i++) {
-        std::cout << board_symbols.at({ chosen_font,"line" });
+        bottom_border += line;
     }
-    std::cout << board_symbols.at({ chosen_font,"small_line" }) << bottom_right_corner;
-    std::cout << std::endl;
+    bottom_border += small_line;
+    bottom_border += bottom_right_corner;
 
-    std::cout << "   ";
+    std::string& bottom_letters{ renderer.add_cell(11, 1) };
+    bottom_letters += "   ";
     for (size_t letter_index{}; letter_index < 8; letter_index++) {
-        std::cout << coordinates::alphabetical_string[letter_index] << " ";
+        bottom_letters += coordinates::alphabetical_string[letter_index];
+        bottom_letters += ' ';
     }
-    std::cout << std::endl << std::endl;
-}
\ No newline at end of file
+}
@@ -2,8 +2,8 @@
 //This code contains the implementation of functions used to convert from location in 8x8 board matrix to 1D array and viceversa.
 
 #include "coordinate_transforms.h"
-#include <iostream>
-#include <map>
+#include <stdexcept>
+#include <utility>
 
 namespace coordinates {
     const bool in_board_range(const int& location) {
@@ -14,13 +14,7 @@ namespace coordinates {
 
     int flatten_board_coordinates(const std::pair<char, int>& board_coordinates) {
         
-        int matrix_column{};
-        try {
-            matrix_column = alphabetical_dictionary.at(board_coordinates.first);
-        }
-        catch (const std::out_of_range&) {
-            throw std::out_of_range("Error: column must be a letter between 'a' and 'h'.");
-        }
+        int matrix_column{ column_number(board_coordinates.first) };
         int matrix_row{ board_coordinates.second };
         if (matrix_row < 1 || matrix_row > 8) {
             throw std::out_of_range("Error: row must be a number between 1 and 8.");
@@ -37,7 +31,7 @@ namespace coordinates {
         int remainder{ location % 8 };
         int row{ remainder ? int_division + 1 : int_division };
         int column{ remainder ? remainder : 8 };
-        board_coordinates.first = numerical_dictionary.at(column);
+        board_coordinates.first = column_letter(column);
         board_coordinates.second = row;
         return board_coordinates;
     }
@@ -0,0 +1,93 @@
+/*
+This file contains the implementation of the static evaluation.
+*/
+
+#include "evaluation.h"
+#include "piece_square_tables.h"
+#include "position.h"
+#include "enum_attributes.h"
+#include <algorithm>
+#include <array>
+
+namespace {
+    //Mobility bonus per move above (or penalty per move below) a typical number of moves, indexed by piece_symbol
+    constexpr std::array<int, 6> mobility_weight{ 0, 2, 4, 5, 0, 1 };
+    constexpr std::array<int, 6> typical_mobility{ 0, 7, 4, 7, 0, 14 };
+
+    constexpr int attacked_king_square_penalty{ 12 };
+    constexpr int pawn_shelter_bonus{ 10 };
+
+    //Blend of the middlegame and endgame values according to the phase of the game
+    int taper(const int& middlegame, const int& endgame, const int& phase) {
+        int clamped_phase{ std::min(phase, evaluation_tables::max_phase) };
+        return (middlegame * clamped_phase + endgame * (evaluation_tables::max_phase - clamped_phase)) / evaluation_tables::max_phase;
+    }
+}
+
+namespace evaluation {
+    int material_pst(const position& game_position, const piece_colour& colour) {
+        const material_pst_score& score{ game_position.get_material_pst() };
+        int white_score{ taper(score.middlegame, score.endgame, score.phase) };
+        return (colour == piece_colour::white) ? white_score : -white_score;
+    }
+
+    int mobility(const position& game_position, const piece_colour& colour) {
+        move_list piece_moves;
+        int score{};
+        for (int square{}; square < 64; square++) {
+            std::uint8_t code{ game_position.get_square(square) };
+            if (code == piece_code::empty || piece_code::colour_of(code) != colour) {
+                continue;
+            }
+            int symbol{ static_cast<int>(piece_code::symbol_of(code)) };
+            if (mobility_weight[symbol] == 0) {
+                continue;
+            }
+            piece_moves.clear();
+            game_position.generate_piece_moves(square, piece_moves);
+            score += mobility_weight[symbol] * (static_cast<int>(piece_moves.size()) - typical_mobility[symbol]);
+        }
+        return score;
+    }
+
+    int king_safety(const position& game_position, const piece_colour& colour) {
+        int king_square{ game_position.get_king_square(colour) };
+        int king_column{ king_square % 8 };
+        int king_row{ king_square / 8 };
+        int forward{ colour == piece_colour::white ? 1 : -1 };
+        std::uint8_t own_pawn{ piece_code::make(colour, piece_symbol::pawn) };
+        int score{};
+        for (int column{ std::max(0, king_column - 1) }; column <= std::min(7, king_column + 1); column++) {
+            for (int row{ std::max(0, king_row - 1) }; row <= std::min(7, king_row + 1); row++) {
+                if (game_position.is_attacked(8 * row + column, opposite_colour(colour))) {
+                    score -= attacked_king_square_penalty;
+                }
+            }
+            int shelter_row{ king_row + forward };
+            if (0 <= shelter_row && shelter_row < 8 && game_position.get_square(8 * shelter_row + column) == own_pawn) {
+                score += pawn_shelter_bonus;
+            }
+        }
+        //King safety only matters while there is enough material left to attack the king
+        return score * std::min(game_position.get_material_pst().phase, evaluation_tables::max_phase) / evaluation_tables::max_phase;
+    }
+
+    int evaluate(const position& game_position) {
+        piece_colour colour{ game_position.get_colour_turn() };
+        piece_colour colour_opposite{ opposite_colour(colour) };
+        return material_pst(game_position, colour)
+            + mobility(game_position, colour) - mobility(game_position, colour_opposite)
+            + king_safety(game_position, colour) - king_safety(game_position, colour_opposite);
+    }
+
+    material_pst_score material_pst_from_scratch(const position& game_position) {
+        material_pst_score score;
+        for (int square{}; square < 64; square++) {
+            const evaluation_tables::square_value& value{ evaluation_tables::square_values[game_position.get_square(square)][square] };
+            score.middlegame += value.middlegame;
+            score.endgame += value.endgame;
+            score.phase += value.phase;
+        }
+        return score;
+    }
+}
@@ -0,0 +1,204 @@
+/*
+This file contains the implementation of the frame renderer.
+*/
+
+#include "frame_renderer.h"
+#include "console_visualisation.h"
+#include <charconv>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    //ANSI colours matching the console attributes of font_colour (foreground, then background if any)
+    std::string_view ansi_colour(const font_colour& colour) noexcept {
+        switch (colour) {
+        case font_colour::green: return "\x1b[92m";
+        case font_colour::green_white_back: return "\x1b[92;107m";
+        case font_colour::red: return "\x1b[91m";
+        case font_colour::red_white_back: return "\x1b[91;107m";
+        case font_colour::black_white_back: return "\x1b[30;107m";
+        default: return "";
+        }
+    }
+
+    void append_number(std::string& text, const size_t& number) {
+        char digits[20];
+        auto result{ std::to_chars(digits, digits + sizeof(digits), number) };
+        text.append(digits, result.ptr);
+    }
+
+    void append_cursor_position(std::string& text, const size_t& line, const int& column) {
+        text += "\x1b[";
+        append_number(text, line + 1);
+        text += ';';
+        append_number(text, static_cast<size_t>(column));
+        text += 'H';
+    }
+
+    bool same_cell(const frame_cell& lhs, const frame_cell& rhs) noexcept {
+        return lhs.column == rhs.column && lhs.colour == rhs.colour && lhs.text == rhs.text;
+    }
+
+    //Visible rows and columns of the console, or a common size if the output is not a console
+    void get_console_size(size_t& rows, size_t& columns) noexcept {
+        rows = 24;
+        columns = 80;
+#ifdef _WIN32
+        CONSOLE_SCREEN_BUFFER_INFO info{};
+        if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+            rows = static_cast<size_t>(info.srWindow.Bottom - info.srWindow.Top + 1);
+            columns = static_cast<size_t>(info.srWindow.Right - info.srWindow.Left + 1);
+        }
+#else
+        winsize size{};
+        if (::ioctl(1, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0) {
+            rows = size.ws_row;
+            columns = size.ws_col;
+        }
+#endif
+    }
+
+    void write_all(const std::string& bytes) {
+        size_t written{};
+        while (written < bytes.size()) {
+#ifdef _WIN32
+            int result{ _write(1, bytes.data() + written, static_cast<unsigned int>(bytes.size() - written)) };
+#else
+            ssize_t result{ ::write(1, bytes.data() + written, bytes.size() - written) };
+#endif
+            if (result <= 0) {
+                return;
+            }
+            written += static_cast<size_t>(result);
+        }
+    }
+}
+
+frame_renderer::frame_renderer() {
+    output.reserve(16384);
+#ifdef _WIN32
+    //Let the console interpret the ANSI escape sequences
+    HANDLE console{ GetStdHandle(STD_OUTPUT_HANDLE) };
+    DWORD mode{};
+    if (GetConsoleMode(console, &mode)) {
+        SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
+#endif
+}
+
+void frame_renderer::begin_frame(const size_t& number_of_lines) {
+    if (current_frame.size() < number_of_lines) {
+        current_frame.resize(number_of_lines);
+    }
+    current_cells_per_line.assign(number_of_lines, 0);
+}
+
+std::string& frame_renderer::add_cell(const size_t& line, const int& column, const font_colour& colour) {
+    std::vector<frame_cell>& cells{ current_frame[line] };
+    size_t& number_of_cells{ current_cells_per_line[line] };
+    if (number_of_cells == cells.size()) {
+        cells.emplace_back();
+    }
+    frame_cell& cell{ cells[number_of_cells++] };
+    cell.text.clear(); //keeps the capacity of the cell drawn two frames ago
+    cell.colour = colour;
+    cell.column = column;
+    return cell.text;
+}
+
+void frame_renderer::add_cell(const size_t& line, const int& column, std::string_view text, const font_colour& colour) {
+    add_cell(line, column, colour).append(text);
+}
+
+const std::string& frame_renderer::render() {
+    output.clear();
+    size_t number_of_lines{ current_cells_per_line.size() };
+    size_t rows;
+    size_t columns;
+    get_console_size(rows, columns);
+    //The last frame left the cursor on the second row below it, and the console scrolls once the text printed since
+    //goes past its last row
+    bool scrolled{ number_of_lines + 1 + rows_printed_below >= rows };
+    bool resized{ rows != console_rows || columns != console_columns };
+    console_rows = rows;
+    console_columns = columns;
+    bool redraw_all{ full_redraw || scrolled || resized || previous_cells_per_line.size() != number_of_lines };
+    if (redraw_all) {
+        output += "\x1b[H\x1b[2J"; //cursor home and clear the screen
+    }
+    for (size_t line{}; line < number_of_lines; line++) {
+        size_t number_of_cells{ current_cells_per_line[line] };
+        //If the line does not have the same cells as before, it is drawn again
+        bool redraw_line{ redraw_all || previous_cells_per_line[line] != number_of_cells };
+        for (size_t index{}; index < number_of_cells; index++) {
+            const frame_cell& cell{ current_frame[line][index] };
+            if (!redraw_line && same_cell(cell, previous_frame[line][index])) {
+                continue;
+            }
+            append_cursor_position(output, line, cell.column);
+            if (index + 1 == number_of_cells) {
+                output += "\x1b[K"; //the last cell may be shorter than before, and tabs do not overwrite
+            }
+            std::string_view colour_sequence{ ansi_colour(cell.colour) };
+            output += colour_sequence;
+            output += cell.text;
+            if (!colour_sequence.empty()) {
+                output += "\x1b[0m";
+            }
+        }
+    }
+    //Leave the cursor one blank line below the frame and clear whatever was printed there after the last frame
+    append_cursor_position(output, number_of_lines, 1);
+    output += "\x1b[J\n";
+
+    std::swap(current_frame, previous_frame);
+    std::swap(current_cells_per_line, previous_cells_per_line);
+    full_redraw = false;
+    rows_printed_below = 0;
+    printed_column = 0;
+    return output;
+}
+
+void frame_renderer::count_printed_text(std::string_view text) noexcept {
+    for (const char& character : text) {
+        unsigned char byte{ static_cast<unsigned char>(character) };
+        if (byte == '\n') {
+            rows_printed_below++;
+            printed_column = 0;
+            continue;
+        }
+        if (byte == '\r') {
+            printed_column = 0;
+            continue;
+        }
+        if (byte == '\t') {
+            printed_column = (printed_column / 8 + 1) * 8;
+        }
+        else if ((byte & 0xC0) != 0x80) { //one column per character, not per byte of a UTF-8 sequence
+            printed_column++;
+        }
+        //Escape sequences are counted as text too, which only makes the count err on the side of a full redraw
+        if (console_columns > 0 && printed_column >= console_columns) {
+            rows_printed_below++;
+            printed_column = 0;
+        }
+    }
+}
+
+void frame_renderer::present() {
+    render();
+    //The text printed before must reach the console before the frame. std::cout is synchronised with stdio, so this also
+    //covers what was printed through it
+    std::fflush(stdout);
+    write_all(output);
+}
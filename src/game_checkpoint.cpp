@@ -0,0 +1,120 @@
+/*
+This file contains the implementation of the game checkpoint. See game_checkpoint.h
+*/
+
+#include "game_checkpoint.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+    constexpr size_t page_size{ 4096 };
+    //Each snapshot starts at a page, so that writing one never touches the pages of the other
+    constexpr size_t snapshot_stride{ (sizeof(game_snapshot) + page_size - 1) / page_size * page_size };
+
+    //Bytes of a snapshot covered by its checksum: from the sequence to the last move stored, skipping the checksum itself
+    size_t used_size(const game_snapshot& snapshot) noexcept {
+        size_t number_of_moves{ std::min<size_t>(snapshot.number_of_moves, game_snapshot::max_moves) };
+        return offsetof(game_snapshot, moves) + number_of_moves * sizeof(session_move);
+    }
+
+    std::uint64_t compute_checksum(const game_snapshot& snapshot) noexcept {
+        const unsigned char* bytes{ reinterpret_cast<const unsigned char*>(&snapshot) };
+        size_t size{ used_size(snapshot) };
+        std::uint64_t checksum{ 0x9e3779b97f4a7c15ull ^ size };
+        auto mix = [&checksum](std::uint64_t word) {
+            word *= 0xbf58476d1ce4e5b9ull;
+            word ^= word >> 31;
+            checksum = (checksum ^ word) * 0x94d049bb133111ebull;
+        };
+        std::uint64_t sequence;
+        std::memcpy(&sequence, bytes + offsetof(game_snapshot, sequence), sizeof(sequence));
+        mix(sequence);
+        size_t offset{ offsetof(game_snapshot, checksum) + sizeof(std::uint64_t) };
+        for (; offset + 8 <= size; offset += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + offset, 8);
+            mix(word);
+        }
+        if (offset < size) {
+            std::uint64_t word{};
+            std::memcpy(&word, bytes + offset, size - offset);
+            mix(word);
+        }
+        return checksum ^ (checksum >> 29);
+    }
+
+    bool is_complete(const game_snapshot& snapshot) noexcept {
+        return snapshot.sequence != 0 && snapshot.format == game_snapshot::current_format &&
+            snapshot.number_of_moves <= game_snapshot::max_moves && snapshot.checksum == compute_checksum(snapshot);
+    }
+}
+
+checkpoint_file::checkpoint_file(const std::string& path, const bool& synchronous_in)
+    : file{ path, mapped_file::access::read_write, file_size() }, synchronous{ synchronous_in }
+{
+    if (file.get_status() == mapped_file::status::not_opened) {
+        throw std::runtime_error("Error: could not open the checkpoint file " + path + ".");
+    }
+    if (file.get_status() != mapped_file::status::mapped) {
+        throw std::runtime_error("Error: " + path + " is not a checkpoint file or could not be mapped.");
+    }
+    const game_snapshot* last_snapshot{ get_last_snapshot() };
+    last_sequence = last_snapshot ? last_snapshot->sequence : 0;
+}
+
+checkpoint_file::checkpoint_file(checkpoint_file&& other) noexcept {
+    *this = std::move(other);
+}
+
+checkpoint_file& checkpoint_file::operator=(checkpoint_file&& other) noexcept {
+    if (this != &other) {
+        std::swap(file, other.file);
+        std::swap(last_sequence, other.last_sequence);
+        std::swap(synchronous, other.synchronous);
+    }
+    return *this;
+}
+
+size_t checkpoint_file::file_size() noexcept {
+    return 2 * snapshot_stride;
+}
+
+game_snapshot& checkpoint_file::get_snapshot(const std::uint64_t& sequence) const noexcept {
+    return *reinterpret_cast<game_snapshot*>(static_cast<unsigned char*>(file.data()) + (sequence & 1) * snapshot_stride);
+}
+
+const game_snapshot* checkpoint_file::get_last_snapshot() const noexcept {
+    const game_snapshot* last_snapshot{ nullptr };
+    for (std::uint64_t slot{}; slot < 2; slot++) {
+        const game_snapshot& snapshot{ get_snapshot(slot) };
+        if (is_complete(snapshot) && (!last_snapshot || snapshot.sequence > last_snapshot->sequence)) {
+            last_snapshot = &snapshot;
+        }
+    }
+    return last_snapshot;
+}
+
+void checkpoint_file::save(const game_session& session) {
+    std::uint64_t sequence{ last_sequence + 1 };
+    game_snapshot& snapshot{ get_snapshot(sequence) };
+    //Invalid until it is complete. The fences keep the compiler and the processor from moving the writes of the
+    //snapshot before this one or after the final sequence
+    snapshot.sequence = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    session.save(snapshot);
+    std::atomic_thread_fence(std::memory_order_release);
+    //The checksum covers the final sequence, so a snapshot whose sequence was written but not its checksum is rejected
+    snapshot.sequence = sequence;
+    snapshot.checksum = compute_checksum(snapshot);
+    std::atomic_thread_fence(std::memory_order_release);
+    if (synchronous) {
+        file.flush(); //only the pages written since the last save go to the disk
+    }
+    last_sequence = sequence;
+}
@@ -0,0 +1,559 @@
+/*
+This file contains the definition of the game server class. See game_server.h
+*/
+
+#include "game_server.h"
+#include "coordinate_transforms.h"
+#include "game_checkpoint.h"
+#include "position.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string_view>
+#include <stdexcept>
+#include <utility>
+
+#ifdef __linux__
+#include <cerrno>
+#include <dirent.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr size_t max_line_length{ 256 };
+    constexpr size_t latency_samples{ 1 << 16 };
+    constexpr std::uint64_t listen_key{ 0 };
+    constexpr std::uint64_t wake_key{ 1 };
+
+    std::vector<std::string> split_words(const std::string& line) {
+        std::vector<std::string> words;
+        size_t start{ line.find_first_not_of(" \t") };
+        while (start != std::string::npos) {
+            size_t end{ line.find_first_of(" \t", start) };
+            words.push_back(line.substr(start, end - start));
+            start = line.find_first_not_of(" \t", end);
+        }
+        return words;
+    }
+
+    //Location from 1 to 64 of a square such as e2. It throws std::out_of_range if it is not on the board
+    int parse_square(const std::string& square) {
+        if (square.size() != 2 || square[1] < '1' || square[1] > '8') {
+            throw std::out_of_range("Invalid square " + square);
+        }
+        return coordinates::flatten_board_coordinates({ square[0], square[1] - '0' });
+    }
+
+    //Ply of a game, a number from 0. It throws std::invalid_argument if it is not one
+    size_t parse_ply(const std::string& text) {
+        if (text.empty() || text.size() > 5 || text.find_first_not_of("0123456789") != std::string::npos) {
+            throw std::invalid_argument("Invalid ply " + text);
+        }
+        return static_cast<size_t>(std::stoul(text));
+    }
+
+    void append_state(std::string& text, const game_session& game) {
+        text += ' ';
+        text += game_session::state_string(game.get_state());
+        if (game.in_check()) {
+            text += " check";
+        }
+    }
+
+    void append_square(std::string& text, const int& location) {
+        std::pair<char, int> square{ coordinates::to_board_coordinates(location) };
+        text += square.first;
+        text += static_cast<char>('0' + square.second);
+    }
+
+    //Run a command on a game and return its answer (without the leading "ok <game>")
+    std::string run_command(game_session& game, const tablebase& endgame_tablebase, const std::vector<std::string>& words) {
+        std::string answer;
+        if (words[0] == "select" && words.size() == 3) {
+            for (const int& location : game.get_piece_allowed_moves(parse_square(words[2]))) {
+                answer += ' ';
+                append_square(answer, location);
+            }
+        }
+        else if (words[0] == "moves" && words.size() == 2) {
+            for (const board_move& move : game.get_all_allowed_moves()) {
+                answer += ' ';
+                append_square(answer, move.from);
+                append_square(answer, move.to);
+            }
+        }
+        else if (words[0] == "move" && words.size() == 4) {
+            game.make_move(parse_square(words[2]), parse_square(words[3]));
+            game.check_tablebase(endgame_tablebase);
+            append_state(answer, game);
+        }
+        else if ((words[0] == "takeback" && (words.size() == 2 || words.size() == 3)) || (words[0] == "goto" && words.size() == 3)) {
+            if (words[0] == "takeback") {
+                game.take_back(words.size() == 3 ? parse_ply(words[2]) : 1);
+            }
+            else {
+                game.go_to_ply(parse_ply(words[2]));
+            }
+            game.check_tablebase(endgame_tablebase);
+            answer += ' ';
+            answer += std::to_string(game.get_ply());
+            append_state(answer, game);
+        }
+        else if (words[0] == "fen" && words.size() == 2) {
+            answer += ' ';
+            answer += game.get_board().to_position(game.get_colour_turn()).to_fen();
+        }
+        else {
+            throw std::invalid_argument("Wrong number of arguments");
+        }
+        return answer;
+    }
+
+    size_t resident_memory_kib() {
+        size_t resident_pages{};
+#ifdef __linux__
+        std::FILE* statm{ std::fopen("/proc/self/statm", "r") };
+        if (statm) {
+            size_t total_pages{};
+            if (std::fscanf(statm, "%zu %zu", &total_pages, &resident_pages) != 2) {
+                resident_pages = 0;
+            }
+            std::fclose(statm);
+        }
+        return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+#else
+        return resident_pages;
+#endif
+    }
+}
+
+struct game_server::request {
+    std::uint64_t connection_id{};
+    std::vector<std::string> words;
+    std::chrono::steady_clock::time_point received;
+};
+
+struct game_server::session_slot {
+    game_session game;
+    std::unique_ptr<checkpoint_file> checkpoint; //saved after every move if the server has a checkpoint directory
+    std::deque<request> queued_commands;
+    bool running{ false }; //a command of the game is on the thread pool, so only the worker may touch the game
+
+    session_slot() = default;
+    session_slot(game_session&& restored_game) : game{ std::move(restored_game) } {}
+};
+
+struct game_server::connection {
+    int fd{ -1 };
+    std::uint64_t id{};
+    std::string read_buffer;
+    std::string write_buffer;
+    bool waiting_to_write{ false }; //EPOLLOUT is registered
+};
+
+#ifdef __linux__
+game_server::game_server(const std::string& socket_path_in, thread_pool& pool_in, const std::string& checkpoint_directory_in)
+    : pool{ pool_in }, socket_path{ socket_path_in }, checkpoint_directory{ checkpoint_directory_in }
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("The socket path " + socket_path + " is too long");
+    }
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+    endgame_tablebase.generate_all(3, pool);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    unlink(socket_path.c_str());
+    if (listen_fd < 0 || epoll_fd < 0 || wake_fd < 0 ||
+        bind(listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listen_fd, SOMAXCONN) != 0) {
+        std::string error{ std::strerror(errno) };
+        for (int fd : { listen_fd, epoll_fd, wake_fd }) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        throw std::runtime_error("Could not listen on " + socket_path + ": " + error);
+    }
+    epoll_event listen_event{};
+    listen_event.events = EPOLLIN;
+    listen_event.data.u64 = listen_key;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &listen_event);
+    epoll_event wake_event{};
+    wake_event.events = EPOLLIN;
+    wake_event.data.u64 = wake_key;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &wake_event);
+    move_latencies_us.reserve(latency_samples);
+}
+
+game_server::~game_server() {
+    for (auto& connection_pair : connections) {
+        close(connection_pair.second->fd);
+    }
+    connections.clear();
+    for (int* fd : { &listen_fd, &epoll_fd, &wake_fd }) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+    if (!socket_path.empty()) {
+        unlink(socket_path.c_str());
+        socket_path.clear();
+    }
+}
+
+size_t game_server::resume_games() {
+    size_t restored_games{};
+    DIR* directory{ checkpoint_directory.empty() ? nullptr : opendir(checkpoint_directory.c_str()) };
+    if (!directory) {
+        return 0;
+    }
+    constexpr std::string_view extension{ ".checkpoint" };
+    while (dirent* entry{ readdir(directory) }) {
+        std::string name{ entry->d_name };
+        if (name.size() <= extension.size() || name.compare(name.size() - extension.size(), extension.size(), extension) != 0 ||
+            name.find_first_not_of("0123456789") != name.size() - extension.size()) {
+            continue;
+        }
+        std::uint32_t session_id{ static_cast<std::uint32_t>(std::strtoul(name.c_str(), nullptr, 10)) };
+        try {
+            auto checkpoint{ std::make_unique<checkpoint_file>(checkpoint_directory + '/' + name) };
+            const game_snapshot* snapshot{ checkpoint->get_last_snapshot() };
+            if (!snapshot || session_id == 0 || sessions.count(session_id)) {
+                continue;
+            }
+            auto slot{ std::make_unique<session_slot>(game_session{ *snapshot }) };
+            slot->checkpoint = std::move(checkpoint);
+            sessions.emplace(session_id, std::move(slot));
+            next_session_id = std::max(next_session_id, session_id + 1);
+            restored_games++;
+        }
+        catch (const std::exception&) {
+            continue; //not a checkpoint of this version, or not a valid game
+        }
+    }
+    closedir(directory);
+    return restored_games;
+}
+
+void game_server::stop() noexcept {
+    stopping = true;
+    std::uint64_t one{ 1 };
+    [[maybe_unused]] ssize_t written{ write(wake_fd, &one, sizeof(one)) };
+}
+
+void game_server::run() {
+    std::vector<epoll_event> events(256);
+    while (!stopping || commands_in_flight > 0) {
+        int number_of_events{ epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), -1) };
+        if (number_of_events < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string{ "epoll_wait failed: " } + std::strerror(errno));
+        }
+        for (int event_index{}; event_index < number_of_events; event_index++) {
+            const epoll_event& event{ events[event_index] };
+            if (event.data.u64 == listen_key) {
+                accept_connections();
+                continue;
+            }
+            if (event.data.u64 == wake_key) {
+                std::uint64_t count;
+                while (read(wake_fd, &count, sizeof(count)) > 0) {}
+                handle_completions();
+                continue;
+            }
+            auto found{ connections.find(event.data.u64) };
+            if (found == connections.end()) {
+                continue; //closed by an earlier event of this batch
+            }
+            connection& client{ *found->second };
+            if (event.events & EPOLLOUT) {
+                write_connection(client);
+            }
+            if (event.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                read_connection(client); //may close the connection
+            }
+        }
+    }
+}
+
+void game_server::accept_connections() {
+    while (true) {
+        int client_fd{ accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC) };
+        if (client_fd < 0) {
+            return; //EAGAIN once every pending connection was accepted, or an error of a single connection
+        }
+        auto client{ std::make_unique<connection>() };
+        client->fd = client_fd;
+        client->id = next_connection_id++;
+        epoll_event client_event{};
+        client_event.events = EPOLLIN | EPOLLRDHUP;
+        client_event.data.u64 = client->id;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_fd, &client_event) != 0) {
+            close(client_fd);
+            continue;
+        }
+        connections.emplace(client->id, std::move(client));
+    }
+}
+
+void game_server::read_connection(connection& client) {
+    char buffer[4096];
+    bool peer_closed{ false };
+    while (!peer_closed) {
+        ssize_t bytes_read{ recv(client.fd, buffer, sizeof(buffer), 0) };
+        if (bytes_read > 0) {
+            client.read_buffer.append(buffer, static_cast<size_t>(bytes_read));
+            continue;
+        }
+        if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (bytes_read < 0 && errno == EINTR) {
+            continue;
+        }
+        peer_closed = true; //closed by the client or failed
+    }
+    size_t line_start{};
+    size_t line_end;
+    std::uint64_t connection_id{ client.id };
+    while ((line_end = client.read_buffer.find('\n', line_start)) != std::string::npos) {
+        std::string line{ client.read_buffer.substr(line_start, line_end - line_start) };
+        line_start = line_end + 1;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        handle_line(client, line);
+        if (connections.count(connection_id) == 0) {
+            return; //the client quit
+        }
+    }
+    client.read_buffer.erase(0, line_start);
+    if (peer_closed || client.read_buffer.size() > max_line_length) {
+        close_connection(client.id);
+    }
+}
+
+void game_server::write_connection(connection& client) {
+    size_t written_total{};
+    while (written_total < client.write_buffer.size()) {
+        ssize_t written{ send(client.fd, client.write_buffer.data() + written_total, client.write_buffer.size() - written_total, MSG_NOSIGNAL) };
+        if (written > 0) {
+            written_total += static_cast<size_t>(written);
+        }
+        else if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        else {
+            break;
+        }
+    }
+    client.write_buffer.erase(0, written_total);
+    bool must_wait{ !client.write_buffer.empty() };
+    if (must_wait != client.waiting_to_write) {
+        epoll_event client_event{};
+        client_event.events = EPOLLIN | EPOLLRDHUP | (must_wait ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+        client_event.data.u64 = client.id;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, client.fd, &client_event);
+        client.waiting_to_write = must_wait;
+    }
+}
+
+void game_server::close_connection(const std::uint64_t& connection_id) {
+    auto found{ connections.find(connection_id) };
+    if (found == connections.end()) {
+        return;
+    }
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, found->second->fd, nullptr);
+    close(found->second->fd);
+    connections.erase(found);
+}
+#else
+game_server::game_server(const std::string& socket_path_in, thread_pool& pool_in, const std::string& checkpoint_directory_in)
+    : pool{ pool_in }, socket_path{ socket_path_in }, checkpoint_directory{ checkpoint_directory_in }
+{
+    throw std::runtime_error("The game server is only supported on Linux");
+}
+
+game_server::~game_server() {}
+size_t game_server::resume_games() { return 0; }
+void game_server::stop() noexcept {}
+void game_server::run() {}
+void game_server::accept_connections() {}
+void game_server::read_connection(connection&) {}
+void game_server::write_connection(connection&) {}
+void game_server::close_connection(const std::uint64_t&) {}
+#endif
+
+void game_server::send_answer(const std::uint64_t& connection_id, const std::string& answer) {
+    auto found{ connections.find(connection_id) };
+    if (found == connections.end()) {
+        return; //the client left before its answer was ready
+    }
+    connection& client{ *found->second };
+    client.write_buffer += answer;
+    client.write_buffer += '\n';
+    if (!client.waiting_to_write) {
+        write_connection(client);
+    }
+}
+
+void game_server::handle_line(connection& client, const std::string& line) {
+    std::vector<std::string> words{ split_words(line) };
+    if (words.empty()) {
+        return;
+    }
+    if (words[0] == "quit") {
+        close_connection(client.id);
+        return;
+    }
+    if (words[0] == "stats") {
+        send_answer(client.id, stats_answer());
+        return;
+    }
+    if (words[0] == "new") {
+        std::uint32_t session_id{ next_session_id++ };
+        try {
+            auto slot{ std::make_unique<session_slot>() };
+            if (!checkpoint_directory.empty()) {
+                slot->checkpoint = std::make_unique<checkpoint_file>(checkpoint_path(session_id));
+                slot->checkpoint->save(slot->game);
+            }
+            sessions.emplace(session_id, std::move(slot));
+        }
+        catch (const std::exception& session_err) {
+            send_answer(client.id, std::string{ "error " } + session_err.what());
+            return;
+        }
+        send_answer(client.id, "ok " + std::to_string(session_id));
+        return;
+    }
+    if (words.size() < 2) {
+        send_answer(client.id, "error Unknown command " + words[0]);
+        return;
+    }
+    std::uint32_t session_id{ static_cast<std::uint32_t>(std::strtoul(words[1].c_str(), nullptr, 10)) };
+    auto found{ sessions.find(session_id) };
+    if (found == sessions.end()) {
+        send_answer(client.id, "error " + words[1] + " No such game");
+        return;
+    }
+    found->second->queued_commands.push_back({ client.id, std::move(words), std::chrono::steady_clock::now() });
+    run_next_command(session_id);
+}
+
+void game_server::run_next_command(const std::uint32_t& session_id) {
+    auto found{ sessions.find(session_id) };
+    if (found == sessions.end()) {
+        return;
+    }
+    session_slot& slot{ *found->second };
+    while (!slot.running && !slot.queued_commands.empty()) {
+        request next{ std::move(slot.queued_commands.front()) };
+        slot.queued_commands.pop_front();
+        const std::string& command{ next.words[0] };
+        if (command == "close") {
+            //Commands sent after closing the game find no game
+            std::string prefix{ "error " + std::to_string(session_id) + " No such game" };
+            send_answer(next.connection_id, "ok " + std::to_string(session_id));
+            for (const request& dropped : slot.queued_commands) {
+                send_answer(dropped.connection_id, prefix);
+            }
+            bool saved{ slot.checkpoint != nullptr };
+            sessions.erase(found); //unmaps the checkpoint file
+            if (saved) {
+                std::remove(checkpoint_path(session_id).c_str());
+            }
+            return;
+        }
+        if (command != "select" && command != "moves" && command != "move" && command != "takeback" && command != "goto" && command != "fen") {
+            send_answer(next.connection_id, "error " + std::to_string(session_id) + " Unknown command " + command);
+            continue;
+        }
+        slot.running = true;
+        commands_in_flight++;
+        session_slot* running_slot{ &slot };
+        pool.submit([this, running_slot, session_id, command_request = std::move(next)]() {
+            completion finished{ session_id, command_request.connection_id, "ok " + std::to_string(session_id),
+                command_request.words[0] == "move", command_request.received };
+            try {
+                finished.answer += run_command(running_slot->game, endgame_tablebase, command_request.words);
+                const std::string& command{ command_request.words[0] };
+                if ((command == "move" || command == "takeback" || command == "goto") && running_slot->checkpoint) {
+                    running_slot->checkpoint->save(running_slot->game);
+                }
+            }
+            catch (const std::exception& command_err) {
+                finished.answer = "error " + std::to_string(session_id) + ' ' + command_err.what();
+                finished.is_move = false; //only the moves played count in the latencies
+            }
+            {
+                std::lock_guard<std::mutex> lock{ completions_mutex };
+                completions.push_back(std::move(finished));
+            }
+#ifdef __linux__
+            std::uint64_t one{ 1 };
+            [[maybe_unused]] ssize_t written{ write(wake_fd, &one, sizeof(one)) };
+#endif
+        });
+    }
+}
+
+void game_server::handle_completions() {
+    std::vector<completion> finished_commands;
+    {
+        std::lock_guard<std::mutex> lock{ completions_mutex };
+        finished_commands.swap(completions);
+    }
+    auto now{ std::chrono::steady_clock::now() };
+    for (completion& finished : finished_commands) {
+        commands_in_flight--;
+        if (finished.is_move) {
+            float latency{ std::chrono::duration<float, std::micro>(now - finished.received).count() };
+            if (move_latencies_us.size() < latency_samples) {
+                move_latencies_us.push_back(latency);
+            }
+            else {
+                move_latencies_us[moves_served % latency_samples] = latency;
+            }
+            moves_served++;
+        }
+        send_answer(finished.connection_id, finished.answer);
+        auto found{ sessions.find(finished.session_id) };
+        if (found != sessions.end()) {
+            found->second->running = false;
+            run_next_command(finished.session_id);
+        }
+    }
+}
+
+std::string game_server::checkpoint_path(const std::uint32_t& session_id) const {
+    return checkpoint_directory + '/' + std::to_string(session_id) + ".checkpoint";
+}
+
+std::string game_server::stats_answer() {
+    std::vector<float> sorted_latencies{ move_latencies_us };
+    std::sort(sorted_latencies.begin(), sorted_latencies.end());
+    auto percentile = [&sorted_latencies](const double& fraction) -> long {
+        if (sorted_latencies.empty()) {
+            return 0;
+        }
+        size_t index{ std::min(sorted_latencies.size() - 1, static_cast<size_t>(fraction * sorted_latencies.size())) };
+        return static_cast<long>(sorted_latencies[index]);
+    };
+    return "ok sessions=" + std::to_string(sessions.size()) + " connections=" + std::to_string(connections.size()) +
+        " moves=" + std::to_string(moves_served) + " move_latency_us_p50=" + std::to_string(percentile(0.5)) +
+        " move_latency_us_p99=" + std::to_string(percentile(0.99)) + " move_latency_us_max=" + std::to_string(percentile(1.0)) +
+        " rss_kib=" + std::to_string(resident_memory_kib());
+}
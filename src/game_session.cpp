@@ -0,0 +1,326 @@
+/*
+This file contains the definition of the game session class. See game_session.h
+*/
+
+#include "game_session.h"
+#include "coordinate_transforms.h"
+#include "game_checkpoint.h"
+#include "position.h"
+#include "tablebase.h"
+#include <algorithm>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+    //Positions restored in the history after going to a ply: more than the ones since the last capture or pawn move
+    //(the only ones that can repeat the current position), as a game ends at 100 of them
+    constexpr size_t recent_positions{ 128 };
+}
+
+game_session::game_session()
+    : gameboard{ std::make_unique<board>() }
+{
+    gameboard->record_position(piece_colour::white, true); //starting position, for the draws by repetition
+    record_ply(false);
+}
+
+game_session::game_session(const game_snapshot& snapshot) {
+    if (snapshot.format != game_snapshot::current_format || snapshot.colour_turn > 1 || snapshot.last_move > 64 ||
+        snapshot.state > static_cast<std::uint8_t>(game_state::king_captured) || snapshot.number_of_moves > game_snapshot::max_moves ||
+        snapshot.number_of_recent_positions == 0 || snapshot.number_of_recent_positions > game_snapshot::max_recent_positions) {
+        throw std::invalid_argument("Error: invalid game snapshot.");
+    }
+    gameboard = std::make_unique<board>(snapshot.squares);
+    colour_turn = snapshot.colour_turn ? piece_colour::black : piece_colour::white;
+    check = snapshot.check != 0;
+    last_move_check = snapshot.last_move_check != 0;
+    last_move = snapshot.last_move;
+    state = static_cast<game_state>(snapshot.state);
+    moves.assign(snapshot.moves.begin(), snapshot.moves.begin() + snapshot.number_of_moves);
+    current_ply = moves.size();
+    for (const session_move& move : moves) {
+        if (!coordinates::in_board_range(move.from) || !coordinates::in_board_range(move.to) || (move.moved_piece & 7) < 1 || (move.moved_piece & 7) > 6 ||
+            (move.captured_piece != piece_code::empty && ((move.captured_piece & 7) < 1 || (move.captured_piece & 7) > 6))) {
+            throw std::invalid_argument("Error: invalid move in the game snapshot.");
+        }
+        if (move.captured_piece != piece_code::empty) {
+            gameboard->add_to_cemetery(piece_code::colour_of(move.captured_piece), piece_code::symbol_of(move.captured_piece));
+        }
+        gameboard->store_move(piece_code::colour_of(move.moved_piece), piece_code::symbol_of(move.moved_piece),
+            coordinates::to_board_coordinates(move.to));
+    }
+    position_history history;
+    for (size_t index{}; index < snapshot.number_of_recent_positions; index++) {
+        history.push_with_halfmove_clock(snapshot.recent_hashes[index], snapshot.recent_halfmove_clocks[index]);
+    }
+    gameboard->set_history(history);
+}
+
+game_session::~game_session() = default;
+game_session::game_session(game_session&&) noexcept = default;
+game_session& game_session::operator=(game_session&&) noexcept = default;
+
+std::vector<board_move> game_session::get_all_allowed_moves() const {
+    return gameboard->get_all_pieces_allowed_moves(colour_turn, last_move_check, last_move);
+}
+
+std::vector<int> game_session::get_piece_allowed_moves(const int& location) const {
+    if (!coordinates::in_board_range(location) ||
+        static_cast<int>(gameboard->get_element(location)) != static_cast<int>(colour_turn)) {
+        throw std::invalid_argument("There is no piece of the colour turn at those coordinates!");
+    }
+    std::list<int> allowed_moves{ gameboard->get_piece_allowed_moves(coordinates::to_board_coordinates(location), last_move_check, last_move) };
+    return std::vector<int>(allowed_moves.begin(), allowed_moves.end());
+}
+
+std::vector<int> turn_moves::get_piece_allowed_moves(const int& location) const {
+    if (!coordinates::in_board_range(location)) {
+        return {};
+    }
+    std::vector<int> piece_moves;
+    for (int move{ piece_moves_begin[location] }; move < piece_moves_end[location]; move++) {
+        piece_moves.push_back(all_allowed_moves[move].to);
+    }
+    return piece_moves;
+}
+
+bool game_session::compute_turn_moves(turn_moves& moves, const std::atomic<bool>& cancelled) const {
+    moves.all_allowed_moves.clear();
+    moves.piece_moves_begin.fill(0);
+    moves.piece_moves_end.fill(0);
+    //Columns and then rows, the order of the pieces map of the board
+    for (int column{ 1 }; column <= 8; column++) {
+        for (int row{ 1 }; row <= 8; row++) {
+            if (cancelled.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            std::pair<char, int> piece_coords{ coordinates::column_letter(column), row };
+            int location{ coordinates::flatten_board_coordinates(piece_coords) };
+            if (static_cast<int>(gameboard->get_element(location)) != static_cast<int>(colour_turn)) {
+                continue;
+            }
+            moves.piece_moves_begin[location] = static_cast<std::uint8_t>(moves.all_allowed_moves.size());
+            for (const int& future_location : gameboard->get_piece_allowed_moves(piece_coords, last_move_check, last_move)) {
+                moves.all_allowed_moves.push_back({ location, future_location });
+            }
+            moves.piece_moves_end[location] = static_cast<std::uint8_t>(moves.all_allowed_moves.size());
+        }
+    }
+    return true;
+}
+
+void game_session::make_move(const int& from, const int& to, const turn_moves* allowed_moves) {
+    if (is_game_over()) {
+        throw std::invalid_argument("The game is over!");
+    }
+    std::vector<int> piece_moves{ allowed_moves ? allowed_moves->get_piece_allowed_moves(from) : get_piece_allowed_moves(from) };
+    if (!coordinates::in_board_range(to) || std::find(piece_moves.begin(), piece_moves.end(), to) == piece_moves.end()) {
+        throw std::invalid_argument("Could not set to specified location, move was not allowed.");
+    }
+    std::pair<char, int> new_piece_coords{ coordinates::to_board_coordinates(to) };
+    std::uint8_t captured_piece{ piece_code::empty };
+    if (static_cast<int>(gameboard->get_element(to)) == static_cast<int>(opposite_colour(colour_turn))) {
+        captured_piece = piece_code::make(opposite_colour(colour_turn), gameboard->get_piece_symbol(new_piece_coords));
+    }
+    session_move move{ static_cast<std::uint8_t>(from), static_cast<std::uint8_t>(to),
+        piece_code::make(colour_turn, gameboard->get_piece_symbol(coordinates::to_board_coordinates(from))), captured_piece };
+    if (current_ply < moves.size()) { //a new line after taking moves back
+        moves.resize(current_ply);
+        if (plies.size() > current_ply + 1) {
+            plies.resize(current_ply + 1);
+            snapshots.resize(current_ply / snapshot_interval + 1);
+        }
+    }
+    bool recording_plies{ plies.size() == current_ply + 1 };
+    play_on_board(move);
+    moves.push_back(move);
+    current_ply++;
+    colour_turn = opposite_colour(colour_turn);
+    if (captured_piece != piece_code::empty && piece_code::symbol_of(captured_piece) == piece_symbol::king) {
+        state = game_state::king_captured;
+    }
+    else {
+        check = gameboard->check_for_check(new_piece_coords, last_move_check);
+        last_move = to;
+        update_state();
+    }
+    if (recording_plies) {
+        record_ply(captured_piece != piece_code::empty);
+    }
+}
+
+void game_session::play_on_board(const session_move& move) {
+    std::pair<char, int> old_piece_coords{ coordinates::to_board_coordinates(move.from) };
+    std::pair<char, int> new_piece_coords{ coordinates::to_board_coordinates(move.to) };
+    board_occupation occupation_old_location{ gameboard->get_element(move.from) };
+    piece_colour moving_colour{ piece_code::colour_of(move.moved_piece) };
+    if (move.captured_piece != piece_code::empty) {
+        gameboard->capture_piece(new_piece_coords, moving_colour);
+    }
+    gameboard->set_piece_location(old_piece_coords, new_piece_coords);
+    gameboard->set_element(move.from) = board_occupation::empty;
+    gameboard->set_element(move.to) = occupation_old_location;
+    gameboard->store_move(new_piece_coords);
+    //Captures and pawn moves start the halfmove clock of the fifty-move rule again
+    gameboard->record_position(opposite_colour(moving_colour),
+        move.captured_piece != piece_code::empty || piece_code::symbol_of(move.moved_piece) == piece_symbol::pawn);
+}
+
+void game_session::record_ply(const bool& captured) {
+    const position_history& history{ gameboard->get_history() };
+    ply_record record;
+    record.hash = history.get_last_hash();
+    record.halfmove_clock = static_cast<std::uint16_t>(history.get_halfmove_clock());
+    record.number_of_captures = static_cast<std::uint8_t>(plies.empty() ? 0 : plies.back().number_of_captures + captured);
+    record.last_move = static_cast<std::uint8_t>(last_move);
+    record.check = check;
+    record.last_move_check = last_move_check;
+    record.state = state;
+    plies.push_back(record);
+    if (current_ply % snapshot_interval == 0) {
+        snapshots.push_back(gameboard->to_position(colour_turn).get_squares());
+    }
+}
+
+void game_session::restore_ply() {
+    const ply_record& record{ plies[current_ply] };
+    colour_turn = current_ply % 2 ? piece_colour::black : piece_colour::white;
+    check = record.check;
+    last_move_check = record.last_move_check;
+    last_move = record.last_move;
+    state = record.state;
+    position_history history;
+    for (size_t ply{ current_ply - std::min(current_ply, recent_positions - 1) }; ply <= current_ply; ply++) {
+        history.push_with_halfmove_clock(plies[ply].hash, plies[ply].halfmove_clock);
+    }
+    gameboard->set_history(history);
+}
+
+void game_session::prepare_navigation() {
+    if (plies.size() == moves.size() + 1) {
+        return;
+    }
+    //A restored game: it is played again from the start, once, to record its plies
+    game_state restored_state{ state };
+    game_session replayed_session;
+    for (size_t ply{}; ply < current_ply; ply++) {
+        replayed_session.make_move(moves[ply].from, moves[ply].to);
+    }
+    replayed_session.state = restored_state;
+    replayed_session.plies.back().state = restored_state;
+    *this = std::move(replayed_session);
+}
+
+void game_session::take_back_last_move() {
+    const session_move& move{ moves[current_ply - 1] };
+    gameboard->take_back_move(coordinates::to_board_coordinates(move.from), coordinates::to_board_coordinates(move.to),
+        move.captured_piece != piece_code::empty);
+    current_ply--;
+}
+
+void game_session::play_next_move() {
+    play_on_board(moves[current_ply]);
+    current_ply++;
+}
+
+void game_session::take_back(const size_t& number_of_plies) {
+    if (number_of_plies > current_ply) {
+        throw std::out_of_range("There are not so many moves to take back!");
+    }
+    go_to_ply(current_ply - number_of_plies);
+}
+
+void game_session::go_to_ply(const size_t& ply) {
+    if (ply > moves.size()) {
+        throw std::out_of_range("There is no such move in the game!");
+    }
+    prepare_navigation();
+    size_t snapshot_ply{ ply / snapshot_interval * snapshot_interval };
+    if (ply <= current_ply && current_ply - ply < snapshot_interval) {
+        while (current_ply > ply) {
+            take_back_last_move();
+        }
+    }
+    else if (ply >= current_ply && current_ply >= snapshot_ply) {
+        while (current_ply < ply) {
+            play_next_move();
+        }
+    }
+    else {
+        //From the nearest snapshot. The moves history and the cemetery are cut to the moves both plies share, and
+        //completed from the moves up to the snapshot
+        size_t common_ply{ std::min(current_ply, snapshot_ply) };
+        gameboard->truncate_moves_and_cemetery(common_ply, plies[common_ply].number_of_captures);
+        for (size_t next_ply{ common_ply }; next_ply < snapshot_ply; next_ply++) {
+            const session_move& move{ moves[next_ply] };
+            if (move.captured_piece != piece_code::empty) {
+                gameboard->add_to_cemetery(piece_code::colour_of(move.captured_piece), piece_code::symbol_of(move.captured_piece));
+            }
+            gameboard->store_move(piece_code::colour_of(move.moved_piece), piece_code::symbol_of(move.moved_piece),
+                coordinates::to_board_coordinates(move.to));
+        }
+        gameboard->set_pieces(snapshots[ply / snapshot_interval]);
+        current_ply = snapshot_ply;
+        while (current_ply < ply) {
+            play_next_move();
+        }
+    }
+    restore_ply();
+}
+
+void game_session::update_state() {
+    if (!gameboard->has_any_legal_move(colour_turn, last_move_check, last_move)) { //stops at the first legal move
+        state = check ? game_state::checkmate : game_state::stalemate;
+    }
+    else if (gameboard->is_fifty_move_draw()) {
+        state = game_state::fifty_move_draw;
+    }
+    else if (gameboard->is_threefold_repetition()) {
+        state = game_state::threefold_repetition;
+    }
+}
+
+void game_session::check_tablebase(const tablebase& endgame_tablebase) {
+    if (is_game_over()) {
+        return;
+    }
+    tablebase_result endgame_result;
+    if (endgame_tablebase.probe(gameboard->to_position(colour_turn), endgame_result) && endgame_result.wdl == tablebase_wdl::draw) {
+        state = game_state::tablebase_draw;
+    }
+}
+
+void game_session::save(game_snapshot& snapshot) const {
+    snapshot.format = game_snapshot::current_format;
+    snapshot.number_of_moves = static_cast<std::uint32_t>(std::min(current_ply, game_snapshot::max_moves));
+    snapshot.colour_turn = colour_turn == piece_colour::black;
+    snapshot.check = check;
+    snapshot.last_move_check = last_move_check;
+    snapshot.last_move = static_cast<std::uint8_t>(last_move);
+    snapshot.state = static_cast<std::uint8_t>(state);
+    snapshot.unused = 0;
+    snapshot.squares = gameboard->to_position(colour_turn).get_squares();
+    const position_history& history{ gameboard->get_history() };
+    size_t recent_positions{ std::min(history.size(), game_snapshot::max_recent_positions) };
+    snapshot.number_of_recent_positions = static_cast<std::uint16_t>(recent_positions);
+    for (size_t index{}; index < recent_positions; index++) {
+        snapshot.recent_hashes[index] = history.get_hash(recent_positions - 1 - index);
+        snapshot.recent_halfmove_clocks[index] = static_cast<std::uint16_t>(history.get_halfmove_clock(recent_positions - 1 - index));
+    }
+    std::copy(moves.begin(), moves.begin() + snapshot.number_of_moves, snapshot.moves.begin());
+}
+
+const char* game_session::state_string(const game_state& state) noexcept {
+    switch (state) {
+    case game_state::playing: return "playing";
+    case game_state::checkmate: return "checkmate";
+    case game_state::stalemate: return "stalemate";
+    case game_state::fifty_move_draw: return "fifty-move-draw";
+    case game_state::threefold_repetition: return "threefold-repetition";
+    case game_state::tablebase_draw: return "tablebase-draw";
+    case game_state::king_captured: return "king-captured";
+    }
+    return "unknown";
+}
@@ -21,7 +21,7 @@ king::king() {
 king::king(const char& column, const piece_colour& colour_in) {
     //std::cout << "King parametrised constructor called." << std::endl;
     try {
-        int column_number{ coordinates::alphabetical_dictionary.at(column) };
+        int column_number{ coordinates::column_number(column) };
     }
     catch (const std::out_of_range&) {
         throw std::out_of_range("Error: columns go from 'a' to 'h'.");
@@ -38,14 +38,20 @@ king::king(const char& column, const piece_colour& colour_in) {
     symbol = piece_symbol::king;
 }
 
+king::king(const std::pair<char, int>& location_in, const piece_colour& colour_in)
+    : piece{ location_in, colour_in, piece_symbol::king }
+{
+}
+
 king::~king() {
-    //std::cout << "Destructor of king of colour " << colour_string_map.at(colour) << " called at position " << location.first << location.second << "." << std::endl;
+    //std::cout << "Destructor of king of colour " << colour_string(colour) << " called at position " << location.first << location.second << "." << std::endl;
 }
 
 std::list<int> king::get_allowed_moves(const std::array<board_occupation, 64>& board_matrix) const {
     std::list<int> allowed_moves;
-    piece_colour colour_opposite{ opposite_colour.at(colour) };
+    piece_colour colour_opposite{ opposite_colour(colour) };
     int current_location{ coordinates::flatten_board_coordinates(location) };
+    int column{ coordinates::column_number(location.first) };
     int horizontal_step{ 1 };
     int vertical_step{ 8 };
     int vertical_change{};
@@ -58,7 +64,8 @@ std::list<int> king::get_allowed_moves(const std::array<board_occupation, 64>& b
             horizontal_change = factor_horizontal * horizontal_step;
             //Calculate new location to be tested by adding up the horizontal and vertical changes to the old location
             location = current_location + vertical_change + horizontal_change;
-            if (coordinates::in_board_range(location)) {
+            //Do not go off the board on the left or right edges
+            if (coordinates::in_board_range(location) && abs(column - coordinates::get_column_number(location)) <= 1) {
                 if (board_matrix.at(location - 1) == board_occupation::empty || static_cast<int>(board_matrix.at(location - 1)) == static_cast<int>(colour_opposite)) {
                     //Can move if board is empty or occupied by piece of opposite colour
                     allowed_moves.push_back(location);
@@ -67,13 +74,4 @@ std::list<int> king::get_allowed_moves(const std::array<board_occupation, 64>& b
         }
     }
     return allowed_moves;
-}
-
-std::string king::get_symbol_string(const bool& on_white_tile) const noexcept {
-    if (on_white_tile) {
-        return (colour == piece_colour::white) ? u8"♔" : u8"♚";
-    }
-    else {
-        return (colour == piece_colour::white) ? u8"♚" : u8"♔";
-    }
 }
\ No newline at end of file
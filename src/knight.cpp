@@ -18,7 +18,7 @@ knight::knight() {
 knight::knight(const char& column, const piece_colour& colour_in) {
     //std::cout << "Knight parametrised constructor called." << std::endl;
     try {
-        int column_number{ coordinates::alphabetical_dictionary.at(column) };
+        int column_number{ coordinates::column_number(column) };
     }
     catch (const std::out_of_range&) {
         throw std::out_of_range("Error: columns go from 'a' to 'h'.");
@@ -35,15 +35,20 @@ knight::knight(const char& column, const piece_colour& colour_in) {
     symbol = piece_symbol::knight;
 }
 
+knight::knight(const std::pair<char, int>& location_in, const piece_colour& colour_in)
+    : piece{ location_in, colour_in, piece_symbol::knight }
+{
+}
+
 knight::~knight() {
-    //std::cout << "Destructor of knight of colour " << colour_string_map.at(colour) << " called at position " << location.first << location.second << "." << std::endl;
+    //std::cout << "Destructor of knight of colour " << colour_string(colour) << " called at position " << location.first << location.second << "." << std::endl;
 }
 
 std::list<int> knight::get_allowed_moves(const std::array<board_occupation, 64>& board_matrix) const {
     std::list<int> allowed_moves;
-    piece_colour colour_opposite{ opposite_colour.at(colour) };
+    piece_colour colour_opposite{ opposite_colour(colour) };
     int current_location{ coordinates::flatten_board_coordinates(location) };
-    int column{ coordinates::alphabetical_dictionary.at(location.first)};
+    int column{ coordinates::column_number(location.first)};
     int horizontal_step{ 1 };
     int vertical_step{ 8 };
 
@@ -69,13 +74,4 @@ std::list<int> knight::get_allowed_moves(const std::array<board_occupation, 64>&
         }
     }
     return allowed_moves;
-}
-
-std::string knight::get_symbol_string(const bool& on_white_tile) const noexcept {
-    if (on_white_tile) {
-        return (colour == piece_colour::white) ? u8"♘" : u8"♞";
-    }
-    else {
-        return (colour == piece_colour::white) ? u8"♞" : u8"♘";
-    }
 }
\ No newline at end of file
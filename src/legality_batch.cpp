@@ -0,0 +1,66 @@
+/*
+This file contains the implementation of the batched legality queries.
+*/
+
+#include "legality_batch.h"
+#include "position.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+namespace {
+    //Chunk of queries given to a thread at a time. It is a multiple of 64 so that each chunk owns whole words of the result
+    constexpr size_t queries_per_chunk{ 64 * 64 };
+
+    void evaluate_range(const std::vector<legality_query>& queries, const size_t& begin, const size_t& end,
+        legality_scratch& scratch, result_bitset& results) {
+        for (size_t index{ begin }; index < end; index++) {
+            if (is_legal_move(queries[index].query_position, queries[index].candidate_move, scratch)) {
+                results.set(index);
+            }
+        }
+    }
+}
+
+result_bitset::result_bitset(const size_t& number_of_bits_in) : words((number_of_bits_in + 63) / 64), number_of_bits{ number_of_bits_in } {}
+
+size_t result_bitset::count() const noexcept {
+    size_t bits_set{};
+    for (const std::uint64_t& word : words) {
+        bits_set += std::bitset<64>(word).count();
+    }
+    return bits_set;
+}
+
+bool is_legal_move(const position& query_position, const chess_move& candidate_move, legality_scratch& scratch) {
+    if (candidate_move.from > 63 || candidate_move.to > 63) {
+        return false;
+    }
+    std::uint8_t code{ query_position.get_square(candidate_move.from) };
+    if (code == piece_code::empty || piece_code::colour_of(code) != query_position.get_colour_turn()) {
+        return false;
+    }
+    //Only the moves of the piece that moves are generated, and the king safety is only tested for the candidate move
+    scratch.piece_moves.clear();
+    query_position.generate_piece_moves(candidate_move.from, scratch.piece_moves);
+    if (std::find(scratch.piece_moves.begin(), scratch.piece_moves.end(), candidate_move) == scratch.piece_moves.end()) {
+        return false;
+    }
+    return query_position.is_legal(candidate_move);
+}
+
+legality_batch::legality_batch(thread_pool* pool_in) : pool{ pool_in }, scratch_arena(pool_in ? pool_in->size() : 1) {}
+
+result_bitset legality_batch::evaluate(const std::vector<legality_query>& queries) {
+    result_bitset results{ queries.size() };
+    if (!pool || queries.size() <= queries_per_chunk) {
+        evaluate_range(queries, 0, queries.size(), scratch_arena.front(), results);
+        return results;
+    }
+    pool->parallel_for(queries.size(), queries_per_chunk, [&](const size_t& slice, const size_t& begin, const size_t& end) {
+        evaluate_range(queries, begin, end, scratch_arena[slice], results);
+    });
+    return results;
+}
\ No newline at end of file
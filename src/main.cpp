@@ -6,6 +6,8 @@ This code correctly implements:
     -The allowed moves for all the chess pieces
     -Piece captures
     -Check, checkmate and stalemate
+    -Draws by threefold repetition, by the fifty-move rule and, once at most 3 pieces are left, when the endgame
+     tablebase shows that neither team can win
     -History of moves and a cemetery
 The user is allowed to:
     -Get all the allowed moves for the pieces of a certain colour
@@ -13,6 +15,16 @@ The user is allowed to:
         -Get its allowed moves
         -Move it
         -Change piece selection
+    -Take back moves and jump to any move of the game, and forward again to the moves taken back until another move is
+     played
+The game is saved to a checkpoint file (chess_game.checkpoint, or the one given with --checkpoint=<file>) after every
+move, and run with --resume it continues the game saved there, e.g. after the program was closed or died.
+Run with --server=<socket path> (and optionally --threads=<n>) to host many games at once for clients of a Unix domain
+socket instead, as described in game_server.h. With --checkpoint_dir=<directory> the server saves every game, and
+with --resume it restores the games saved there.
+Run with --mate=<FEN> to prove a forced mate in the position instead, for puzzles: the mate solver (see mate_solver.h)
+looks for a mate in at most --mate_in=<n> moves (7 by default) with checks, within --mate_memory=<MiB> of memory (256
+by default), and prints the solution and the number of nodes searched per second.
 */
 
 #include "piece.h"
@@ -23,9 +35,18 @@ The user is allowed to:
 #include "king.h"
 #include "queen.h"
 #include "board.h"
+#include "game_session.h"
+#include "game_server.h"
+#include "move_precomputer.h"
+#include "game_checkpoint.h"
+#include "mate_solver.h"
 #include "coordinate_transforms.h"
 #include "enum_attributes.h"
 #include "console_visualisation.h"
+#include "frame_renderer.h"
+#include "position.h"
+#include "tablebase.h"
+#include "thread_pool.h"
 #include <iostream>
 #include <utility>
 #include <vector>
@@ -34,11 +55,164 @@ The user is allowed to:
 #include <map>
 #include <functional>
 #include <exception>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
 
 using board_coordinates_t = std::pair<char, int>;
 
-int main()
+//Passes what is written to std::cout or std::cerr on to the console, counting it for the renderer (see frame_renderer.h)
+class console_output_counter : public std::streambuf {
+private:
+    std::ostream& stream;
+    std::streambuf* console;
+    frame_renderer& renderer;
+protected:
+    int_type overflow(int_type character) override {
+        if (traits_type::eq_int_type(character, traits_type::eof())) {
+            return traits_type::not_eof(character);
+        }
+        char text{ traits_type::to_char_type(character) };
+        renderer.count_printed_text(std::string_view{ &text, 1 });
+        return console->sputc(text);
+    }
+    std::streamsize xsputn(const char* text, std::streamsize size) override {
+        renderer.count_printed_text(std::string_view{ text, static_cast<size_t>(size) });
+        return console->sputn(text, size);
+    }
+    int sync() override {
+        return console->pubsync();
+    }
+public:
+    console_output_counter(std::ostream& stream_in, frame_renderer& renderer_in)
+        : stream{ stream_in }, console{ stream_in.rdbuf() }, renderer{ renderer_in }
+    {
+        stream.rdbuf(this);
+    }
+    ~console_output_counter() {
+        stream.rdbuf(console);
+    }
+    console_output_counter(const console_output_counter&) = delete;
+    console_output_counter& operator=(const console_output_counter&) = delete;
+};
+
+//Host many games at once instead of playing one in the console (see game_server.h)
+int run_server(const std::string& socket_path, const size_t& number_of_threads, const std::string& checkpoint_directory, const bool& resume) {
+    try {
+        thread_pool server_pool{ number_of_threads };
+        game_server server{ socket_path, server_pool, checkpoint_directory };
+        if (resume) {
+            std::cout << "Resumed " << server.resume_games() << " games from " << checkpoint_directory << "." << std::endl;
+        }
+        std::cout << "Serving games on " << socket_path << " with " << server_pool.size() << " worker threads." << std::endl;
+        server.run();
+    }
+    catch (const std::exception& server_err) {
+        std::cerr << server_err.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+//Prove a forced mate from a position instead of playing a game (see mate_solver.h)
+int run_mate_solver(const std::string& fen, const mate_solver_settings& settings) {
+    try {
+        position puzzle{ fen };
+        std::cout << "Looking for a mate in at most " << settings.max_moves << " moves for "
+            << colour_string(puzzle.get_colour_turn()) << "..." << std::endl;
+        mate_solver solver{ settings };
+        mate_result result{ solver.solve(puzzle) };
+        switch (result.status) {
+        case mate_status::proven: {
+            std::cout << "Mate in " << (result.solution.size() + 1) / 2 << " for " << colour_string(puzzle.get_colour_turn()) << ":";
+            for (size_t ply{}; ply < result.solution.size(); ply++) {
+                const chess_move& solution_move{ result.solution[ply] };
+                std::pair<char, int> from{ coordinates::to_board_coordinates(solution_move.from + 1) };
+                std::pair<char, int> to{ coordinates::to_board_coordinates(solution_move.to + 1) };
+                if (ply % 2 == 0) {
+                    std::cout << ' ' << ply / 2 + 1 << '.';
+                }
+                std::cout << ' ' << from.first << from.second << u8"→" << to.first << to.second;
+                puzzle.make_move(solution_move);
+                if (ply % 2 == 0) {
+                    std::cout << (ply + 1 == result.solution.size() ? '#' : '+');
+                }
+            }
+            std::cout << std::endl;
+            break;
+        }
+        case mate_status::disproven:
+            std::cout << "There is no mate with checks in " << settings.max_moves << " moves or fewer." << std::endl;
+            break;
+        case mate_status::out_of_memory:
+            std::cout << "The memory budget ran out before the mate was proven or refuted. Try with more memory "
+                << "(--mate_memory=<MiB>) or fewer moves." << std::endl;
+            break;
+        }
+        std::cout << result.nodes << " nodes in " << result.seconds << " s ("
+            << static_cast<std::uint64_t>(result.nodes / std::max(result.seconds, 1e-9)) << " nodes/s)" << std::endl;
+        return result.status == mate_status::out_of_memory ? 1 : 0;
+    }
+    catch (const std::exception& solver_err) {
+        std::cerr << solver_err.what() << std::endl;
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[])
 {
+    std::string socket_path;
+    size_t number_of_threads{ std::max(1u, std::thread::hardware_concurrency()) };
+    std::string checkpoint_path{ "chess_game.checkpoint" };
+    std::string checkpoint_directory;
+    bool resume{ false };
+    std::string mate_fen;
+    mate_solver_settings mate_settings;
+    for (int i{ 1 }; i < argc; i++) {
+        std::string argument{ argv[i] };
+        if (argument.rfind("--server=", 0) == 0) {
+            socket_path = argument.substr(9);
+        }
+        else if (argument.rfind("--threads=", 0) == 0) {
+            number_of_threads = static_cast<size_t>(std::max(1, std::atoi(argument.c_str() + 10)));
+        }
+        else if (argument.rfind("--checkpoint=", 0) == 0) {
+            checkpoint_path = argument.substr(13);
+        }
+        else if (argument.rfind("--checkpoint_dir=", 0) == 0) {
+            checkpoint_directory = argument.substr(17);
+        }
+        else if (argument == "--resume") {
+            resume = true;
+        }
+        else if (argument.rfind("--mate=", 0) == 0) {
+            mate_fen = argument.substr(7);
+        }
+        else if (argument.rfind("--mate_in=", 0) == 0) {
+            mate_settings.max_moves = std::atoi(argument.c_str() + 10);
+        }
+        else if (argument.rfind("--mate_memory=", 0) == 0) {
+            mate_settings.memory_budget = static_cast<size_t>(std::max(1, std::atoi(argument.c_str() + 14))) << 20;
+        }
+        else {
+            std::cerr << "Unknown option " << argument << ". Options: [--checkpoint=<file>] [--resume], or --server=<socket path> "
+                << "[--threads=<n>] [--checkpoint_dir=<directory> [--resume]], or --mate=<FEN> [--mate_in=<n>] "
+                << "[--mate_memory=<MiB>]" << std::endl;
+            return 1;
+        }
+    }
+    if (!socket_path.empty()) {
+        return run_server(socket_path, number_of_threads, checkpoint_directory, resume);
+    }
+    if (!mate_fen.empty()) {
+        return run_mate_solver(mate_fen, mate_settings);
+    }
     change_font_colour(font_colour::white);
     std::cout << "Welcome to this console CHESS game. This program uses Unicode symbols for better visualisation. "
         << "Please change the console font to NSimSun or MS Gothic before playing. This can be done by clicking on the top left corner of the console "
@@ -66,87 +240,203 @@ int main()
             std::cout << "Invalid choice, please enter N or G: ";
         }
     }
-    std::unique_ptr<board> gameboard;
+    std::unique_ptr<checkpoint_file> checkpoint; //the game is saved after every move, to resume it if the program dies
+    try {
+        checkpoint = std::make_unique<checkpoint_file>(checkpoint_path, true);
+    }
+    catch (const std::exception& checkpoint_err) {
+        std::cerr << checkpoint_err.what() << " The game will not be saved." << std::endl;
+    }
+    std::unique_ptr<game_session> session;
     try {
-        gameboard = std::make_unique<board>();
+        const game_snapshot* saved_game{ (resume && checkpoint) ? checkpoint->get_last_snapshot() : nullptr };
+        if (saved_game) {
+            auto restore_start{ std::chrono::steady_clock::now() };
+            session = std::make_unique<game_session>(*saved_game);
+            std::cout << "Resumed the game of " << session->get_ply() << " moves saved in " << checkpoint_path << " in "
+                << std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - restore_start).count() << " microseconds." << std::endl;
+        }
+        else {
+            if (resume) {
+                std::cout << "There is no saved game to resume. Starting a new game." << std::endl;
+            }
+            session = std::make_unique<game_session>();
+        }
+        if (checkpoint) {
+            checkpoint->save(*session);
+        }
     }
     catch (const std::exception& board_construct_err) {
         std::cerr << board_construct_err.what() << std::endl;
         return 1; //End program if could not construct board
     }
-    piece_colour colour_turn{ piece_colour::white };
-    std::list<std::string> all_allowed_moves;
+    frame_renderer renderer; //Draws the board, redrawing only what changed since the last frame
+    //The text printed and typed below the board is counted, so that the board is drawn in full once it may have scrolled
+    console_output_counter counted_output{ std::cout, renderer };
+    console_output_counter counted_errors{ std::cerr, renderer };
+    auto read_line = [&renderer](std::string& line) {
+        std::getline(std::cin, line);
+        renderer.count_printed_text(line);
+        renderer.count_printed_text("\n");
+    };
+    tablebase endgame_tablebase; //Tables generated for the materials the game is about to reach
+    thread_pool tablebase_pool;
+    move_precomputer precomputed_moves; //moves of the colour turn, and the tables its captures lead to, computed while the player thinks
+    //Once the board has changed and the precomputer was cancelled: end the game if the tablebase shows a draw, and start
+    //the precomputer for the new turn otherwise
+    auto start_turn = [&]() {
+        if (session->is_game_over()) {
+            return;
+        }
+        std::string material{ tablebase::material_of(session->get_board().to_position(session->get_colour_turn())) };
+        //Generated in the background before a capture reaches it, so only needed here when the game is resumed or goes
+        //to another move. The tables of 3 pieces take well under a second to generate
+        if (material.size() == 3 && !endgame_tablebase.has_table(material)) {
+            endgame_tablebase.generate(material, tablebase_pool);
+        }
+        session->check_tablebase(endgame_tablebase);
+        if (!session->is_game_over()) {
+            precomputed_moves.start(*session, endgame_tablebase, tablebase_pool);
+        }
+    };
+    try {
+        start_turn();
+    }
+    catch (const std::exception& tablebase_err) {
+        std::cerr << tablebase_err.what() << std::endl;
+        return 1;
+    }
       
     bool game_over{ false };
-    bool check{ false };
-    bool last_move_check{ false };
-    int last_move{};
     while (!game_over) { //Loop over turns
-        system("cls");
-        gameboard->show(font_choice, colour_turn, check);
-        try {
-            all_allowed_moves = gameboard->get_all_pieces_allowed_moves(colour_turn, last_move_check, last_move);
+        const board& gameboard{ session->get_board() };
+        const piece_colour colour_turn{ session->get_colour_turn() };
+        const bool check{ session->in_check() };
+        if (session->get_state() == game_state::king_captured) {
+            break;
         }
-        catch (const std::exception& all_moves_err) {
-            std::cerr << all_moves_err.what() << std::endl;
-            return 1;
+        gameboard.draw(renderer, font_choice, colour_turn, check);
+        renderer.present();
+        switch (session->get_state()) {
+        case game_state::checkmate:
+            change_font_colour(font_colour::red);
+            std::cout << "CHECKMATE! ";
+            change_font_colour(font_colour::white);
+            std::cout << "Team of colour "
+                << colour_string(opposite_colour(colour_turn));
+            change_font_colour(font_colour::green);
+            std::cout << " WINS";
+            change_font_colour(font_colour::white);
+            std::cout << "!" << std::endl;
+            break;
+        case game_state::stalemate:
+            std::cout << "Stalemate! Team of colour " << colour_string(colour_turn) << " cannot move! The game ends in a draw!" << std::endl;
+            break;
+        case game_state::fifty_move_draw:
+            std::cout << "Fifty moves of each team without a capture or a pawn move! The game ends in a draw!" << std::endl;
+            break;
+        case game_state::threefold_repetition:
+            std::cout << "The same position was repeated three times! The game ends in a draw!" << std::endl;
+            break;
+        case game_state::tablebase_draw:
+            std::cout << "The endgame tablebase shows that neither team can win! The game ends in a draw!" << std::endl;
+            break;
+        default:
+            break;
         }
-        if (all_allowed_moves.size() == 0) {
+        if (session->is_game_over()) {
             game_over = true;
-            if (check) {
-                change_font_colour(font_colour::red);
-                std::cout << "CHECKMATE! ";
-                change_font_colour(font_colour::white);
-                std::cout << "Team of colour "
-                    << colour_string_map.at(opposite_colour.at(colour_turn));
-                change_font_colour(font_colour::green);
-                std::cout << " WINS";
-                change_font_colour(font_colour::white);
-                std::cout << "!" << std::endl;
-            }
-            else {
-                std::cout << "Stalemate! Team of colour " << colour_string_map.at(colour_turn) << " cannot move! The game ends in a draw!" << std::endl;
-            }
             continue;
         }
         if (check) {
-            std::cout << "King of colour " << colour_string_map.at(colour_turn) << " is in ";
+            std::cout << "King of colour " << colour_string(colour_turn) << " is in ";
             change_font_colour(font_colour::red);
             std::cout << "CHECK";
             change_font_colour(font_colour::white);
             std::cout << "!" << std::endl;
         }
+        //All the moves of the turn are computed in the background as soon as the turn starts, and waited for (if they are
+        //not ready yet) only once they are shown or a piece is selected
+        const turn_moves* all_allowed_moves{ nullptr };
+        auto generate_all_allowed_moves = [&]() {
+            if (!all_allowed_moves) {
+                all_allowed_moves = &precomputed_moves.get();
+            }
+        };
         bool valid_input{ false };
         bool got_all_allowed_moves{ false };
-        std::cout << "It is " << colour_string_map.at(colour_turn) << "'s turn! Please enter A to get all the allowed moves "
-            << "or enter the board coordinates (e.g. a2) of a piece: ";
+        std::cout << "It is " << colour_string(colour_turn) << "'s turn! Please enter A to get all the allowed moves, U to take "
+            << "back the last move, J to jump to another move of the game, or enter the board coordinates (e.g. a2) of a piece: ";
         while (!valid_input) {
             std::string input_string;
-            std::getline(std::cin, input_string);
+            read_line(input_string);
             if (input_string.size() > 2 || input_string.size() == 0) {
                 std::cerr << "Invalid input. Please try again: ";
                 continue;
             }
+            if (input_string.size() == 1 && (std::toupper(input_string[0]) == 'U' || std::toupper(input_string[0]) == 'J')) {
+                //Go back to an earlier move, or forward again to a move taken back, and start the turn there
+                size_t ply{};
+                if (std::toupper(input_string[0]) == 'U') {
+                    if (session->get_ply() == 0) {
+                        std::cerr << "There is no move to take back! Please try again: ";
+                        continue;
+                    }
+                    ply = session->get_ply() - 1;
+                }
+                else {
+                    size_t number_of_plies{ session->get_moves().size() };
+                    std::cout << "Enter the number of the move to go to, from 0 (the start of the game) to " << number_of_plies << ": ";
+                    std::string ply_string;
+                    read_line(ply_string);
+                    if (ply_string.empty() || ply_string.size() > 5 || ply_string.find_first_not_of("0123456789") != std::string::npos ||
+                        std::stoul(ply_string) > number_of_plies) {
+                        std::cerr << "There is no such move in the game. Please enter A, U, J or the board coordinates of a piece: ";
+                        continue;
+                    }
+                    ply = std::stoul(ply_string);
+                }
+                precomputed_moves.cancel();
+                try {
+                    session->go_to_ply(ply);
+                    if (checkpoint) {
+                        checkpoint->save(*session);
+                    }
+                    start_turn();
+                }
+                catch (const std::exception& navigation_err) {
+                    std::cerr << navigation_err.what() << std::endl;
+                    return 1;
+                }
+                break;
+            }
             if (!got_all_allowed_moves && input_string.size() == 1) {
                 if (std::toupper(input_string[0]) == 'A') {
-                    system("cls"); //clear the console 
-                    gameboard->show(font_choice, colour_turn, check);
+                    try {
+                        generate_all_allowed_moves();
+                    }
+                    catch (const std::exception& all_moves_err) {
+                        std::cerr << all_moves_err.what() << std::endl;
+                        return 1;
+                    }
+                    gameboard.draw(renderer, font_choice, colour_turn, check);
+                    renderer.present();
                     if (check) {
-                        std::cout << "King of colour " << colour_string_map.at(colour_turn) << " is in ";
+                        std::cout << "King of colour " << colour_string(colour_turn) << " is in ";
                         change_font_colour(font_colour::red);
                         std::cout << "CHECK";
                         change_font_colour(font_colour::white);
                         std::cout << "!" << std::endl;
                     }
-                    std::cout << "These are all the allowed moves for the " << colour_string_map.at(colour_turn) << " pieces: " << std::endl;
-                    for (const auto& move : all_allowed_moves) {
+                    std::cout << "These are all the allowed moves for the " << colour_string(colour_turn) << " pieces: " << std::endl;
+                    for (const auto& move : board::format_moves(all_allowed_moves->all_allowed_moves)) {
                         std::cout << move << '\t';
                     }
                     got_all_allowed_moves = true; //all the allowed moves were obtained so the only option now is to select a piece
                     std::cout << std::endl << "Please now enter the board coordinates of a piece: ";
                 }
                 else {
-                    std::cerr << "Invalid letter input. To get all the allowed moves, please enter the letter A: ";
+                    std::cerr << "Invalid letter input. To get all the allowed moves, please enter the letter A, or U or J to go to another move: ";
                 }
                 continue;
             }
@@ -166,7 +456,7 @@ int main()
             int old_location_int{};
             try {
                 old_location_int = coordinates::flatten_board_coordinates(old_piece_coords);
-                gameboard_occupation_old_location = gameboard->get_element(old_location_int);
+                gameboard_occupation_old_location = gameboard.get_element(old_location_int);
             }
             catch (const std::out_of_range& coords_err) {
                 std::cerr << coords_err.what() << " Please try again: ";
@@ -177,26 +467,26 @@ int main()
                 continue;
             }
             if (static_cast<int>(gameboard_occupation_old_location) != static_cast<int>(colour_turn)) {
-                std::cerr << "It is " << colour_string_map.at(colour_turn) << "'s turn! Please enter the board coordinates of a piece of the right colour: ";
+                std::cerr << "It is " << colour_string(colour_turn) << "'s turn! Please enter the board coordinates of a piece of the right colour: ";
                 continue;
             }
-            std::list<int> allowed_moves;
             try {
-                allowed_moves = gameboard->get_piece_allowed_moves(old_piece_coords, last_move_check, last_move);
+                generate_all_allowed_moves();
             }
             catch (const std::exception& piece_moves_err) {
                 std::cerr << piece_moves_err.what() << std::endl;
                 return 1;
             }
+            std::vector<int> allowed_moves{ all_allowed_moves->get_piece_allowed_moves(old_location_int) }; //Reuse the moves of all the pieces
             if (allowed_moves.size() == 0) {
                 std::cout << "The chosen piece cannot be moved! Please select a different one: ";
                 continue;
             }
             valid_input = true;
-            system("cls");
-            gameboard->show(font_choice, colour_turn, old_piece_coords, check);
+            gameboard.draw(renderer, font_choice, colour_turn, old_piece_coords, check);
+            renderer.present();
             if (check) {
-                std::cout << "King of colour " << colour_string_map.at(colour_turn) << " is in ";
+                std::cout << "King of colour " << colour_string(colour_turn) << " is in ";
                 change_font_colour(font_colour::red);
                 std::cout << "CHECK";
                 change_font_colour(font_colour::white);
@@ -208,17 +498,17 @@ int main()
                 ". Enter new board coordinates to move the selected piece, G to get its allowed moves, or C to change piece: ";
             while (!valid_choice) {
                 std::string choice_string;
-                std::getline(std::cin, choice_string);
+                read_line(choice_string);
                 if (choice_string.size() > 2 || choice_string.size() == 0) {
                     std::cerr << "Invalid input. Please try again: ";
                     continue;
                 }
                 if (choice_string.size() == 1) {
                     if (!got_allowed_moves && std::toupper(choice_string[0]) == 'G') {
-                        system("cls");
-                        gameboard->show(font_choice, colour_turn, old_piece_coords, check);
+                        gameboard.draw(renderer, font_choice, colour_turn, old_piece_coords, check);
+                        renderer.present();
                         if (check) {
-                            std::cout << "King of colour " << colour_string_map.at(colour_turn) << " is in ";
+                            std::cout << "King of colour " << colour_string(colour_turn) << " is in ";
                             change_font_colour(font_colour::red);
                             std::cout << "CHECK";
                             change_font_colour(font_colour::white);
@@ -242,10 +532,10 @@ int main()
                         std::cout << "You already asked for the allowed moves! Please enter the new board coordinates, or C to change piece: ";
                     }
                     else if (std::toupper(choice_string[0]) == 'C') {
-                        system("cls"); //clear the console 
-                        gameboard->show(font_choice, colour_turn, check);
+                        gameboard.draw(renderer, font_choice, colour_turn, check);
+                        renderer.present();
                         if (check) {
-                            std::cout << "King of colour " << colour_string_map.at(colour_turn) << " is in ";
+                            std::cout << "King of colour " << colour_string(colour_turn) << " is in ";
                             change_font_colour(font_colour::red);
                             std::cout << "CHECK";
                             change_font_colour(font_colour::white);
@@ -286,21 +576,12 @@ int main()
                     std::cerr << "Could not set to specified location, move was not allowed. Please try again: ";
                     continue;
                 }
-                board_occupation gameboard_occupation_new_location;
+                precomputed_moves.cancel(); //the board is about to change. The moves of the turn stay until the next start
                 try {
-                    gameboard_occupation_new_location = gameboard->get_element(new_location_int);
-                    if (static_cast<int>(gameboard_occupation_new_location) == static_cast<int>(opposite_colour.at(colour_turn))) {
-                        piece_symbol captured_piece_symbol{ gameboard->capture_piece(new_piece_coords, colour_turn) };
-                        if (captured_piece_symbol == piece_symbol::king) {
-                            game_over = true;
-                            valid_input = true;
-                            valid_choice = true;
-                        }
+                    session->make_move(old_location_int, new_location_int, all_allowed_moves);
+                    if (checkpoint) {
+                        checkpoint->save(*session);
                     }
-                    gameboard->set_piece_location(old_piece_coords, new_piece_coords);
-                    gameboard->set_element(old_location_int) = board_occupation::empty;
-                    gameboard->set_element(new_location_int) = gameboard_occupation_old_location;
-                    gameboard->store_move(new_piece_coords);
                 }
                 catch (const std::invalid_argument& not_allowed_move_err) {
                     std::cerr << not_allowed_move_err.what() << " Please choose another location: ";
@@ -314,20 +595,20 @@ int main()
                     std::cerr << setting_location_err.what() << " Exiting.." << std::endl;
                     return 1;
                 }
-                valid_choice = true;
-                if (!game_over) {
-                    try {
-                        check = gameboard->check_for_check(new_piece_coords, last_move_check);
-                        last_move = coordinates::flatten_board_coordinates(new_piece_coords);
-                    }
-                    catch (const std::exception & err) {
-                        std::cerr << err.what() << std::endl;
-                        return 1;
-                    }
+                try {
+                    start_turn();
+                }
+                catch (const std::exception& tablebase_err) {
+                    std::cerr << tablebase_err.what() << std::endl;
+                    return 1;
                 }
+                valid_choice = true;
             }
         }
-        colour_turn = opposite_colour.at(colour_turn);
+    }
+    if (checkpoint) {
+        checkpoint.reset();
+        std::remove(checkpoint_path.c_str()); //a finished game cannot be resumed
     }
     std::cout << "Thanks for playing!" << std::endl;
     return 0;
@@ -0,0 +1,126 @@
+/*
+This file contains the implementation of the mapped file. See mapped_file.h
+*/
+
+#include "mapped_file.h"
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+mapped_file::mapped_file(const std::string& path, const access& file_access, const size_t& size) noexcept {
+    bool writable{ file_access == access::read_write };
+    size_t existing_size{};
+#ifdef _WIN32
+    HANDLE file{ writable ?
+        CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) :
+        CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr) };
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    file_status = status::not_mapped;
+    LARGE_INTEGER file_size{};
+    GetFileSizeEx(file, &file_size);
+    existing_size = static_cast<size_t>(file_size.QuadPart);
+    size_t new_size{ size == 0 ? existing_size : size };
+    //Mapping a file read-write with a size extends it
+    if (new_size > 0 && (existing_size == new_size || (writable && existing_size == 0))) {
+        LARGE_INTEGER maximum_size{};
+        maximum_size.QuadPart = static_cast<LONGLONG>(new_size);
+        mapping_handle = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, maximum_size.HighPart, maximum_size.LowPart, nullptr);
+        if (mapping_handle) {
+            mapping = MapViewOfFile(mapping_handle, writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, new_size);
+        }
+    }
+    CloseHandle(file);
+#else
+    int file{ writable ? ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644) : ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+    if (file < 0) {
+        return;
+    }
+    file_status = status::not_mapped;
+    struct stat file_information {};
+    if (::fstat(file, &file_information) == 0) {
+        existing_size = static_cast<size_t>(file_information.st_size);
+    }
+    size_t new_size{ size == 0 ? existing_size : size };
+    //A new file is extended without writing it, so the pages that are never written take no space on the disk
+    if (new_size > 0 && (existing_size == new_size ||
+        (writable && existing_size == 0 && ::ftruncate(file, static_cast<off_t>(new_size)) == 0))) {
+        void* mapped{ ::mmap(nullptr, new_size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file, 0) };
+        if (mapped != MAP_FAILED) {
+            mapping = mapped;
+            if (!writable) {
+                ::madvise(mapped, new_size, MADV_RANDOM);
+            }
+        }
+    }
+    ::close(file); //the mapping keeps the file open
+#endif
+    if (!mapping) {
+        close();
+        file_status = status::not_mapped;
+        return;
+    }
+    mapping_size = new_size;
+    file_status = status::mapped;
+}
+
+mapped_file::~mapped_file() {
+    close();
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept {
+    *this = std::move(other);
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(mapping, other.mapping);
+        std::swap(mapping_size, other.mapping_size);
+#ifdef _WIN32
+        std::swap(mapping_handle, other.mapping_handle);
+#endif
+        std::swap(file_status, other.file_status);
+    }
+    return *this;
+}
+
+void mapped_file::close() noexcept {
+#ifdef _WIN32
+    if (mapping) {
+        UnmapViewOfFile(mapping);
+    }
+    if (mapping_handle) {
+        CloseHandle(mapping_handle);
+    }
+    mapping_handle = nullptr;
+#else
+    if (mapping) {
+        ::munmap(mapping, mapping_size);
+    }
+#endif
+    mapping = nullptr;
+    mapping_size = 0;
+    file_status = status::not_opened;
+}
+
+void mapped_file::flush() const noexcept {
+    if (!mapping) {
+        return;
+    }
+#ifdef _WIN32
+    FlushViewOfFile(mapping, mapping_size);
+#else
+    ::msync(mapping, mapping_size, MS_SYNC);
+#endif
+}
@@ -0,0 +1,213 @@
+/*
+This file contains the implementation of the mate solver. See mate_solver.h
+*/
+
+#include "mate_solver.h"
+#include "position.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    constexpr std::uint32_t infinite_number{ 1u << 30 };
+
+    std::uint32_t saturated_sum(const std::uint32_t& lhs, const std::uint32_t& rhs) {
+        return std::min(infinite_number, lhs + rhs);
+    }
+
+    //The legal moves of the position that give check
+    void generate_checks(position& attacker_position, const move_list& legal_moves, move_list& checks) {
+        checks.clear();
+        for (const chess_move& legal_move : legal_moves) {
+            std::uint8_t captured{ attacker_position.make_move(legal_move) };
+            if (attacker_position.in_check()) {
+                checks.push_back(legal_move);
+            }
+            attacker_position.unmake_move(legal_move, captured);
+        }
+    }
+}
+
+mate_solver::mate_solver(const mate_solver_settings& settings_in)
+    : settings{ settings_in }
+{
+    if (settings.max_moves < 1 || settings.max_moves > 64) {
+        throw std::invalid_argument("Error: the number of moves to mate must be between 1 and 64.");
+    }
+    if (settings.memory_budget < 1024 * sizeof(node)) {
+        throw std::invalid_argument("Error: the memory budget of the mate solver is too small.");
+    }
+}
+
+mate_result mate_solver::solve(const position& root) {
+    auto start{ std::chrono::steady_clock::now() };
+    mate_result result;
+    size_t capacity{ std::min<size_t>(settings.memory_budget / sizeof(node), infinite_number) };
+    nodes.clear();
+    nodes.reserve(capacity);
+
+    position root_position{ root };
+    move_list legal_moves;
+    move_list checks;
+    root_position.generate_legal_moves(legal_moves);
+    generate_checks(root_position, legal_moves, checks);
+    node root_node;
+    root_node.proof = checks.empty() ? infinite_number : 1;
+    root_node.disproof = checks.empty() ? 0 : static_cast<std::uint32_t>(checks.size());
+    nodes.push_back(root_node);
+
+    bool out_of_memory{ false };
+    while (nodes[0].proof != 0 && nodes[0].disproof != 0) {
+        //Down to the most-proving node, making the moves on the way
+        position node_position{ root };
+        std::uint32_t node_index{};
+        int ply{};
+        while (nodes[node_index].expanded) {
+            const node& parent{ nodes[node_index] };
+            bool attacker{ ply % 2 == 0 };
+            std::uint32_t best_child{ parent.first_child };
+            for (std::uint32_t child{ parent.first_child + 1 }; child < parent.first_child + parent.number_of_children; child++) {
+                if (attacker ? nodes[child].proof < nodes[best_child].proof : nodes[child].disproof < nodes[best_child].disproof) {
+                    best_child = child;
+                }
+            }
+            node_position.make_move(nodes[best_child].move);
+            node_index = best_child;
+            ply++;
+        }
+        if (!expand(node_index, ply, node_position)) {
+            out_of_memory = true;
+            break;
+        }
+        //And back up to the root with the new numbers
+        while (true) {
+            update_numbers(node_index, ply % 2 == 0);
+            if (node_index == 0) {
+                break;
+            }
+            node_index = nodes[node_index].parent;
+            ply--;
+        }
+    }
+
+    result.nodes = nodes.size();
+    if (nodes[0].proof == 0) {
+        result.status = mate_status::proven;
+        std::uint32_t node_index{};
+        bool attacker{ true };
+        while (nodes[node_index].expanded) {
+            //The attacker takes the shortest proven mate, the defender the longest one
+            const node& parent{ nodes[node_index] };
+            std::uint32_t best_child{};
+            int best_distance{};
+            for (std::uint32_t child{ parent.first_child }; child < parent.first_child + parent.number_of_children; child++) {
+                if (nodes[child].proof != 0) {
+                    continue;
+                }
+                int distance{ mate_distance(child, !attacker) };
+                if (best_child == 0 || (attacker ? distance < best_distance : distance > best_distance)) {
+                    best_child = child;
+                    best_distance = distance;
+                }
+            }
+            result.solution.push_back(nodes[best_child].move);
+            node_index = best_child;
+            attacker = !attacker;
+        }
+    }
+    else {
+        result.status = out_of_memory ? mate_status::out_of_memory : mate_status::disproven;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+bool mate_solver::expand(const std::uint32_t& node_index, const int& ply, position& node_position) {
+    bool attacker{ ply % 2 == 0 };
+    move_list legal_moves;
+    move_list child_moves;
+    node_position.generate_legal_moves(legal_moves);
+    if (attacker) {
+        generate_checks(node_position, legal_moves, child_moves);
+    }
+    else {
+        child_moves = legal_moves; //in check, so these are the evasions
+    }
+    if (nodes.size() + child_moves.size() > nodes.capacity()) {
+        return false;
+    }
+    nodes[node_index].first_child = static_cast<std::uint32_t>(nodes.size());
+    nodes[node_index].number_of_children = static_cast<std::uint16_t>(child_moves.size());
+    nodes[node_index].expanded = true;
+    //The attacker has moved last at the last ply it may, and may not move again after the defender
+    bool last_attacker_move{ attacker && ply / 2 == settings.max_moves - 1 };
+    move_list grandchild_moves;
+    move_list checks;
+    for (const chess_move& child_move : child_moves) {
+        node child;
+        child.parent = node_index;
+        child.move = child_move;
+        std::uint8_t captured{ node_position.make_move(child_move) };
+        node_position.generate_legal_moves(grandchild_moves);
+        if (attacker) {
+            if (grandchild_moves.empty()) { //checkmate
+                child.proof = 0;
+                child.disproof = infinite_number;
+            }
+            else if (last_attacker_move) {
+                child.proof = infinite_number;
+                child.disproof = 0;
+            }
+            else {
+                child.proof = static_cast<std::uint32_t>(grandchild_moves.size());
+                child.disproof = 1;
+            }
+        }
+        else {
+            generate_checks(node_position, grandchild_moves, checks);
+            if (checks.empty()) {
+                child.proof = infinite_number;
+                child.disproof = 0;
+            }
+            else {
+                child.proof = 1;
+                child.disproof = static_cast<std::uint32_t>(checks.size());
+            }
+        }
+        node_position.unmake_move(child_move, captured);
+        nodes.push_back(child);
+    }
+    return true;
+}
+
+void mate_solver::update_numbers(const std::uint32_t& node_index, const bool& attacker) {
+    node& updated{ nodes[node_index] };
+    if (!updated.expanded) {
+        return;
+    }
+    std::uint32_t smallest{ infinite_number };
+    std::uint32_t sum{};
+    for (std::uint32_t child{ updated.first_child }; child < updated.first_child + updated.number_of_children; child++) {
+        smallest = std::min(smallest, attacker ? nodes[child].proof : nodes[child].disproof);
+        sum = saturated_sum(sum, attacker ? nodes[child].disproof : nodes[child].proof);
+    }
+    updated.proof = attacker ? smallest : sum;
+    updated.disproof = attacker ? sum : smallest;
+}
+
+int mate_solver::mate_distance(const std::uint32_t& node_index, const bool& attacker) const {
+    const node& proven{ nodes[node_index] };
+    if (!proven.expanded) { //a checkmate
+        return 0;
+    }
+    int distance{ attacker ? 1 << 20 : 0 };
+    for (std::uint32_t child{ proven.first_child }; child < proven.first_child + proven.number_of_children; child++) {
+        if (nodes[child].proof == 0) {
+            int child_distance{ 1 + mate_distance(child, !attacker) };
+            distance = attacker ? std::min(distance, child_distance) : std::max(distance, child_distance);
+        }
+    }
+    return distance;
+}
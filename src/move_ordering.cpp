@@ -0,0 +1,58 @@
+/*
+This file contains the implementation of the move ordering. See move_ordering.h
+*/
+
+#include "move_ordering.h"
+#include "position.h"
+#include "enum_attributes.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace {
+    //Rank of each piece_symbol (pawn, rook, knight, bishop, king, queen) by value, for MVV/LVA
+    constexpr std::array<int, 6> value_rank{ 0, 3, 1, 2, 5, 4 };
+
+    //Scores of the captures, scaled so that MVV/LVA (from -5 to 35) only orders captures with the same exchange value
+    constexpr int see_scale{ 64 };
+    //Below every capture that keeps material (at least -5) and above every losing one (at most -10 * see_scale + 35, as
+    //the smallest loss is a bishop for a knight)
+    constexpr int quiet_move_score{ -8 };
+}
+
+int move_ordering::mvv_lva(const position& game_position, const chess_move& capture) noexcept {
+    int victim{ value_rank[static_cast<int>(piece_code::symbol_of(game_position.get_square(capture.to)))] };
+    int attacker{ value_rank[static_cast<int>(piece_code::symbol_of(game_position.get_square(capture.from)))] };
+    return 8 * victim - attacker;
+}
+
+int move_ordering::capture_score(const position& game_position, const chess_move& capture) noexcept {
+    return see_scale * game_position.see(capture) + mvv_lva(game_position, capture);
+}
+
+bool move_ordering::is_capture(const position& game_position, const chess_move& candidate_move) noexcept {
+    return game_position.get_square(candidate_move.to) != piece_code::empty;
+}
+
+void move_ordering::order_moves(const position& game_position, move_list& moves) {
+    std::array<int, 256> scores;
+    for (size_t i{}; i < moves.size(); i++) {
+        scores[i] = is_capture(game_position, moves[i]) ? capture_score(game_position, moves[i]) : quiet_move_score;
+    }
+    sort_by_score(moves, scores);
+}
+
+void move_ordering::sort_by_score(move_list& moves, std::array<int, 256>& scores) noexcept {
+    //Insertion sort: the lists are short, and it is stable
+    for (size_t i{ 1 }; i < moves.size(); i++) {
+        chess_move sorted_move{ moves[i] };
+        int score{ scores[i] };
+        size_t j{ i };
+        for (; j > 0 && scores[j - 1] < score; j--) {
+            moves[j] = moves[j - 1];
+            scores[j] = scores[j - 1];
+        }
+        moves[j] = sorted_move;
+        scores[j] = score;
+    }
+}
@@ -0,0 +1,135 @@
+/*
+This file contains the implementation of the move picker. See move_picker.h
+*/
+
+#include "move_picker.h"
+#include "move_ordering.h"
+#include "position.h"
+#include <cstdint>
+#include <utility>
+
+move_picker::move_picker(const position& picked_position_in, const move_picker_hints& hints_in)
+    : picked_position{ picked_position_in }, hints{ hints_in }
+{
+}
+
+bool move_picker::is_hint(const chess_move& candidate_move) const noexcept {
+    return candidate_move == hints.hash_move || candidate_move == hints.killers[0] || candidate_move == hints.killers[1] ||
+        candidate_move == hints.countermove;
+}
+
+bool move_picker::is_playable(const chess_move& candidate_move) const {
+    return candidate_move != no_move && picked_position.is_pseudo_legal(candidate_move) && picked_position.is_legal(candidate_move);
+}
+
+bool move_picker::next(chess_move& picked_move) {
+    while (true) {
+        switch (current_stage) {
+        case stage::hash_move:
+            current_stage = stage::generate_captures;
+            if (is_playable(hints.hash_move)) {
+                picked_move = hints.hash_move;
+                picked_stage = stage::hash_move;
+                return true;
+            }
+            break;
+        case stage::generate_captures:
+            picked_position.generate_captures(captures);
+            for (size_t i{}; i < captures.size(); i++) {
+                scores[i] = move_ordering::mvv_lva(picked_position, captures[i]);
+            }
+            next_move = 0;
+            current_stage = stage::good_captures;
+            break;
+        case stage::good_captures:
+            while (next_move < captures.size()) {
+                //Selection of the best capture left, as the next one is often never needed
+                size_t best{ next_move };
+                for (size_t i{ next_move + 1 }; i < captures.size(); i++) {
+                    if (scores[i] > scores[best]) {
+                        best = i;
+                    }
+                }
+                std::swap(captures[next_move], captures[best]);
+                std::swap(scores[next_move], scores[best]);
+                chess_move capture{ captures[next_move++] };
+                if (capture == hints.hash_move) {
+                    continue;
+                }
+                if (picked_position.see(capture) < 0) {
+                    captures[bad_captures_end++] = capture;
+                    continue;
+                }
+                if (picked_position.is_legal(capture)) {
+                    picked_move = capture;
+                    picked_stage = stage::good_captures;
+                    return true;
+                }
+            }
+            current_stage = stage::killers;
+            break;
+        case stage::killers:
+            while (next_killer < hints.killers.size()) {
+                const chess_move& killer{ hints.killers[next_killer++] };
+                //Only quiet moves: the captures were all handed out already
+                if (killer == hints.hash_move || (next_killer == 2 && killer == hints.killers[0]) ||
+                    picked_position.get_square(killer.to) != piece_code::empty) {
+                    continue;
+                }
+                if (is_playable(killer)) {
+                    picked_move = killer;
+                    picked_stage = stage::killers;
+                    return true;
+                }
+            }
+            current_stage = stage::countermove;
+            break;
+        case stage::countermove:
+            current_stage = stage::generate_quiet_moves;
+            if (hints.countermove != hints.hash_move && hints.countermove != hints.killers[0] &&
+                hints.countermove != hints.killers[1] && picked_position.get_square(hints.countermove.to) == piece_code::empty &&
+                is_playable(hints.countermove)) {
+                picked_move = hints.countermove;
+                picked_stage = stage::countermove;
+                return true;
+            }
+            break;
+        case stage::generate_quiet_moves:
+            picked_position.generate_quiet_moves(quiet_moves);
+            if (hints.history) {
+                for (size_t i{}; i < quiet_moves.size(); i++) {
+                    scores[i] = (*hints.history)[quiet_moves[i].from * 64 + quiet_moves[i].to];
+                }
+                move_ordering::sort_by_score(quiet_moves, scores);
+            }
+            next_move = 0;
+            current_stage = stage::quiet_moves;
+            break;
+        case stage::quiet_moves:
+            while (next_move < quiet_moves.size()) {
+                chess_move quiet_move{ quiet_moves[next_move++] };
+                if (!is_hint(quiet_move) && picked_position.is_legal(quiet_move)) {
+                    picked_move = quiet_move;
+                    picked_stage = stage::quiet_moves;
+                    return true;
+                }
+            }
+            next_move = 0;
+            current_stage = stage::bad_captures;
+            break;
+        case stage::bad_captures:
+            while (next_move < bad_captures_end) {
+                chess_move capture{ captures[next_move++] };
+                if (picked_position.is_legal(capture)) {
+                    picked_move = capture;
+                    picked_stage = stage::bad_captures;
+                    return true;
+                }
+            }
+            current_stage = stage::done;
+            break;
+        case stage::done:
+            return false;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+/*
+This file contains the definition of the move precomputer class. See move_precomputer.h
+*/
+
+#include "move_precomputer.h"
+#include "position.h"
+#include "tablebase.h"
+#include "thread_pool.h"
+#include <stdexcept>
+#include <string>
+
+namespace {
+    //Generate the tables of 3 pieces that the legal captures of the position lead to
+    void generate_capture_tables(position game_position, tablebase& endgame_tablebase, thread_pool& tablebase_pool) {
+        move_list moves;
+        game_position.generate_legal_moves(moves);
+        for (const chess_move& legal_move : moves) {
+            std::uint8_t captured{ game_position.make_move(legal_move) };
+            std::string material{ tablebase::material_of(game_position) };
+            game_position.unmake_move(legal_move, captured);
+            if (captured != piece_code::empty && material.size() == 3 && !endgame_tablebase.has_table(material)) {
+                endgame_tablebase.generate(material, tablebase_pool);
+            }
+        }
+    }
+}
+
+move_precomputer::~move_precomputer() {
+    cancel();
+}
+
+void move_precomputer::start(const game_session& session) {
+    cancel();
+    cancelled = false;
+    const game_session* started_session{ &session };
+    pending = worker.submit([this, started_session]() {
+        return started_session->compute_turn_moves(moves, cancelled);
+    });
+}
+
+void move_precomputer::start(const game_session& session, tablebase& endgame_tablebase, thread_pool& tablebase_pool) {
+    start(session);
+    //After the moves, as the worker runs one task at a time
+    position turn_position{ session.get_board().to_position(session.get_colour_turn()) };
+    pending_tables = worker.submit([turn_position, &endgame_tablebase, &tablebase_pool]() {
+        generate_capture_tables(turn_position, endgame_tablebase, tablebase_pool);
+    });
+}
+
+void move_precomputer::cancel() noexcept {
+    ready = false;
+    if (pending.valid()) {
+        cancelled = true;
+        pending.wait();
+        pending = std::future<bool>{};
+    }
+    if (pending_tables.valid()) {
+        pending_tables.wait();
+        pending_tables = std::future<void>{};
+    }
+}
+
+const turn_moves& move_precomputer::get() {
+    if (pending.valid()) {
+        ready = pending.get();
+    }
+    if (!ready) {
+        throw std::logic_error("The allowed moves were not computed!");
+    }
+    return moves;
+}
@@ -0,0 +1,420 @@
+/*
+This file contains the implementation of the packed occupancy kernels and of the runtime choice between them.
+The SSE2 and AVX2 versions are only compiled for x86 processors. With GCC and Clang they are compiled for their
+instruction set with a target attribute, so the rest of the program does not need to be built with -mavx2.
+*/
+
+#include "occupancy.h"
+#include "enum_attributes.h"
+#include "position.h"
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define OCCUPANCY_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(OCCUPANCY_X86) && (defined(__GNUC__) || defined(__clang__))
+#define OCCUPANCY_TARGET(instruction_set) __attribute__((target(instruction_set)))
+#else
+#define OCCUPANCY_TARGET(instruction_set)
+#endif
+
+namespace {
+    struct kernel_table {
+        occupancy::simd_level level;
+        occupancy_masks(*from_board_matrix)(const board_occupation*);
+        occupancy_masks(*from_squares)(const std::uint8_t*);
+        void(*popcount_batch)(const std::uint64_t*, size_t, std::uint8_t*);
+        bool(*squares_equal)(const std::uint8_t*, const std::uint8_t*);
+    };
+
+    //Scalar kernels
+    occupancy_masks scalar_from_board_matrix(const board_occupation* board_matrix) {
+        occupancy_masks masks;
+        for (int square{}; square < 64; square++) {
+            masks.white |= std::uint64_t{ board_matrix[square] == board_occupation::white_piece } << square;
+            masks.black |= std::uint64_t{ board_matrix[square] == board_occupation::black_piece } << square;
+        }
+        return masks;
+    }
+
+    occupancy_masks scalar_from_squares(const std::uint8_t* squares) {
+        occupancy_masks masks;
+        for (int square{}; square < 64; square++) {
+            bool black{ (squares[square] & piece_code::black_flag) != 0 };
+            masks.white |= std::uint64_t{ squares[square] != piece_code::empty && !black } << square;
+            masks.black |= std::uint64_t{ black } << square;
+        }
+        return masks;
+    }
+
+    void scalar_popcount_batch(const std::uint64_t* masks, size_t number_of_masks, std::uint8_t* counts) {
+        for (size_t i{}; i < number_of_masks; i++) {
+            counts[i] = static_cast<std::uint8_t>(std::bitset<64>(masks[i]).count());
+        }
+    }
+
+    bool scalar_squares_equal(const std::uint8_t* lhs, const std::uint8_t* rhs) {
+        return std::memcmp(lhs, rhs, 64) == 0;
+    }
+
+    constexpr kernel_table scalar_kernels{ occupancy::simd_level::scalar, scalar_from_board_matrix, scalar_from_squares,
+        scalar_popcount_batch, scalar_squares_equal };
+
+#ifdef OCCUPANCY_X86
+    //SSE2 kernels: 4 tiles of the board matrix or 16 squares of a position per instruction
+    OCCUPANCY_TARGET("sse2") occupancy_masks sse2_from_board_matrix(const board_occupation* board_matrix) {
+        static_assert(sizeof(board_occupation) == 4, "the board matrix kernels assume 4-byte tiles");
+        occupancy_masks masks;
+        const __m128i white{ _mm_set1_epi32(static_cast<int>(board_occupation::white_piece)) };
+        const __m128i black{ _mm_set1_epi32(static_cast<int>(board_occupation::black_piece)) };
+        for (int chunk{}; chunk < 16; chunk++) {
+            __m128i tiles{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(board_matrix + 4 * chunk)) };
+            std::uint64_t white_bits{ static_cast<std::uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(tiles, white)))) };
+            std::uint64_t black_bits{ static_cast<std::uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(tiles, black)))) };
+            masks.white |= white_bits << (4 * chunk);
+            masks.black |= black_bits << (4 * chunk);
+        }
+        return masks;
+    }
+
+    OCCUPANCY_TARGET("sse2") occupancy_masks sse2_from_squares(const std::uint8_t* squares) {
+        occupancy_masks masks;
+        const __m128i zero{ _mm_setzero_si128() };
+        const __m128i black_flag{ _mm_set1_epi8(static_cast<char>(piece_code::black_flag)) };
+        for (int chunk{}; chunk < 4; chunk++) {
+            __m128i codes{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(squares + 16 * chunk)) };
+            std::uint64_t empty_bits{ static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(codes, zero))) };
+            std::uint64_t black_bits{ static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(codes, black_flag), black_flag))) };
+            masks.white |= (~(empty_bits | black_bits) & 0xFFFF) << (16 * chunk);
+            masks.black |= black_bits << (16 * chunk);
+        }
+        return masks;
+    }
+
+    //Bit-parallel popcount of the two 64-bit lanes, with the byte sums added up by _mm_sad_epu8
+    OCCUPANCY_TARGET("sse2") void sse2_popcount_batch(const std::uint64_t* masks, size_t number_of_masks, std::uint8_t* counts) {
+        const __m128i mask_1{ _mm_set1_epi8(0x55) };
+        const __m128i mask_2{ _mm_set1_epi8(0x33) };
+        const __m128i mask_4{ _mm_set1_epi8(0x0F) };
+        size_t i{};
+        for (; i + 2 <= number_of_masks; i += 2) {
+            __m128i bits{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + i)) };
+            bits = _mm_sub_epi8(bits, _mm_and_si128(_mm_srli_epi64(bits, 1), mask_1));
+            bits = _mm_add_epi8(_mm_and_si128(bits, mask_2), _mm_and_si128(_mm_srli_epi64(bits, 2), mask_2));
+            bits = _mm_and_si128(_mm_add_epi8(bits, _mm_srli_epi64(bits, 4)), mask_4);
+            __m128i sums{ _mm_sad_epu8(bits, _mm_setzero_si128()) };
+            counts[i] = static_cast<std::uint8_t>(_mm_cvtsi128_si32(sums));
+            counts[i + 1] = static_cast<std::uint8_t>(_mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+        }
+        scalar_popcount_batch(masks + i, number_of_masks - i, counts + i);
+    }
+
+    OCCUPANCY_TARGET("sse2") bool sse2_squares_equal(const std::uint8_t* lhs, const std::uint8_t* rhs) {
+        __m128i equal{ _mm_set1_epi8(-1) };
+        for (int chunk{}; chunk < 4; chunk++) {
+            __m128i lhs_codes{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + 16 * chunk)) };
+            __m128i rhs_codes{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + 16 * chunk)) };
+            equal = _mm_and_si128(equal, _mm_cmpeq_epi8(lhs_codes, rhs_codes));
+        }
+        return _mm_movemask_epi8(equal) == 0xFFFF;
+    }
+
+    constexpr kernel_table sse2_kernels{ occupancy::simd_level::sse2, sse2_from_board_matrix, sse2_from_squares,
+        sse2_popcount_batch, sse2_squares_equal };
+
+    //AVX2 kernels: 8 tiles of the board matrix or 32 squares of a position per instruction
+    OCCUPANCY_TARGET("avx2") occupancy_masks avx2_from_board_matrix(const board_occupation* board_matrix) {
+        occupancy_masks masks;
+        const __m256i white{ _mm256_set1_epi32(static_cast<int>(board_occupation::white_piece)) };
+        const __m256i black{ _mm256_set1_epi32(static_cast<int>(board_occupation::black_piece)) };
+        for (int chunk{}; chunk < 8; chunk++) {
+            __m256i tiles{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(board_matrix + 8 * chunk)) };
+            std::uint64_t white_bits{ static_cast<std::uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(tiles, white)))) };
+            std::uint64_t black_bits{ static_cast<std::uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(tiles, black)))) };
+            masks.white |= white_bits << (8 * chunk);
+            masks.black |= black_bits << (8 * chunk);
+        }
+        return masks;
+    }
+
+    OCCUPANCY_TARGET("avx2") occupancy_masks avx2_from_squares(const std::uint8_t* squares) {
+        occupancy_masks masks;
+        const __m256i zero{ _mm256_setzero_si256() };
+        const __m256i black_flag{ _mm256_set1_epi8(static_cast<char>(piece_code::black_flag)) };
+        for (int chunk{}; chunk < 2; chunk++) {
+            __m256i codes{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(squares + 32 * chunk)) };
+            std::uint64_t empty_bits{ static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(codes, zero))) };
+            std::uint64_t black_bits{ static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(codes, black_flag), black_flag))) };
+            masks.white |= (~(empty_bits | black_bits) & 0xFFFFFFFF) << (32 * chunk);
+            masks.black |= black_bits << (32 * chunk);
+        }
+        return masks;
+    }
+
+    //Popcount of four 64-bit lanes with a 4-bit lookup table (vpshufb), with the byte sums added up by _mm256_sad_epu8
+    OCCUPANCY_TARGET("avx2") void avx2_popcount_batch(const std::uint64_t* masks, size_t number_of_masks, std::uint8_t* counts) {
+        const __m256i lookup{ _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                               0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4) };
+        const __m256i low_nibble{ _mm256_set1_epi8(0x0F) };
+        size_t i{};
+        for (; i + 4 <= number_of_masks; i += 4) {
+            __m256i bits{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks + i)) };
+            __m256i low_counts{ _mm256_shuffle_epi8(lookup, _mm256_and_si256(bits, low_nibble)) };
+            __m256i high_counts{ _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(bits, 4), low_nibble)) };
+            __m256i sums{ _mm256_sad_epu8(_mm256_add_epi8(low_counts, high_counts), _mm256_setzero_si256()) };
+            alignas(32) std::array<std::uint64_t, 4> lane_sums;
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lane_sums.data()), sums);
+            for (int lane{}; lane < 4; lane++) {
+                counts[i + lane] = static_cast<std::uint8_t>(lane_sums[lane]);
+            }
+        }
+        scalar_popcount_batch(masks + i, number_of_masks - i, counts + i);
+    }
+
+    OCCUPANCY_TARGET("avx2") bool avx2_squares_equal(const std::uint8_t* lhs, const std::uint8_t* rhs) {
+        __m256i first_half{ _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs)),
+                                              _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs))) };
+        __m256i second_half{ _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + 32)),
+                                               _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + 32))) };
+        return _mm256_movemask_epi8(_mm256_and_si256(first_half, second_half)) == -1;
+    }
+
+    constexpr kernel_table avx2_kernels{ occupancy::simd_level::avx2, avx2_from_board_matrix, avx2_from_squares,
+        avx2_popcount_batch, avx2_squares_equal };
+#endif
+
+    occupancy::simd_level detect_simd_level() noexcept {
+#if defined(OCCUPANCY_X86) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return occupancy::simd_level::avx2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return occupancy::simd_level::sse2;
+        }
+#elif defined(OCCUPANCY_X86) && defined(_MSC_VER)
+        int cpu_info[4];
+        __cpuid(cpu_info, 1);
+        bool sse2{ (cpu_info[3] & (1 << 26)) != 0 };
+        bool os_saves_avx{ (cpu_info[2] & (1 << 27)) != 0 && (cpu_info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6 };
+        __cpuidex(cpu_info, 7, 0);
+        if (os_saves_avx && (cpu_info[1] & (1 << 5)) != 0) {
+            return occupancy::simd_level::avx2;
+        }
+        if (sse2) {
+            return occupancy::simd_level::sse2;
+        }
+#endif
+        return occupancy::simd_level::scalar;
+    }
+
+    const kernel_table* kernels_for(const occupancy::simd_level& level) noexcept {
+#ifdef OCCUPANCY_X86
+        if (level == occupancy::simd_level::avx2) {
+            return &avx2_kernels;
+        }
+        if (level == occupancy::simd_level::sse2) {
+            return &sse2_kernels;
+        }
+#endif
+        return &scalar_kernels;
+    }
+
+    std::atomic<const kernel_table*> active_kernels{ nullptr };
+
+    const kernel_table& kernels() noexcept {
+        const kernel_table* table{ active_kernels.load(std::memory_order_relaxed) };
+        if (!table) {
+            table = kernels_for(occupancy::get_supported_simd_level());
+            active_kernels.store(table, std::memory_order_relaxed);
+        }
+        return *table;
+    }
+
+    //Bitboard attacks of the pieces, used to count the mobility
+    constexpr std::array<std::array<int, 2>, 8> direction_change{ { {0,1},{1,0},{1,1},{-1,1},{0,-1},{-1,0},{-1,-1},{1,-1} } };
+
+    constexpr std::array<std::array<std::uint64_t, 64>, 8> create_ray_masks() {
+        //The first four directions go towards higher squares and the last four towards lower squares
+        std::array<std::array<std::uint64_t, 64>, 8> rays{};
+        for (int direction{}; direction < 8; direction++) {
+            for (int square{}; square < 64; square++) {
+                int column{ square % 8 + direction_change[direction][0] };
+                int row{ square / 8 + direction_change[direction][1] };
+                while (0 <= column && column < 8 && 0 <= row && row < 8) {
+                    rays[direction][square] |= std::uint64_t{ 1 } << (8 * row + column);
+                    column += direction_change[direction][0];
+                    row += direction_change[direction][1];
+                }
+            }
+        }
+        return rays;
+    }
+
+    constexpr std::array<std::uint64_t, 64> create_step_masks(const std::array<std::array<int, 2>, 8>& steps) {
+        std::array<std::uint64_t, 64> step_masks{};
+        for (int square{}; square < 64; square++) {
+            for (const auto& step : steps) {
+                int column{ square % 8 + step[0] };
+                int row{ square / 8 + step[1] };
+                if (0 <= column && column < 8 && 0 <= row && row < 8) {
+                    step_masks[square] |= std::uint64_t{ 1 } << (8 * row + column);
+                }
+            }
+        }
+        return step_masks;
+    }
+
+    constexpr std::array<std::array<std::uint64_t, 64>, 8> ray_masks{ create_ray_masks() };
+    constexpr std::array<std::uint64_t, 64> knight_masks{ create_step_masks({ { {1,2},{2,1},{2,-1},{1,-2},{-1,-2},{-2,-1},{-2,1},{-1,2} } }) };
+    constexpr std::array<std::uint64_t, 64> king_masks{ create_step_masks({ { {0,1},{1,1},{1,0},{1,-1},{0,-1},{-1,-1},{-1,0},{-1,1} } }) };
+
+    int lowest_bit(const std::uint64_t& mask) noexcept {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return static_cast<int>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(mask);
+#else
+        int index{};
+        while (!((mask >> index) & 1)) index++;
+        return index;
+#endif
+    }
+
+    int highest_bit(const std::uint64_t& mask) noexcept {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanReverse64(&index, mask);
+        return static_cast<int>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(mask);
+#else
+        int index{ 63 };
+        while (!((mask >> index) & 1)) index--;
+        return index;
+#endif
+    }
+
+    std::uint64_t ray_attacks(const int& direction, const int& square, const std::uint64_t& occupied) noexcept {
+        std::uint64_t ray{ ray_masks[direction][square] };
+        std::uint64_t blockers{ ray & occupied };
+        if (!blockers) {
+            return ray;
+        }
+        int first_blocker{ direction < 4 ? lowest_bit(blockers) : highest_bit(blockers) };
+        return ray ^ ray_masks[direction][first_blocker];
+    }
+
+    std::uint64_t piece_targets(const piece_symbol& symbol, const int& square, const std::uint64_t& occupied) noexcept {
+        std::uint64_t targets{};
+        switch (symbol) {
+        case piece_symbol::knight:
+            return knight_masks[square];
+        case piece_symbol::king:
+            return king_masks[square];
+        case piece_symbol::rook:
+            for (int direction : { 0, 1, 4, 5 }) targets |= ray_attacks(direction, square, occupied);
+            return targets;
+        case piece_symbol::bishop:
+            for (int direction : { 2, 3, 6, 7 }) targets |= ray_attacks(direction, square, occupied);
+            return targets;
+        case piece_symbol::queen:
+            for (int direction{}; direction < 8; direction++) targets |= ray_attacks(direction, square, occupied);
+            return targets;
+        default:
+            return targets;
+        }
+    }
+}
+
+namespace occupancy {
+    simd_level get_supported_simd_level() noexcept {
+        static const simd_level supported_level{ detect_simd_level() };
+        return supported_level;
+    }
+
+    simd_level get_simd_level() noexcept {
+        return kernels().level;
+    }
+
+    void set_simd_level(const simd_level& level) noexcept {
+        simd_level supported_level{ get_supported_simd_level() };
+        active_kernels.store(kernels_for(static_cast<int>(level) < static_cast<int>(supported_level) ? level : supported_level));
+    }
+
+    const char* simd_level_name(const simd_level& level) noexcept {
+        switch (level) {
+        case simd_level::avx2: return "avx2";
+        case simd_level::sse2: return "sse2";
+        default: return "scalar";
+        }
+    }
+
+    occupancy_masks from_board_matrix(const std::array<board_occupation, 64>& board_matrix) noexcept {
+        return kernels().from_board_matrix(board_matrix.data());
+    }
+
+    occupancy_masks from_squares(const std::array<std::uint8_t, 64>& squares) noexcept {
+        return kernels().from_squares(squares.data());
+    }
+
+    void popcount_batch(const std::uint64_t* masks, const size_t& number_of_masks, std::uint8_t* counts) noexcept {
+        kernels().popcount_batch(masks, number_of_masks, counts);
+    }
+
+    bool positions_equal(const position& lhs, const position& rhs) noexcept {
+        return lhs.get_colour_turn() == rhs.get_colour_turn() && kernels().squares_equal(lhs.get_squares().data(), rhs.get_squares().data());
+    }
+
+    size_t count_equal_positions(const position& needle, const std::vector<position>& batch) noexcept {
+        const kernel_table& table{ kernels() };
+        size_t number_equal{};
+        for (const position& candidate : batch) {
+            number_equal += candidate.get_colour_turn() == needle.get_colour_turn() && table.squares_equal(needle.get_squares().data(), candidate.get_squares().data());
+        }
+        return number_equal;
+    }
+
+    void batch_mobility(const std::vector<position>& positions, std::vector<int>& mobility) {
+        //First the target masks of every piece of every position are gathered, then they are all counted at once
+        const kernel_table& table{ kernels() };
+        std::vector<std::uint64_t> target_masks;
+        std::vector<size_t> first_mask_of_position;
+        target_masks.reserve(16 * positions.size());
+        first_mask_of_position.reserve(positions.size() + 1);
+        for (const position& batch_position : positions) {
+            first_mask_of_position.push_back(target_masks.size());
+            occupancy_masks masks{ table.from_squares(batch_position.get_squares().data()) };
+            std::uint64_t own{ batch_position.get_colour_turn() == piece_colour::white ? masks.white : masks.black };
+            std::uint64_t occupied{ masks.white | masks.black };
+            for (std::uint64_t pieces{ own }; pieces; pieces &= pieces - 1) {
+                int square{ lowest_bit(pieces) };
+                piece_symbol symbol{ piece_code::symbol_of(batch_position.get_square(square)) };
+                if (symbol != piece_symbol::pawn) {
+                    target_masks.push_back(piece_targets(symbol, square, occupied) & ~own);
+                }
+            }
+        }
+        first_mask_of_position.push_back(target_masks.size());
+        std::vector<std::uint8_t> counts(target_masks.size());
+        table.popcount_batch(target_masks.data(), target_masks.size(), counts.data());
+        mobility.assign(positions.size(), 0);
+        for (size_t i{}; i < positions.size(); i++) {
+            for (size_t mask{ first_mask_of_position[i] }; mask < first_mask_of_position[i + 1]; mask++) {
+                mobility[i] += counts[mask];
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+/*
+This file contains the implementation of the opening book.
+*/
+
+#include "opening_book.h"
+#include "mapped_file.h"
+#include "position.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    constexpr char book_magic[8]{ 'C', 'C', 'B', 'O', 'O', 'K', 0, 1 };
+
+    struct book_header {
+        char magic[8];
+        std::uint64_t number_of_entries;
+    };
+
+    static_assert(sizeof(book_header) == 16, "The book header must be 16 bytes to match the file format.");
+
+    //Interpolation steps before switching to binary search, which bounds the cost if the hashes are not uniform
+    constexpr int max_interpolation_steps{ 4 };
+}
+
+opening_book::opening_book(const std::string& path)
+    : file{ path, mapped_file::access::read_only }
+{
+    if (file.get_status() == mapped_file::status::not_opened) {
+        throw std::runtime_error("Error: could not open the opening book " + path + ".");
+    }
+    if (file.get_status() != mapped_file::status::mapped || file.size() < sizeof(book_header)) {
+        close();
+        throw std::runtime_error("Error: the opening book " + path + " is too short or could not be mapped.");
+    }
+    book_header header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, book_magic, sizeof(book_magic)) != 0 ||
+        header.number_of_entries != (file.size() - sizeof(book_header)) / sizeof(book_entry) ||
+        (file.size() - sizeof(book_header)) % sizeof(book_entry) != 0) {
+        close();
+        throw std::runtime_error("Error: " + path + " is not a valid opening book.");
+    }
+    entries = reinterpret_cast<const book_entry*>(static_cast<const unsigned char*>(file.data()) + sizeof(book_header));
+    number_of_entries = static_cast<size_t>(header.number_of_entries);
+}
+
+opening_book::~opening_book() {
+    close();
+}
+
+opening_book::opening_book(opening_book&& other) noexcept {
+    *this = std::move(other);
+}
+
+opening_book& opening_book::operator=(opening_book&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(file, other.file);
+        std::swap(entries, other.entries);
+        std::swap(number_of_entries, other.number_of_entries);
+    }
+    return *this;
+}
+
+void opening_book::close() noexcept {
+    file = mapped_file{};
+    entries = nullptr;
+    number_of_entries = 0;
+}
+
+const book_entry* opening_book::lower_bound(const std::uint64_t& hash) const noexcept {
+    //The first entry with a hash not less than the given one is always in [low, high]
+    size_t low{};
+    size_t high{ number_of_entries };
+    for (int step{}; step < max_interpolation_steps && high - low > 8; step++) {
+        std::uint64_t low_hash{ entries[low].hash };
+        std::uint64_t high_hash{ entries[high - 1].hash };
+        if (hash <= low_hash) {
+            return entries + low;
+        }
+        if (hash > high_hash) {
+            return entries + high;
+        }
+        double fraction{ static_cast<double>(hash - low_hash) / static_cast<double>(high_hash - low_hash) };
+        size_t probe{ low + std::min(high - 1 - low, static_cast<size_t>(fraction * static_cast<double>(high - 1 - low))) };
+        if (entries[probe].hash < hash) {
+            low = probe + 1;
+        }
+        else {
+            high = probe;
+        }
+    }
+    return std::lower_bound(entries + low, entries + high, hash, [](const book_entry& entry, const std::uint64_t& value) {
+        return entry.hash < value;
+    });
+}
+
+const book_entry* opening_book::find(const std::uint64_t& hash, size_t& number_of_moves) const noexcept {
+    const book_entry* first{ lower_bound(hash) };
+    const book_entry* last{ first };
+    while (last != entries + number_of_entries && last->hash == hash) {
+        last++;
+    }
+    number_of_moves = static_cast<size_t>(last - first);
+    return first;
+}
+
+bool opening_book::pick_move(const position& book_position, const std::uint64_t& random_value, chess_move& chosen_move) const {
+    size_t number_of_moves;
+    const book_entry* book_moves{ find(book_position.get_hash(), number_of_moves) };
+    if (number_of_moves == 0) {
+        return false;
+    }
+    move_list legal_moves;
+    book_position.generate_legal_moves(legal_moves);
+    auto is_legal_book_move = [&legal_moves](const book_entry& entry) {
+        return std::find(legal_moves.begin(), legal_moves.end(), chess_move{ entry.from, entry.to }) != legal_moves.end();
+    };
+    std::uint64_t total_weight{};
+    for (size_t i{}; i < number_of_moves; i++) {
+        if (is_legal_book_move(book_moves[i])) {
+            total_weight += book_moves[i].weight;
+        }
+    }
+    if (total_weight == 0) {
+        return false;
+    }
+    std::uint64_t target{ random_value % total_weight };
+    for (size_t i{}; i < number_of_moves; i++) {
+        if (!is_legal_book_move(book_moves[i])) {
+            continue;
+        }
+        if (target < book_moves[i].weight) {
+            chosen_move = { book_moves[i].from, book_moves[i].to };
+            return true;
+        }
+        target -= book_moves[i].weight;
+    }
+    return false;
+}
+
+void opening_book::write(const std::string& path, std::vector<book_entry> book_entries) {
+    std::sort(book_entries.begin(), book_entries.end(), [](const book_entry& lhs, const book_entry& rhs) {
+        return lhs.hash != rhs.hash ? lhs.hash < rhs.hash : (lhs.from != rhs.from ? lhs.from < rhs.from : lhs.to < rhs.to);
+    });
+    //Merge the repeated moves, keeping the weights within 16 bits
+    size_t number_of_unique_entries{};
+    for (const book_entry& entry : book_entries) {
+        if (number_of_unique_entries > 0) {
+            book_entry& last{ book_entries[number_of_unique_entries - 1] };
+            if (last.hash == entry.hash && last.from == entry.from && last.to == entry.to) {
+                last.weight = static_cast<std::uint16_t>(std::min<std::uint32_t>(0xFFFF, std::uint32_t{ last.weight } + entry.weight));
+                continue;
+            }
+        }
+        book_entries[number_of_unique_entries] = entry;
+        book_entries[number_of_unique_entries].unused = 0;
+        number_of_unique_entries++;
+    }
+    book_entries.resize(number_of_unique_entries);
+
+    opening_book_writer writer{ path };
+    for (const book_entry& entry : book_entries) {
+        writer.add(entry);
+    }
+    writer.finish();
+}
+
+opening_book_writer::opening_book_writer(const std::string& path_in) : path{ path_in } {
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Error: could not create the opening book " + path + ".");
+    }
+    //The header is written again with the number of entries by finish()
+    book_header header{};
+    std::memcpy(header.magic, book_magic, sizeof(book_magic));
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        std::fclose(file);
+        file = nullptr;
+        throw std::runtime_error("Error: could not write the opening book " + path + ".");
+    }
+}
+
+opening_book_writer::~opening_book_writer() {
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+void opening_book_writer::add(const book_entry& entry) {
+    if (!file || std::fwrite(&entry, sizeof(entry), 1, file) != 1) {
+        throw std::runtime_error("Error: could not write the opening book " + path + ".");
+    }
+    number_of_entries++;
+}
+
+void opening_book_writer::finish() {
+    if (!file) {
+        throw std::runtime_error("Error: the opening book " + path + " was already finished.");
+    }
+    book_header header{};
+    std::memcpy(header.magic, book_magic, sizeof(book_magic));
+    header.number_of_entries = number_of_entries;
+    bool written{ std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1 };
+    bool closed{ std::fclose(file) == 0 };
+    file = nullptr;
+    if (!written || !closed) {
+        throw std::runtime_error("Error: could not write the opening book " + path + ".");
+    }
+}
@@ -0,0 +1,62 @@
+/*
+This file contains the implementation of the move ordering tables. See ordering_tables.h
+*/
+
+#include "ordering_tables.h"
+#include "position.h"
+#include "enum_attributes.h"
+#include <algorithm>
+#include <cstdlib>
+
+void killer_table::add(const int& ply, const chess_move& cutoff_move) noexcept {
+    std::array<chess_move, 2>& ply_killers{ killers[ply] };
+    if (ply_killers[0] != cutoff_move) {
+        ply_killers[1] = ply_killers[0];
+        ply_killers[0] = cutoff_move;
+    }
+}
+
+void killer_table::clear() noexcept {
+    killers.fill({ no_move, no_move });
+}
+
+void history_table::update(const piece_colour& colour, const chess_move& quiet_move, const int& bonus) noexcept {
+    int& score{ scores[static_cast<int>(colour)][quiet_move.from * 64 + quiet_move.to] };
+    //The closer the score already is to the end it moves towards, the less it moves, so it never leaves the bounds
+    score += bonus - score * std::abs(bonus) / max_history_score;
+}
+
+void history_table::age() noexcept {
+    for (std::array<int, 64 * 64>& colour_scores : scores) {
+        for (int& score : colour_scores) {
+            score /= 2;
+        }
+    }
+}
+
+void history_table::clear() noexcept {
+    for (std::array<int, 64 * 64>& colour_scores : scores) {
+        colour_scores.fill(0);
+    }
+}
+
+int history_table::depth_bonus(const int& depth) noexcept {
+    return std::min(depth * depth * 16, max_history_score / 4);
+}
+
+void countermove_table::clear() noexcept {
+    for (std::array<chess_move, 64>& piece_countermoves : countermoves) {
+        piece_countermoves.fill(no_move);
+    }
+}
+
+void ordering_tables::new_search() noexcept {
+    killers.clear();
+    history.age();
+}
+
+void ordering_tables::clear() noexcept {
+    killers.clear();
+    history.clear();
+    countermoves.clear();
+}
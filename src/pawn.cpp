@@ -19,7 +19,7 @@ pawn::pawn() {
 pawn::pawn(const char& column, const piece_colour& colour_in) {
     //std::cout << "Pawn parametrised constructor called." << std::endl;
     try {
-        int column_number{ coordinates::alphabetical_dictionary.at(column) };
+        int column_number{ coordinates::column_number(column) };
     }
     catch (const std::out_of_range&) {
         throw std::out_of_range("Error: columns go from 'a' to 'h'.");
@@ -33,46 +33,44 @@ pawn::pawn(const char& column, const piece_colour& colour_in) {
     symbol = piece_symbol::pawn;
 }
 
+pawn::pawn(const std::pair<char, int>& location_in, const piece_colour& colour_in)
+    : piece{ location_in, colour_in, piece_symbol::pawn }
+{
+}
+
 pawn::~pawn() {
-    //std::cout << "Destructor of pawn of colour " << colour_string_map.at(colour) << " called at position " << location.first << location.second << "." << std::endl;
+    //std::cout << "Destructor of pawn of colour " << colour_string(colour) << " called at position " << location.first << location.second << "." << std::endl;
 }
 
 std::list<int> pawn::get_allowed_moves(const std::array<board_occupation, 64>& board_matrix) const {
     std::list<int> allowed_moves;
     int current_location{ coordinates::flatten_board_coordinates(location) };
-    const std::map<piece_colour, int> step_forward{ {piece_colour::white,8},{piece_colour::black,-8} };
+    constexpr std::array<int, 2> step_forward{ 8, -8 }; //indexed by piece_colour
 
-    int forward{ current_location + step_forward.at(colour) };
-    if (coordinates::in_board_range(forward) && board_matrix.at(forward - 1) == board_occupation::empty) {
-        allowed_moves.push_back(forward);
+    int forward{ current_location + step_forward[static_cast<int>(colour)] };
+    if (!coordinates::in_board_range(forward)) { //There is no promotion, so a pawn on the last row cannot move
+        return allowed_moves;
     }
+    if (board_matrix.at(forward - 1) == board_occupation::empty) {
+        allowed_moves.push_back(forward);
 
-    //If in starting position, pawn can move two forward
-    bool starting_position{ (colour == piece_colour::white) ? location.second == 2 : location.second == 7 };
-    if (starting_position) {
-        int forward_two{ current_location + 2 * step_forward.at(colour) };
-        if (coordinates::in_board_range(forward_two) && board_matrix.at(forward_two - 1) == board_occupation::empty) {
-            allowed_moves.push_back(forward_two);
+        //If in starting position, pawn can move two forward, as long as the tile in between is empty too
+        bool starting_position{ (colour == piece_colour::white) ? location.second == 2 : location.second == 7 };
+        if (starting_position) {
+            int forward_two{ current_location + 2 * step_forward[static_cast<int>(colour)] };
+            if (board_matrix.at(forward_two - 1) == board_occupation::empty) {
+                allowed_moves.push_back(forward_two);
+            }
         }
     }
 
-    //Possibility of moving diagonally to capture a piece of opposite colour
-    board_occupation occupation_right_diagonal{ board_matrix.at(forward + 1 - 1) };
-    board_occupation occupation_left_diagonal{ board_matrix.at(forward - 1 - 1) };
-    if (coordinates::in_board_range(forward + 1) && static_cast<int>(occupation_right_diagonal) == static_cast<int>(opposite_colour.at(colour))) {
+    //Possibility of moving diagonally to capture a piece of opposite colour, without going off the board on the left or right edges
+    int column{ coordinates::get_column_number(current_location) };
+    if (column < 8 && static_cast<int>(board_matrix.at(forward + 1 - 1)) == static_cast<int>(opposite_colour(colour))) {
         allowed_moves.push_back(forward + 1);
     }
-    if (coordinates::in_board_range(forward - 1) && static_cast<int>(occupation_left_diagonal) == static_cast<int>(opposite_colour.at(colour))) {
+    if (column > 1 && static_cast<int>(board_matrix.at(forward - 1 - 1)) == static_cast<int>(opposite_colour(colour))) {
         allowed_moves.push_back(forward - 1);
     }
     return allowed_moves;
-}
-
-std::string pawn::get_symbol_string(const bool& on_white_tile) const noexcept {
-    if (on_white_tile) {
-        return (colour == piece_colour::white) ? u8"♙" : u8"♟";
-    }
-    else {
-        return (colour == piece_colour::white) ? u8"♟" : u8"♙";
-    }
 }
\ No newline at end of file
@@ -5,17 +5,37 @@ This code contains the implementation of the abstract base class piece, interfac
 
 #include "piece.h"
 #include "board.h"
+#include "pawn.h"
+#include "rook.h"
+#include "knight.h"
+#include "bishop.h"
+#include "king.h"
+#include "queen.h"
 #include "coordinate_transforms.h"
 #include "enum_attributes.h"
+#include "console_visualisation.h"
 #include <algorithm>
 #include <list>
 #include <array>
+#include <memory>
+#include <stdexcept>
 
 piece::piece() {
     //std::cout << "Piece default constructor called." << std::endl;
     number_of_pieces++;
 }
 
+piece::piece(const std::pair<char, int>& location_in, const piece_colour& colour_in, const piece_symbol& symbol_in) {
+    coordinates::flatten_board_coordinates(location_in); //Throws std::out_of_range if the coordinates are off the board
+    if (colour_in != piece_colour::white && colour_in != piece_colour::black) {
+        throw std::invalid_argument("Error: invalid colour.");
+    }
+    location = location_in;
+    colour = colour_in;
+    symbol = symbol_in;
+    number_of_pieces++;
+}
+
 piece::~piece() {
     number_of_pieces--;
     //std::cout << "Destructor of base class piece at location " << location.first << location.second 
@@ -41,10 +61,32 @@ void piece::set_to_location(const int& new_location, const std::array<board_occu
     location = coordinates::to_board_coordinates(new_location); //Convert int to board coodinates
 }
 
+std::string_view piece::get_symbol_string(const bool& on_white_tile) const noexcept {
+    return get_piece_symbol_string(colour, symbol, on_white_tile);
+}
+
 piece_colour piece::get_colour() const noexcept {
     return colour;
 }
 
 piece_symbol piece::get_symbol() const noexcept {
     return symbol;
+}
+
+std::unique_ptr<piece> create_piece(const piece_symbol& symbol, const std::pair<char, int>& location, const piece_colour& colour) {
+    switch (symbol) {
+    case piece_symbol::pawn:
+        return std::make_unique<pawn>(location, colour);
+    case piece_symbol::rook:
+        return std::make_unique<rook>(location, colour);
+    case piece_symbol::knight:
+        return std::make_unique<knight>(location, colour);
+    case piece_symbol::bishop:
+        return std::make_unique<bishop>(location, colour);
+    case piece_symbol::king:
+        return std::make_unique<king>(location, colour);
+    case piece_symbol::queen:
+        return std::make_unique<queen>(location, colour);
+    }
+    throw std::invalid_argument("Error: invalid piece symbol.");
 }
\ No newline at end of file
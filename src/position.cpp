@@ -0,0 +1,576 @@
+/*
+This file contains the implementation of the position class. The knight and king targets and the length of the rays
+of the sliding pieces are computed at compile time for every square.
+The generation is written once as templates on the colour, so that the pawn directions and rows and the piece codes
+of each side are constants, and the public functions choose the white or black version once per call.
+Every change of a square also updates the material and piece-square score with the tables of piece_square_tables.h,
+and the hash with the keys of zobrist.h.
+The static exchange evaluation finds the attackers of a square one at a time, the least valuable first, on the squares
+as they are: the pieces that already captured are only marked as removed, which uncovers the pieces behind them.
+*/
+
+#include "position.h"
+#include "enum_attributes.h"
+#include "piece_square_tables.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    struct step_targets {
+        std::array<std::int8_t, 8> squares{};
+        int count{};
+    };
+
+    constexpr std::array<step_targets, 64> create_step_targets(const std::array<std::array<int, 2>, 8>& steps) {
+        std::array<step_targets, 64> table{};
+        for (int square{}; square < 64; square++) {
+            for (const auto& step : steps) {
+                int column{ square % 8 + step[0] };
+                int row{ square / 8 + step[1] };
+                if (0 <= column && column < 8 && 0 <= row && row < 8) {
+                    table[square].squares[table[square].count++] = static_cast<std::int8_t>(8 * row + column);
+                }
+            }
+        }
+        return table;
+    }
+
+    constexpr std::array<step_targets, 64> knight_targets{ create_step_targets({ { {1,2},{2,1},{2,-1},{1,-2},{-1,-2},{-2,-1},{-2,1},{-1,2} } }) };
+    constexpr std::array<step_targets, 64> king_targets{ create_step_targets({ { {0,1},{1,1},{1,0},{1,-1},{0,-1},{-1,-1},{-1,0},{-1,1} } }) };
+
+    //Directions of the sliding pieces: the first four are those of the rook and the last four those of the bishop
+    constexpr std::array<int, 8> direction_step{ 8, -8, 1, -1, 9, 7, -7, -9 };
+    constexpr std::array<std::array<int, 2>, 8> direction_change{ { {0,1},{0,-1},{1,0},{-1,0},{1,1},{-1,1},{1,-1},{-1,-1} } };
+
+    constexpr std::array<std::array<int, 8>, 64> create_ray_lengths() {
+        std::array<std::array<int, 8>, 64> table{};
+        for (int square{}; square < 64; square++) {
+            for (int direction{}; direction < 8; direction++) {
+                int column{ square % 8 + direction_change[direction][0] };
+                int row{ square / 8 + direction_change[direction][1] };
+                while (0 <= column && column < 8 && 0 <= row && row < 8) {
+                    table[square][direction]++;
+                    column += direction_change[direction][0];
+                    row += direction_change[direction][1];
+                }
+            }
+        }
+        return table;
+    }
+
+    constexpr std::array<std::array<int, 8>, 64> ray_length{ create_ray_lengths() };
+
+    //Values of the static exchange evaluation, indexed by piece_symbol. The king is worth more than everything else, so
+    //that it only ends an exchange by capturing when nothing can capture it back
+    constexpr std::array<int, 6> exchange_value{ evaluation_tables::material_value[0], evaluation_tables::material_value[1],
+        evaluation_tables::material_value[2], evaluation_tables::material_value[3], 20000, evaluation_tables::material_value[5] };
+
+    //Everything about the generation that depends on the colour, known at compile time
+    template <piece_colour Us>
+    struct colour_traits {
+        static constexpr piece_colour them{ opposite_colour(Us) };
+        static constexpr int forward_step{ Us == piece_colour::white ? 8 : -8 };
+        static constexpr int starting_row{ Us == piece_colour::white ? 1 : 6 };
+        static constexpr int last_row{ Us == piece_colour::white ? 7 : 0 }; //No promotion: a pawn on the last row cannot move
+        //Diagonal steps of the pawn captures, towards the left and right columns
+        static constexpr int capture_left{ forward_step - 1 };
+        static constexpr int capture_right{ forward_step + 1 };
+        static constexpr std::uint8_t pawn{ piece_code::make(Us, piece_symbol::pawn) };
+        static constexpr std::uint8_t rook{ piece_code::make(Us, piece_symbol::rook) };
+        static constexpr std::uint8_t knight{ piece_code::make(Us, piece_symbol::knight) };
+        static constexpr std::uint8_t bishop{ piece_code::make(Us, piece_symbol::bishop) };
+        static constexpr std::uint8_t king{ piece_code::make(Us, piece_symbol::king) };
+        static constexpr std::uint8_t queen{ piece_code::make(Us, piece_symbol::queen) };
+
+        //The codes of a colour are 6 consecutive numbers, so one unsigned comparison tells whether a square holds one of them
+        static constexpr bool is_own(const std::uint8_t& code) noexcept {
+            return static_cast<std::uint8_t>(code - pawn) < 6;
+        }
+    };
+
+    std::uint8_t fen_char_to_code(const char& fen_char) {
+        piece_colour colour{ std::isupper(static_cast<unsigned char>(fen_char)) ? piece_colour::white : piece_colour::black };
+        switch (std::tolower(static_cast<unsigned char>(fen_char))) {
+        case 'p': return piece_code::make(colour, piece_symbol::pawn);
+        case 'r': return piece_code::make(colour, piece_symbol::rook);
+        case 'n': return piece_code::make(colour, piece_symbol::knight);
+        case 'b': return piece_code::make(colour, piece_symbol::bishop);
+        case 'k': return piece_code::make(colour, piece_symbol::king);
+        case 'q': return piece_code::make(colour, piece_symbol::queen);
+        }
+        throw std::invalid_argument(std::string("Error: invalid FEN piece character '") + fen_char + "'.");
+    }
+
+    char code_to_fen_char(const std::uint8_t& code) {
+        constexpr std::array<char, 6> fen_chars{ 'p', 'r', 'n', 'b', 'k', 'q' };
+        char fen_char{ fen_chars[static_cast<int>(piece_code::symbol_of(code))] };
+        return piece_code::colour_of(code) == piece_colour::white ? static_cast<char>(std::toupper(fen_char)) : fen_char;
+    }
+}
+
+position::position() : position("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1") {}
+
+position::position(const std::string& fen) {
+    std::array<int, 2> number_of_kings{};
+    int row{ 7 };
+    int column{};
+    size_t index{};
+    for (; index < fen.size() && fen[index] != ' '; index++) {
+        const char& fen_char{ fen[index] };
+        if (fen_char == '/') {
+            if (column != 8 || row == 0) {
+                throw std::invalid_argument("Error: FEN must describe 8 rows of 8 tiles.");
+            }
+            row--;
+            column = 0;
+        }
+        else if (std::isdigit(static_cast<unsigned char>(fen_char))) {
+            column += fen_char - '0';
+        }
+        else {
+            if (column > 7) {
+                throw std::invalid_argument("Error: FEN must describe 8 rows of 8 tiles.");
+            }
+            std::uint8_t code{ fen_char_to_code(fen_char) };
+            squares[8 * row + column] = code;
+            add_square_value(code, 8 * row + column, 1);
+            if (piece_code::symbol_of(code) == piece_symbol::king) {
+                number_of_kings[static_cast<int>(piece_code::colour_of(code))]++;
+                king_square[static_cast<int>(piece_code::colour_of(code))] = 8 * row + column;
+            }
+            column++;
+        }
+        if (column > 8) {
+            throw std::invalid_argument("Error: FEN must describe 8 rows of 8 tiles.");
+        }
+    }
+    if (row != 0 || column != 8) {
+        throw std::invalid_argument("Error: FEN must describe 8 rows of 8 tiles.");
+    }
+    if (number_of_kings[0] != 1 || number_of_kings[1] != 1) {
+        throw std::invalid_argument("Error: FEN must contain exactly one king of each colour.");
+    }
+    if (index + 1 < fen.size()) {
+        if (fen[index + 1] == 'b') {
+            colour_turn = piece_colour::black;
+            hash ^= zobrist::black_to_move;
+        }
+        else if (fen[index + 1] != 'w') {
+            throw std::invalid_argument("Error: the colour turn in the FEN must be 'w' or 'b'.");
+        }
+    }
+}
+
+position::position(const std::array<std::uint8_t, 64>& squares_in, const piece_colour& colour_turn_in) : squares{ squares_in } {
+    std::array<int, 2> number_of_kings{};
+    for (int square{}; square < 64; square++) {
+        const std::uint8_t& code{ squares[square] };
+        if (code == piece_code::empty) {
+            continue;
+        }
+        add_square_value(code, square, 1);
+        if (piece_code::symbol_of(code) == piece_symbol::king) {
+            number_of_kings[static_cast<int>(piece_code::colour_of(code))]++;
+            king_square[static_cast<int>(piece_code::colour_of(code))] = square;
+        }
+    }
+    if (number_of_kings[0] != 1 || number_of_kings[1] != 1) {
+        throw std::invalid_argument("Error: a position must contain exactly one king of each colour.");
+    }
+    set_colour_turn(colour_turn_in);
+}
+
+void position::add_square_value(const std::uint8_t& code, const int& square, const int& sign) noexcept {
+    const evaluation_tables::square_value& value{ evaluation_tables::square_values[code][square] };
+    material_pst.middlegame += sign * value.middlegame;
+    material_pst.endgame += sign * value.endgame;
+    material_pst.phase += sign * value.phase;
+    hash ^= zobrist::piece_square[code][square]; //adding and removing a piece are the same XOR
+}
+
+std::string position::to_fen() const {
+    std::string fen;
+    for (int row{ 7 }; row >= 0; row--) {
+        int empty_squares{};
+        for (int column{}; column < 8; column++) {
+            std::uint8_t code{ squares[8 * row + column] };
+            if (code == piece_code::empty) {
+                empty_squares++;
+                continue;
+            }
+            if (empty_squares) {
+                fen += static_cast<char>('0' + empty_squares);
+                empty_squares = 0;
+            }
+            fen += code_to_fen_char(code);
+        }
+        if (empty_squares) {
+            fen += static_cast<char>('0' + empty_squares);
+        }
+        if (row) {
+            fen += '/';
+        }
+    }
+    fen += (colour_turn == piece_colour::white) ? " w - - 0 1" : " b - - 0 1";
+    return fen;
+}
+
+void position::set_square(const int& square, const std::uint8_t& code) {
+    if (square < 0 || square > 63) {
+        throw std::out_of_range("Error: square must be in range from 0 to 63.");
+    }
+    if ((squares[square] != piece_code::empty && piece_code::symbol_of(squares[square]) == piece_symbol::king) ||
+        (code != piece_code::empty && piece_code::symbol_of(code) == piece_symbol::king)) {
+        throw std::invalid_argument("Error: kings cannot be added or removed from a position.");
+    }
+    add_square_value(squares[square], square, -1);
+    squares[square] = code;
+    add_square_value(code, square, 1);
+}
+
+void position::set_colour_turn(const piece_colour& colour) noexcept {
+    if (colour != colour_turn) {
+        hash ^= zobrist::black_to_move;
+    }
+    colour_turn = colour;
+}
+
+template <piece_colour By>
+bool position::is_attacked_by(const int& square) const noexcept {
+    using by = colour_traits<By>;
+    int column{ square % 8 };
+    //Pawns attack diagonally forward, so look for them diagonally backwards from the point of view of the attacker
+    if (column > 0 && 0 <= square - by::capture_right && square - by::capture_right < 64 && squares[square - by::capture_right] == by::pawn) return true;
+    if (column < 7 && 0 <= square - by::capture_left && square - by::capture_left < 64 && squares[square - by::capture_left] == by::pawn) return true;
+    const step_targets& knight_squares{ knight_targets[square] };
+    for (int i{}; i < knight_squares.count; i++) {
+        if (squares[knight_squares.squares[i]] == by::knight) return true;
+    }
+    const step_targets& king_squares{ king_targets[square] };
+    for (int i{}; i < king_squares.count; i++) {
+        if (squares[king_squares.squares[i]] == by::king) return true;
+    }
+    for (int direction{}; direction < 8; direction++) {
+        const std::uint8_t slider{ direction < 4 ? by::rook : by::bishop };
+        int target{ square };
+        for (int step{}; step < ray_length[square][direction]; step++) {
+            target += direction_step[direction];
+            if (squares[target] == piece_code::empty) {
+                continue;
+            }
+            if (squares[target] == slider || squares[target] == by::queen) {
+                return true;
+            }
+            break;
+        }
+    }
+    return false;
+}
+
+bool position::is_attacked(const int& square, const piece_colour& by_colour) const noexcept {
+    return by_colour == piece_colour::white ? is_attacked_by<piece_colour::white>(square) : is_attacked_by<piece_colour::black>(square);
+}
+
+bool position::in_check() const noexcept {
+    return is_attacked(king_square[static_cast<int>(colour_turn)], opposite_colour(colour_turn));
+}
+
+template <piece_colour Us, position::move_kind Kind>
+void position::generate_piece_moves_for(const int& from, move_list& moves) const {
+    using us = colour_traits<Us>;
+    const std::uint8_t code{ squares[from] };
+    auto add_quiet_move = [&](const int& to) {
+        if constexpr (Kind != move_kind::captures) {
+            moves.push_back({ static_cast<std::uint8_t>(from), static_cast<std::uint8_t>(to) });
+        }
+    };
+    auto add_capture = [&](const int& to) {
+        if constexpr (Kind != move_kind::quiets) {
+            moves.push_back({ static_cast<std::uint8_t>(from), static_cast<std::uint8_t>(to) });
+        }
+    };
+    auto add_if_free_or_enemy = [&](const int& to) {
+        if (squares[to] == piece_code::empty) {
+            add_quiet_move(to);
+        }
+        else if (!us::is_own(squares[to])) {
+            add_capture(to);
+        }
+    };
+    switch (piece_code::symbol_of(code)) {
+    case piece_symbol::pawn: {
+        int row{ from / 8 };
+        int column{ from % 8 };
+        if (row == us::last_row) {
+            break;
+        }
+        int forward{ from + us::forward_step };
+        if (squares[forward] == piece_code::empty) {
+            add_quiet_move(forward);
+            if (row == us::starting_row && squares[forward + us::forward_step] == piece_code::empty) {
+                add_quiet_move(forward + us::forward_step);
+            }
+        }
+        if (column > 0 && colour_traits<us::them>::is_own(squares[from + us::capture_left])) {
+            add_capture(from + us::capture_left);
+        }
+        if (column < 7 && colour_traits<us::them>::is_own(squares[from + us::capture_right])) {
+            add_capture(from + us::capture_right);
+        }
+        break;
+    }
+    case piece_symbol::knight:
+        for (int i{}; i < knight_targets[from].count; i++) {
+            add_if_free_or_enemy(knight_targets[from].squares[i]);
+        }
+        break;
+    case piece_symbol::king:
+        for (int i{}; i < king_targets[from].count; i++) {
+            add_if_free_or_enemy(king_targets[from].squares[i]);
+        }
+        break;
+    default: { //Sliding pieces
+        piece_symbol symbol{ piece_code::symbol_of(code) };
+        int first_direction{ symbol == piece_symbol::bishop ? 4 : 0 };
+        int last_direction{ symbol == piece_symbol::rook ? 4 : 8 };
+        for (int direction{ first_direction }; direction < last_direction; direction++) {
+            int to{ from };
+            for (int step{}; step < ray_length[from][direction]; step++) {
+                to += direction_step[direction];
+                if (squares[to] == piece_code::empty) {
+                    add_quiet_move(to);
+                    continue;
+                }
+                if (!us::is_own(squares[to])) {
+                    add_capture(to);
+                }
+                break;
+            }
+        }
+        break;
+    }
+    }
+}
+
+template <piece_colour Us, position::move_kind Kind>
+void position::generate_pseudo_legal_moves_for(move_list& moves) const {
+    for (int square{}; square < 64; square++) {
+        if (colour_traits<Us>::is_own(squares[square])) {
+            generate_piece_moves_for<Us, Kind>(square, moves);
+        }
+    }
+}
+
+template <piece_colour Us>
+void position::generate_legal_moves_for(move_list& moves) const {
+    move_list pseudo_legal_moves;
+    generate_pseudo_legal_moves_for<Us>(pseudo_legal_moves);
+    //One copy for all the moves, each one made and unmade in turn
+    position copy{ *this };
+    for (const chess_move& pseudo_legal_move : pseudo_legal_moves) {
+        std::uint8_t captured{ copy.make_move(pseudo_legal_move) };
+        if (!copy.is_attacked_by<colour_traits<Us>::them>(copy.king_square[static_cast<int>(Us)])) {
+            moves.push_back(pseudo_legal_move);
+        }
+        copy.unmake_move(pseudo_legal_move, captured);
+    }
+}
+
+void position::generate_piece_moves(const int& from, move_list& moves) const {
+    if (squares[from] == piece_code::empty) {
+        return;
+    }
+    if (piece_code::colour_of(squares[from]) == piece_colour::white) {
+        generate_piece_moves_for<piece_colour::white>(from, moves);
+    }
+    else {
+        generate_piece_moves_for<piece_colour::black>(from, moves);
+    }
+}
+
+void position::generate_pseudo_legal_moves(move_list& moves) const {
+    moves.clear();
+    if (colour_turn == piece_colour::white) {
+        generate_pseudo_legal_moves_for<piece_colour::white>(moves);
+    }
+    else {
+        generate_pseudo_legal_moves_for<piece_colour::black>(moves);
+    }
+}
+
+void position::generate_captures(move_list& moves) const {
+    moves.clear();
+    if (colour_turn == piece_colour::white) {
+        generate_pseudo_legal_moves_for<piece_colour::white, move_kind::captures>(moves);
+    }
+    else {
+        generate_pseudo_legal_moves_for<piece_colour::black, move_kind::captures>(moves);
+    }
+}
+
+void position::generate_quiet_moves(move_list& moves) const {
+    moves.clear();
+    if (colour_turn == piece_colour::white) {
+        generate_pseudo_legal_moves_for<piece_colour::white, move_kind::quiets>(moves);
+    }
+    else {
+        generate_pseudo_legal_moves_for<piece_colour::black, move_kind::quiets>(moves);
+    }
+}
+
+bool position::is_pseudo_legal(const chess_move& candidate_move) const {
+    if (candidate_move.from > 63 || candidate_move.to > 63 || squares[candidate_move.from] == piece_code::empty ||
+        piece_code::colour_of(squares[candidate_move.from]) != colour_turn) {
+        return false;
+    }
+    move_list piece_moves;
+    generate_piece_moves(candidate_move.from, piece_moves);
+    for (const chess_move& piece_move : piece_moves) {
+        if (piece_move.to == candidate_move.to) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool position::is_legal(const chess_move& pseudo_legal_move) const {
+    position copy{ *this };
+    copy.make_move(pseudo_legal_move);
+    return !copy.is_attacked(copy.king_square[static_cast<int>(colour_turn)], opposite_colour(colour_turn));
+}
+
+void position::generate_legal_moves(move_list& moves) const {
+    moves.clear();
+    if (colour_turn == piece_colour::white) {
+        generate_legal_moves_for<piece_colour::white>(moves);
+    }
+    else {
+        generate_legal_moves_for<piece_colour::black>(moves);
+    }
+}
+
+std::uint8_t position::make_move(const chess_move& new_move) noexcept {
+    std::uint8_t captured{ squares[new_move.to] };
+    std::uint8_t moving{ squares[new_move.from] };
+    squares[new_move.to] = moving;
+    squares[new_move.from] = piece_code::empty;
+    add_square_value(moving, new_move.from, -1);
+    add_square_value(captured, new_move.to, -1);
+    add_square_value(moving, new_move.to, 1);
+    if (piece_code::symbol_of(moving) == piece_symbol::king) {
+        king_square[static_cast<int>(piece_code::colour_of(moving))] = new_move.to;
+    }
+    colour_turn = opposite_colour(colour_turn);
+    hash ^= zobrist::black_to_move;
+    return captured;
+}
+
+void position::make_null_move() noexcept {
+    colour_turn = opposite_colour(colour_turn);
+    hash ^= zobrist::black_to_move;
+}
+
+template <piece_colour By>
+int position::least_valuable_attacker(const int& square, const std::uint64_t& removed) const noexcept {
+    using by = colour_traits<By>;
+    auto holds = [&](const int& attacker_square, const std::uint8_t& code) {
+        return squares[attacker_square] == code && !((removed >> attacker_square) & 1);
+    };
+    int column{ square % 8 };
+    if (column > 0 && 0 <= square - by::capture_right && square - by::capture_right < 64 && holds(square - by::capture_right, by::pawn)) {
+        return square - by::capture_right;
+    }
+    if (column < 7 && 0 <= square - by::capture_left && square - by::capture_left < 64 && holds(square - by::capture_left, by::pawn)) {
+        return square - by::capture_left;
+    }
+    const step_targets& knight_squares{ knight_targets[square] };
+    for (int i{}; i < knight_squares.count; i++) {
+        if (holds(knight_squares.squares[i], by::knight)) {
+            return knight_squares.squares[i];
+        }
+    }
+    //First piece left along each ray, of either colour: the sliding pieces of By among them attack the square
+    std::array<int, 8> first_piece{ -1, -1, -1, -1, -1, -1, -1, -1 };
+    for (int direction{}; direction < 8; direction++) {
+        int target{ square };
+        for (int step{}; step < ray_length[square][direction]; step++) {
+            target += direction_step[direction];
+            if (squares[target] != piece_code::empty && !((removed >> target) & 1)) {
+                first_piece[direction] = target;
+                break;
+            }
+        }
+    }
+    for (int direction{ 4 }; direction < 8; direction++) {
+        if (first_piece[direction] >= 0 && squares[first_piece[direction]] == by::bishop) {
+            return first_piece[direction];
+        }
+    }
+    for (int direction{}; direction < 4; direction++) {
+        if (first_piece[direction] >= 0 && squares[first_piece[direction]] == by::rook) {
+            return first_piece[direction];
+        }
+    }
+    for (int direction{}; direction < 8; direction++) {
+        if (first_piece[direction] >= 0 && squares[first_piece[direction]] == by::queen) {
+            return first_piece[direction];
+        }
+    }
+    const step_targets& king_squares{ king_targets[square] };
+    for (int i{}; i < king_squares.count; i++) {
+        if (holds(king_squares.squares[i], by::king)) {
+            return king_squares.squares[i];
+        }
+    }
+    return -1;
+}
+
+int position::see(const chess_move& exchange_move) const noexcept {
+    //gain[depth] is the material won by the colour capturing at that depth if the exchange stopped after its capture
+    std::array<int, 34> gain{};
+    int depth{};
+    const std::uint8_t& target{ squares[exchange_move.to] };
+    gain[0] = target == piece_code::empty ? 0 : exchange_value[static_cast<int>(piece_code::symbol_of(target))];
+    int attacker{ exchange_move.from };
+    int attacker_value{ exchange_value[static_cast<int>(piece_code::symbol_of(squares[attacker]))] };
+    piece_colour side{ piece_code::colour_of(squares[attacker]) };
+    std::uint64_t removed{};
+    do {
+        depth++;
+        gain[depth] = attacker_value - gain[depth - 1]; //if the last piece that captured is captured in turn
+        if (std::max(-gain[depth - 1], gain[depth]) < 0) {
+            break; //neither colour changes the result by going on
+        }
+        removed |= std::uint64_t{ 1 } << attacker;
+        side = opposite_colour(side);
+        attacker = side == piece_colour::white ? least_valuable_attacker<piece_colour::white>(exchange_move.to, removed)
+            : least_valuable_attacker<piece_colour::black>(exchange_move.to, removed);
+        if (attacker >= 0) {
+            attacker_value = exchange_value[static_cast<int>(piece_code::symbol_of(squares[attacker]))];
+        }
+    } while (attacker >= 0 && depth < 32);
+    //Each colour stops where the exchange is best for it
+    while (--depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+    }
+    return gain[0];
+}
+
+void position::unmake_move(const chess_move& old_move, const std::uint8_t& captured) noexcept {
+    std::uint8_t moving{ squares[old_move.to] };
+    squares[old_move.from] = moving;
+    squares[old_move.to] = captured;
+    add_square_value(moving, old_move.to, -1);
+    add_square_value(captured, old_move.to, 1);
+    add_square_value(moving, old_move.from, 1);
+    if (piece_code::symbol_of(moving) == piece_symbol::king) {
+        king_square[static_cast<int>(piece_code::colour_of(moving))] = old_move.from;
+    }
+    colour_turn = opposite_colour(colour_turn);
+    hash ^= zobrist::black_to_move;
+}
\ No newline at end of file
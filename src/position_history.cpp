@@ -0,0 +1,22 @@
+/*
+This file contains the implementation of the position history.
+*/
+
+#include "position_history.h"
+#include <algorithm>
+#include <cstdint>
+
+size_t position_history::repetition_window() const noexcept {
+    //The positions before the last capture or pawn move cannot repeat the last one, and the overwritten ones are lost
+    return std::min({ static_cast<size_t>(halfmove_clocks[last_index()]), number_of_positions - 1, capacity - 1 });
+}
+
+int position_history::count_occurrences() const noexcept {
+    const std::uint64_t& hash{ hashes[last_index()] };
+    size_t window{ repetition_window() };
+    int occurrences{ 1 };
+    for (size_t back{ 4 }; back <= window; back += 2) {
+        occurrences += hashes[(number_of_positions - 1 - back) & index_mask] == hash;
+    }
+    return occurrences;
+}
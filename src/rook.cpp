@@ -20,7 +20,7 @@ rook::rook() {
 rook::rook(const char& column, const piece_colour& colour_in) {
     //std::cout << "Rook parametrised constructor called." << std::endl;
     try {
-        int column_number{ coordinates::alphabetical_dictionary.at(column) };
+        int column_number{ coordinates::column_number(column) };
     }
     catch (const std::out_of_range&) {
         throw std::out_of_range("Error: columns go from 'a' to 'h'.");
@@ -37,13 +37,18 @@ rook::rook(const char& column, const piece_colour& colour_in) {
     symbol = piece_symbol::rook;
 }
 
+rook::rook(const std::pair<char, int>& location_in, const piece_colour& colour_in)
+    : piece{ location_in, colour_in, piece_symbol::rook }
+{
+}
+
 rook::~rook() {
-    //std::cout << "Destructor of rook of colour " << colour_string_map.at(colour) << " called at position " << location.first << location.second << "." << std::endl;
+    //std::cout << "Destructor of rook of colour " << colour_string(colour) << " called at position " << location.first << location.second << "." << std::endl;
 }
 
 std::list<int> rook::get_allowed_moves(const std::array<board_occupation, 64>& board_matrix) const {
     std::list<int> allowed_moves;
-    piece_colour colour_opposite{ opposite_colour.at(colour) };
+    piece_colour colour_opposite{ opposite_colour(colour) };
     int current_location{ coordinates::flatten_board_coordinates(location) };
 
     //Use objects from the allowed_moves_getter files
@@ -60,13 +65,4 @@ std::list<int> rook::get_allowed_moves(const std::array<board_occupation, 64>& b
     allowed_moves.splice(allowed_moves.end(), down.get_allowed_moves(current_location, board_matrix, colour_opposite));
 
     return allowed_moves;
-}
-
-std::string rook::get_symbol_string(const bool& on_white_tile) const noexcept {
-    if (on_white_tile) {
-        return (colour == piece_colour::white) ? u8"♖" : u8"♜";
-    }
-    else {
-        return (colour == piece_colour::white) ? u8"♜" : u8"♖";
-    }
 }
\ No newline at end of file
@@ -0,0 +1,340 @@
+/*
+This file contains the implementation of the searcher. See search.h
+*/
+
+#include "search.h"
+#include "evaluation.h"
+#include "move_ordering.h"
+#include "move_picker.h"
+#include "ordering_tables.h"
+#include "piece_square_tables.h"
+#include "position.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    constexpr int infinite_score{ searcher::mate_score + 1 };
+    static_assert(searcher::max_ply <= killer_table::max_ply, "the killer table must have a slot for every ply of the search");
+    //Iterations from which the aspiration windows are used, once the score has settled
+    constexpr int aspiration_depth{ 4 };
+    constexpr int queen_value{ evaluation_tables::material_value[static_cast<int>(piece_symbol::queen)] };
+
+    //Whether the side that has just moved left its own king in check
+    bool left_king_in_check(const position& game_position) {
+        piece_colour mover{ opposite_colour(game_position.get_colour_turn()) };
+        return game_position.is_attacked(game_position.get_king_square(mover), game_position.get_colour_turn());
+    }
+}
+
+search_result searcher::search(const position& root, const int& depth) {
+    if (depth < 1) {
+        throw std::invalid_argument("Error: the search depth must be at least 1.");
+    }
+    position game_position{ root };
+    history.clear();
+    history.push(game_position.get_hash(), true);
+    search_result result;
+    tables.new_search();
+    for (int iteration{ 1 }; iteration <= depth; iteration++) {
+        int window{ settings.aspiration_window };
+        int alpha{ -infinite_score };
+        int beta{ infinite_score };
+        if (settings.aspiration_windows && iteration >= aspiration_depth && std::abs(result.score) < mate_bound) {
+            alpha = result.score - window;
+            beta = result.score + window;
+        }
+        while (true) {
+            //The best move of the iteration before is searched first
+            search_result iteration_result{ search_root(game_position, alpha, beta, iteration, result.best_move) };
+            if (iteration_result.score <= alpha && alpha > -infinite_score) {
+                statistics.aspiration_researches++;
+                window *= 4;
+                alpha = std::max(-infinite_score, iteration_result.score - window);
+            }
+            else if (iteration_result.score >= beta && beta < infinite_score) {
+                statistics.aspiration_researches++;
+                window *= 4;
+                beta = std::min(infinite_score, iteration_result.score + window);
+            }
+            else {
+                result = iteration_result;
+                break;
+            }
+        }
+        if (result.best_move == no_move) { //checkmate or stalemate, nothing deeper to search
+            break;
+        }
+    }
+    return result;
+}
+
+search_result searcher::search_root(position& root, int alpha, const int& beta, const int& depth, const chess_move& first_move) {
+    statistics.nodes++;
+    move_picker_hints hints;
+    hints.hash_move = first_move;
+    move_picker picker{ root, hints };
+    search_result result;
+    result.score = -infinite_score;
+    chess_move root_move;
+    int moves_searched{};
+    while (picker.next(root_move)) {
+        std::uint8_t captured{ make_move(root, root_move) };
+        int score;
+        if (moves_searched == 0) {
+            score = -alpha_beta(root, -beta, -alpha, depth - 1, 1, root_move);
+        }
+        else {
+            score = -alpha_beta(root, -alpha - 1, -alpha, depth - 1, 1, root_move);
+            if (score > alpha && score < beta) {
+                score = -alpha_beta(root, -beta, -alpha, depth - 1, 1, root_move);
+            }
+        }
+        unmake_move(root, root_move, captured);
+        moves_searched++;
+        if (score > result.score) {
+            result.score = score;
+            result.best_move = root_move;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+    if (moves_searched == 0) {
+        result.score = root.in_check() ? -mate_score : 0;
+    }
+    return result;
+}
+
+std::uint8_t searcher::make_move(position& game_position, const chess_move& new_move) noexcept {
+    bool pawn_move{ piece_code::symbol_of(game_position.get_square(new_move.from)) == piece_symbol::pawn };
+    std::uint8_t captured{ game_position.make_move(new_move) };
+    history.push(game_position.get_hash(), pawn_move || captured != piece_code::empty);
+    return captured;
+}
+
+void searcher::unmake_move(position& game_position, const chess_move& old_move, const std::uint8_t& captured) noexcept {
+    history.pop();
+    game_position.unmake_move(old_move, captured);
+}
+
+void searcher::make_null_move(position& game_position) noexcept {
+    game_position.make_null_move();
+    //The positions before the null move are not reached by legal moves, so they must not count as repetitions
+    history.push(game_position.get_hash(), true);
+}
+
+void searcher::unmake_null_move(position& game_position) noexcept {
+    history.pop();
+    game_position.unmake_null_move();
+}
+
+int searcher::alpha_beta(position& game_position, int alpha, const int& beta, int depth, const int& ply, const chess_move& previous_move) {
+    //Draws (alpha_beta is never called at the root, ply 0)
+    if (history.is_repetition() || history.get_halfmove_clock() >= 100) {
+        return 0;
+    }
+    bool check{ game_position.in_check() };
+    if (check && settings.check_extensions && depth >= 0) {
+        statistics.check_extensions++;
+        depth++;
+    }
+    if (depth <= 0 || ply >= max_ply) {
+        return quiescence(game_position, alpha, beta, ply);
+    }
+    statistics.nodes++;
+    bool principal_variation{ beta - alpha > 1 };
+    bool futile{ false };
+    if (!check && !principal_variation) {
+        int static_score{ evaluation::evaluate(game_position) };
+        //Pieces other than pawns and kings count towards the phase of the game
+        if (settings.null_move_pruning && previous_move != no_move && depth >= 3 && static_score >= beta &&
+            game_position.get_material_pst().phase > 0) {
+            statistics.null_move_searches++;
+            int reduction{ settings.null_move_reduction + (depth >= 7 ? 1 : 0) };
+            make_null_move(game_position);
+            int score{ -alpha_beta(game_position, -beta, -beta + 1, depth - 1 - reduction, ply + 1, no_move) };
+            unmake_null_move(game_position);
+            if (score >= beta) {
+                statistics.null_move_cutoffs++;
+                return score >= mate_bound ? beta : score; //a mate found without moving is not proven
+            }
+        }
+        futile = settings.futility_pruning && depth <= 2 && std::abs(alpha) < mate_bound &&
+            static_score + settings.futility_margin * depth <= alpha;
+    }
+
+    move_picker_hints hints;
+    hints.killers = tables.killers.get(ply);
+    hints.history = &tables.history.get(game_position.get_colour_turn());
+    if (previous_move != no_move) {
+        hints.countermove = tables.countermoves.get(game_position.get_square(previous_move.to), previous_move.to);
+    }
+    move_picker picker{ game_position, hints };
+    chess_move next_move;
+    move_list quiet_moves_tried;
+    int best_score{ -infinite_score };
+    int moves_searched{};
+    while (picker.next(next_move)) {
+        std::uint8_t captured{ make_move(game_position, next_move) };
+        bool quiet{ captured == piece_code::empty && !game_position.in_check() };
+        if (futile && quiet && moves_searched > 0) {
+            unmake_move(game_position, next_move, captured);
+            statistics.futility_pruned++;
+            continue;
+        }
+        int score;
+        if (moves_searched == 0) {
+            score = -alpha_beta(game_position, -beta, -alpha, depth - 1, ply + 1, next_move);
+        }
+        else {
+            int reduction{};
+            if (settings.late_move_reductions && quiet && !check && depth >= 3 && moves_searched >= 3) {
+                reduction = (depth >= 6 && moves_searched >= 6) ? 2 : 1;
+                statistics.reduced_moves++;
+            }
+            score = -alpha_beta(game_position, -alpha - 1, -alpha, depth - 1 - reduction, ply + 1, next_move);
+            if (reduction > 0 && score > alpha) {
+                statistics.reduction_researches++;
+                score = -alpha_beta(game_position, -alpha - 1, -alpha, depth - 1, ply + 1, next_move);
+            }
+            if (score > alpha && score < beta) {
+                score = -alpha_beta(game_position, -beta, -alpha, depth - 1, ply + 1, next_move);
+            }
+        }
+        unmake_move(game_position, next_move, captured);
+        moves_searched++;
+        if (score > best_score) {
+            best_score = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {
+                    statistics.beta_cutoffs++;
+                    if (moves_searched == 1) {
+                        statistics.first_move_cutoffs++;
+                    }
+                    if (captured == piece_code::empty) {
+                        update_ordering_tables(game_position, next_move, quiet_moves_tried, depth, ply, previous_move);
+                    }
+                    break;
+                }
+            }
+        }
+        if (captured == piece_code::empty) {
+            quiet_moves_tried.push_back(next_move);
+        }
+    }
+    if (moves_searched == 0) { //no legal move: the first one is never pruned
+        return check ? -mate_score + ply : 0;
+    }
+    return best_score;
+}
+
+void searcher::update_ordering_tables(const position& game_position, const chess_move& cutoff_move, const move_list& quiet_moves_tried, const int& depth, const int& ply, const chess_move& previous_move) noexcept {
+    tables.killers.add(ply, cutoff_move);
+    int bonus{ history_table::depth_bonus(depth) };
+    tables.history.update(game_position.get_colour_turn(), cutoff_move, bonus);
+    for (const chess_move& quiet_move : quiet_moves_tried) {
+        tables.history.update(game_position.get_colour_turn(), quiet_move, -bonus);
+    }
+    if (previous_move != no_move) {
+        tables.countermoves.set(game_position.get_square(previous_move.to), previous_move.to, cutoff_move);
+    }
+}
+
+int searcher::quiescence(position& game_position, int alpha, const int& beta, const int& ply, const int& quiescence_ply) {
+    statistics.quiescence_nodes++;
+    bool check{ game_position.in_check() };
+    if (ply >= max_ply) {
+        return check ? 0 : evaluation::evaluate(game_position);
+    }
+    move_list moves;
+    std::array<int, 256> scores;
+    int best_score{ -infinite_score };
+    int stand_pat{};
+    if (check) {
+        //No standing pat: every evasion, quiet or not, in the usual order
+        game_position.generate_pseudo_legal_moves(moves);
+        move_ordering::order_moves(game_position, moves);
+        for (size_t i{}; i < moves.size(); i++) {
+            scores[i] = 0;
+        }
+    }
+    else {
+        stand_pat = evaluation::evaluate(game_position);
+        if (stand_pat >= beta) {
+            statistics.stand_pat_cutoffs++;
+            return stand_pat;
+        }
+        if (stand_pat + queen_value + settings.delta_margin <= alpha) {
+            statistics.delta_pruned++;
+            return stand_pat;
+        }
+        best_score = stand_pat;
+        alpha = std::max(alpha, stand_pat);
+        game_position.generate_captures(moves);
+        for (size_t i{}; i < moves.size(); i++) {
+            scores[i] = move_ordering::mvv_lva(game_position, moves[i]);
+        }
+        if (settings.quiescence_checks && quiescence_ply == 0) {
+            //After the captures, which score at least -5. Only those that give check are searched
+            move_list quiet_moves;
+            game_position.generate_quiet_moves(quiet_moves);
+            for (const chess_move& quiet_move : quiet_moves) {
+                scores[moves.size()] = -100;
+                moves.push_back(quiet_move);
+            }
+        }
+    }
+
+    for (size_t next{}; next < moves.size(); next++) {
+        //Selection of the best move left, as a cutoff often makes the rest unnecessary
+        size_t best{ next };
+        for (size_t i{ next + 1 }; i < moves.size(); i++) {
+            if (scores[i] > scores[best]) {
+                best = i;
+            }
+        }
+        std::swap(moves[next], moves[best]);
+        std::swap(scores[next], scores[best]);
+        const chess_move& next_move{ moves[next] };
+        const std::uint8_t victim{ game_position.get_square(next_move.to) };
+        if (!check) {
+            if (victim != piece_code::empty &&
+                stand_pat + evaluation_tables::material_value[static_cast<int>(piece_code::symbol_of(victim))] + settings.delta_margin <= alpha) {
+                statistics.delta_pruned++;
+                continue;
+            }
+            if (game_position.see(next_move) < 0) {
+                statistics.see_pruned++;
+                continue;
+            }
+        }
+        std::uint8_t captured{ game_position.make_move(next_move) };
+        if (left_king_in_check(game_position) || (!check && captured == piece_code::empty && !game_position.in_check())) {
+            game_position.unmake_move(next_move, captured);
+            continue;
+        }
+        int score{ -quiescence(game_position, -beta, -alpha, ply + 1, quiescence_ply + 1) };
+        game_position.unmake_move(next_move, captured);
+        if (score > best_score) {
+            best_score = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+    if (best_score == -infinite_score) { //in check without an evasion
+        return -mate_score + ply;
+    }
+    return best_score;
+}
@@ -0,0 +1,689 @@
+/*
+This file contains the implementation of the endgame tablebase.
+Every position of a table is stored as one byte:
+    0           draw (and, while the table is generated, a position whose result is not known yet)
+    1 to 127    win for the colour turn, mate in 2 * value - 1 plies
+    128 to 254  loss for the colour turn, mated in 2 * (value - 128) plies
+    255         not a legal position, or one equal by symmetry to another index of the table
+A table is generated in rounds, one per ply of distance to mate. The checkmates are the losses in 0 plies. In each odd
+round n, the positions with a move to a loss in n - 1 plies become wins in n plies; they are found by unmaking moves
+from the losses of the last round. In each even round n, the positions that can only move to wins (in at most n - 1
+plies) become losses in n plies; the candidates are found by unmaking moves from the wins of the last round and checked
+by making all their moves. The captures lead to tables of fewer pieces, which are generated first, and their results
+join the rounds at the ply they stand for. The positions left at the end are draws.
+Each round is split over the thread pool. The threads only read the table while a round is searched, and the new
+results are written once it is over.
+*/
+
+#include "tablebase.h"
+#include "position.h"
+#include "piece_square_tables.h"
+#include "thread_pool.h"
+#include "enum_attributes.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    constexpr std::uint8_t draw_value{ 0 };
+    constexpr std::uint8_t invalid_value{ 255 };
+
+    constexpr std::uint8_t win_value(const int& plies) { return static_cast<std::uint8_t>(1 + (plies - 1) / 2); }
+    constexpr std::uint8_t loss_value(const int& plies) { return static_cast<std::uint8_t>(128 + plies / 2); }
+    constexpr bool is_win(const std::uint8_t& value) { return 1 <= value && value < 128; }
+    constexpr bool is_loss(const std::uint8_t& value) { return 128 <= value && value < invalid_value; }
+    constexpr int plies_of(const std::uint8_t& value) { return is_win(value) ? 2 * value - 1 : 2 * (value - 128); }
+
+    //Symmetries of the board: bit 4 swaps columns and rows, bit 1 mirrors the columns and bit 2 the rows
+    constexpr int transform_square(const int& square, const int& transform) {
+        int column{ square % 8 };
+        int row{ square / 8 };
+        if (transform & 4) {
+            int swapped_column{ row };
+            row = column;
+            column = swapped_column;
+        }
+        if (transform & 1) {
+            column = 7 - column;
+        }
+        if (transform & 2) {
+            row = 7 - row;
+        }
+        return 8 * row + column;
+    }
+
+    constexpr bool in_triangle(const int& square) {
+        return square % 8 <= 3 && square / 8 <= square % 8;
+    }
+
+    //Without pawns, the white king is taken to the a1-d1-d4 triangle. When it lands on the diagonal, two transforms (one
+    //the other followed by swapping columns and rows) take it there, and the table keeps the smallest index of the two
+    struct king_transforms {
+        int count{};
+        std::array<int, 2> transforms{};
+    };
+
+    constexpr std::array<king_transforms, 64> create_pawnless_king_transforms() {
+        std::array<king_transforms, 64> table{};
+        for (int square{}; square < 64; square++) {
+            for (int transform{}; transform < 8 && table[square].count < 2; transform++) {
+                if (in_triangle(transform_square(square, transform))) {
+                    table[square].transforms[table[square].count++] = transform;
+                }
+            }
+        }
+        return table;
+    }
+
+    constexpr std::array<int, 64> create_triangle_slots() {
+        std::array<int, 64> slots{};
+        int slot{};
+        for (int square{}; square < 64; square++) {
+            slots[square] = in_triangle(square) ? slot++ : -1;
+        }
+        return slots;
+    }
+
+    constexpr std::array<int, 10> create_triangle_squares() {
+        std::array<int, 10> squares{};
+        int slot{};
+        for (int square{}; square < 64; square++) {
+            if (in_triangle(square)) {
+                squares[slot++] = square;
+            }
+        }
+        return squares;
+    }
+
+    constexpr std::array<king_transforms, 64> pawnless_king_transforms{ create_pawnless_king_transforms() };
+    constexpr std::array<int, 64> triangle_slots{ create_triangle_slots() };
+    constexpr std::array<int, 10> triangle_squares{ create_triangle_squares() };
+
+    constexpr std::uint8_t white_king{ piece_code::make(piece_colour::white, piece_symbol::king) };
+    constexpr std::uint8_t black_king{ piece_code::make(piece_colour::black, piece_symbol::king) };
+
+    constexpr bool is_pawn(const std::uint8_t& code) {
+        return piece_code::symbol_of(code) == piece_symbol::pawn;
+    }
+
+    //Key of the pieces other than the kings, with their codes sorted: 0 for none, the code for one, 16 * first + second
+    //for two
+    int material_key(const int& number_of_others, const std::array<std::uint8_t, 2>& codes) {
+        return number_of_others == 0 ? 0 : (number_of_others == 1 ? codes[0] : 16 * codes[0] + codes[1]);
+    }
+
+    std::uint8_t swap_colour(const std::uint8_t& code) {
+        return static_cast<std::uint8_t>(code ^ piece_code::black_flag);
+    }
+
+    //The side with more pieces, then more material, then stronger pieces, is the white one in the tables
+    std::vector<int> strength_of(const std::vector<std::uint8_t>& codes, const piece_colour& colour) {
+        std::vector<int> values;
+        int total{};
+        for (const std::uint8_t& code : codes) {
+            if (piece_code::colour_of(code) == colour) {
+                values.push_back(evaluation_tables::material_value[static_cast<int>(piece_code::symbol_of(code))]);
+                total += values.back();
+            }
+        }
+        std::sort(values.rbegin(), values.rend());
+        values.insert(values.begin(), { static_cast<int>(values.size()), total });
+        return values;
+    }
+
+    char letter_of(const std::uint8_t& code) {
+        constexpr std::array<char, 6> letters{ 'P', 'R', 'N', 'B', 'K', 'Q' };
+        return letters[static_cast<int>(piece_code::symbol_of(code))];
+    }
+
+    std::string name_of(const std::vector<std::uint8_t>& codes) {
+        std::vector<std::uint8_t> sorted_codes{ codes };
+        std::sort(sorted_codes.begin(), sorted_codes.end(), [](const std::uint8_t& lhs, const std::uint8_t& rhs) {
+            return evaluation_tables::material_value[static_cast<int>(piece_code::symbol_of(lhs))] >
+                evaluation_tables::material_value[static_cast<int>(piece_code::symbol_of(rhs))];
+        });
+        std::string name{ "K" };
+        for (const piece_colour& colour : { piece_colour::white, piece_colour::black }) {
+            if (colour == piece_colour::black) {
+                name += 'K';
+            }
+            for (const std::uint8_t& code : sorted_codes) {
+                if (piece_code::colour_of(code) == colour) {
+                    name += letter_of(code);
+                }
+            }
+        }
+        return name;
+    }
+
+    //Codes of the pieces other than the kings, with the colours as in the table of the material
+    std::vector<std::uint8_t> canonical_codes(std::vector<std::uint8_t> codes) {
+        if (strength_of(codes, piece_colour::white) < strength_of(codes, piece_colour::black)) {
+            for (std::uint8_t& code : codes) {
+                code = swap_colour(code);
+            }
+        }
+        std::sort(codes.begin(), codes.end());
+        return codes;
+    }
+
+    std::vector<std::uint8_t> parse_material(const std::string& material) {
+        if (material.size() < 2 || material[0] != 'K' || std::count(material.begin(), material.end(), 'K') != 2 ||
+            static_cast<int>(material.size()) > tablebase::max_pieces) {
+            throw std::invalid_argument("Error: the material must be the white pieces then the black ones, each starting with the king, and have at most " +
+                std::to_string(tablebase::max_pieces) + " pieces.");
+        }
+        std::vector<std::uint8_t> codes;
+        piece_colour colour{ piece_colour::white };
+        for (size_t index{ 1 }; index < material.size(); index++) {
+            piece_symbol symbol;
+            switch (material[index]) {
+            case 'K': colour = piece_colour::black; continue;
+            case 'Q': symbol = piece_symbol::queen; break;
+            case 'R': symbol = piece_symbol::rook; break;
+            case 'B': symbol = piece_symbol::bishop; break;
+            case 'N': symbol = piece_symbol::knight; break;
+            case 'P': symbol = piece_symbol::pawn; break;
+            default: throw std::invalid_argument(std::string{ "Error: unknown piece letter " } + material[index] + " in the material.");
+            }
+            codes.push_back(piece_code::make(colour, symbol));
+        }
+        return codes;
+    }
+}
+
+struct tablebase::table {
+    std::string material;
+    int number_of_others{};
+    std::array<std::uint8_t, 2> codes{}; //sorted
+    bool has_pawns{ false };
+    size_t king_slots{};
+    size_t size{};
+    std::vector<std::uint8_t> values;
+
+    table(const std::vector<std::uint8_t>& sorted_codes) : material{ name_of(sorted_codes) },
+        number_of_others{ static_cast<int>(sorted_codes.size()) } {
+        size_t positions_of_others{ 1 };
+        for (int other{}; other < number_of_others; other++) {
+            codes[other] = sorted_codes[other];
+            has_pawns = has_pawns || is_pawn(codes[other]);
+            positions_of_others *= 64;
+        }
+        king_slots = has_pawns ? 32 : 10;
+        size = 2 * king_slots * 64 * positions_of_others;
+    }
+
+    //Index of the pieces, whose codes must be the ones of the table
+    size_t index_of(const piece_list& pieces) const noexcept {
+        king_transforms transforms{ has_pawns ?
+            king_transforms{ 1, { pieces.white_king % 8 > 3 ? 1 : 0, 0 } } : pawnless_king_transforms[pieces.white_king] };
+        size_t smallest_index{ std::numeric_limits<size_t>::max() };
+        for (int option{}; option < transforms.count; option++) {
+            const int& transform{ transforms.transforms[option] };
+            int king_square{ transform_square(pieces.white_king, transform) };
+            size_t index{ static_cast<size_t>(pieces.colour_turn == piece_colour::white ? 0 : 1) };
+            index = index * king_slots + (has_pawns ? static_cast<size_t>(4 * (king_square / 8) + king_square % 8) :
+                static_cast<size_t>(triangle_slots[king_square]));
+            index = index * 64 + transform_square(pieces.black_king, transform);
+            std::array<int, 2> other_squares{};
+            for (int other{}; other < number_of_others; other++) {
+                other_squares[other] = transform_square(pieces.squares[other], transform);
+            }
+            if (number_of_others == 2 && codes[0] == codes[1] && other_squares[0] > other_squares[1]) {
+                std::swap(other_squares[0], other_squares[1]); //the same piece twice is kept in one order
+            }
+            for (int other{}; other < number_of_others; other++) {
+                index = index * 64 + other_squares[other];
+            }
+            smallest_index = std::min(smallest_index, index);
+        }
+        return smallest_index;
+    }
+
+    piece_list pieces_at(size_t index) const noexcept {
+        piece_list pieces;
+        pieces.number_of_others = number_of_others;
+        pieces.codes = codes;
+        for (int other{ number_of_others - 1 }; other >= 0; other--) {
+            pieces.squares[other] = static_cast<int>(index % 64);
+            index /= 64;
+        }
+        pieces.black_king = static_cast<int>(index % 64);
+        index /= 64;
+        int slot{ static_cast<int>(index % king_slots) };
+        pieces.white_king = has_pawns ? 8 * (slot / 4) + slot % 4 : triangle_squares[slot];
+        pieces.colour_turn = (index / king_slots == 0) ? piece_colour::white : piece_colour::black;
+        return pieces;
+    }
+};
+
+namespace {
+    //Set in a position the pieces of a table
+    template <class c_piece_list> std::array<std::uint8_t, 64> squares_of(const c_piece_list& pieces) {
+        std::array<std::uint8_t, 64> squares{};
+        squares[pieces.white_king] = white_king;
+        squares[pieces.black_king] = black_king;
+        for (int other{}; other < pieces.number_of_others; other++) {
+            squares[pieces.squares[other]] = pieces.codes[other];
+        }
+        return squares;
+    }
+
+    //Pieces on distinct squares, and no pawn on the first row of its colour, which it can never reach
+    template <class c_piece_list> bool is_placement_possible(const c_piece_list& pieces) {
+        std::uint64_t occupied{ (1ULL << pieces.white_king) | (1ULL << pieces.black_king) };
+        if (pieces.white_king == pieces.black_king) {
+            return false;
+        }
+        for (int other{}; other < pieces.number_of_others; other++) {
+            const int& square{ pieces.squares[other] };
+            if (occupied & (1ULL << square)) {
+                return false;
+            }
+            occupied |= 1ULL << square;
+            if (is_pawn(pieces.codes[other]) && square / 8 == (piece_code::colour_of(pieces.codes[other]) == piece_colour::white ? 0 : 7)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //Sorted indices of a round, collected by each slice of the thread pool
+    std::vector<size_t> merge_slices(std::vector<std::vector<size_t>>& slices) {
+        std::vector<size_t> merged;
+        for (std::vector<size_t>& slice : slices) {
+            merged.insert(merged.end(), slice.begin(), slice.end());
+            slice.clear();
+        }
+        std::sort(merged.begin(), merged.end());
+        merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+        return merged;
+    }
+
+    constexpr size_t indices_per_chunk{ 4096 };
+}
+
+tablebase::tablebase() = default;
+tablebase::~tablebase() = default;
+tablebase::tablebase(tablebase&&) noexcept = default;
+tablebase& tablebase::operator=(tablebase&&) noexcept = default;
+
+bool tablebase::find_value(piece_list pieces, std::uint8_t& value) const noexcept {
+    if (pieces.number_of_others == 2 && pieces.codes[0] > pieces.codes[1]) {
+        std::swap(pieces.codes[0], pieces.codes[1]);
+        std::swap(pieces.squares[0], pieces.squares[1]);
+    }
+    int key{ material_key(pieces.number_of_others, pieces.codes) };
+    if (key == 0) {
+        value = draw_value; //two lone kings
+        return true;
+    }
+    const table_reference& reference{ tables_by_material[key] };
+    if (!reference.material_table) {
+        return false;
+    }
+    if (reference.colours_swapped) {
+        //Mirror the rows and swap the colours, which keeps the pawns moving forward
+        std::swap(pieces.white_king, pieces.black_king);
+        pieces.white_king ^= 56;
+        pieces.black_king ^= 56;
+        for (int other{}; other < pieces.number_of_others; other++) {
+            pieces.codes[other] = swap_colour(pieces.codes[other]);
+            pieces.squares[other] ^= 56;
+        }
+        if (pieces.number_of_others == 2 && pieces.codes[0] > pieces.codes[1]) {
+            std::swap(pieces.codes[0], pieces.codes[1]);
+            std::swap(pieces.squares[0], pieces.squares[1]);
+        }
+        pieces.colour_turn = opposite_colour(pieces.colour_turn);
+    }
+    value = reference.material_table->values[reference.material_table->index_of(pieces)];
+    return true;
+}
+
+void tablebase::generate_table(table& new_table, thread_pool& pool) {
+    new_table.values.assign(new_table.size, draw_value);
+    std::vector<std::uint8_t>& values{ new_table.values };
+    std::vector<std::vector<size_t>> slice_results(pool.size());
+    //Positions whose captures decide their result at a known round: (round, index)
+    std::vector<std::vector<std::pair<int, size_t>>> slice_capture_rounds(pool.size());
+    std::atomic<bool> missing_table{ false };
+
+    //Value of the position after a move, read from this table or, after a capture, from a smaller one
+    auto value_after_move = [this, &new_table, &values](const position& current, const piece_list& pieces, const chess_move& legal_move,
+        std::uint8_t& value) {
+        if (current.get_square(legal_move.to) == piece_code::empty) {
+            piece_list next{ pieces };
+            if (next.white_king == legal_move.from) next.white_king = legal_move.to;
+            else if (next.black_king == legal_move.from) next.black_king = legal_move.to;
+            else next.squares[next.squares[0] == legal_move.from ? 0 : 1] = legal_move.to;
+            next.colour_turn = opposite_colour(next.colour_turn);
+            value = values[new_table.index_of(next)];
+            return true;
+        }
+        piece_list next{ pieces };
+        int captured{ next.squares[0] == legal_move.to ? 0 : 1 };
+        next.codes[captured] = next.codes[next.number_of_others - 1];
+        next.squares[captured] = next.squares[next.number_of_others - 1];
+        next.number_of_others--;
+        if (next.white_king == legal_move.from) next.white_king = legal_move.to;
+        else if (next.black_king == legal_move.from) next.black_king = legal_move.to;
+        else next.squares[next.squares[0] == legal_move.from ? 0 : 1] = legal_move.to;
+        next.colour_turn = opposite_colour(next.colour_turn);
+        return find_value(next, value);
+    };
+
+    //Round 0: mark the positions that are not legal and the checkmates, and find when the captures decide the others
+    pool.parallel_for(new_table.size, indices_per_chunk, [&](const size_t& slice, const size_t& begin, const size_t& end) {
+        move_list legal_moves;
+        for (size_t index{ begin }; index < end; index++) {
+            piece_list pieces{ new_table.pieces_at(index) };
+            if (!is_placement_possible(pieces) || new_table.index_of(pieces) != index) {
+                values[index] = invalid_value;
+                continue;
+            }
+            position current{ squares_of(pieces), pieces.colour_turn };
+            piece_colour waiting_colour{ opposite_colour(pieces.colour_turn) };
+            if (current.is_attacked(current.get_king_square(waiting_colour), pieces.colour_turn)) {
+                values[index] = invalid_value; //the colour that just moved left its king in check
+                continue;
+            }
+            legal_moves.clear();
+            current.generate_legal_moves(legal_moves);
+            if (legal_moves.empty()) {
+                if (current.in_check()) {
+                    values[index] = loss_value(0);
+                    slice_results[slice].push_back(index);
+                }
+                continue; //stalemates stay draws
+            }
+            int capture_win_round{ 0 };
+            int capture_loss_round{ 0 };
+            bool capture_draw{ false };
+            bool any_capture{ false };
+            for (const chess_move& legal_move : legal_moves) {
+                if (current.get_square(legal_move.to) == piece_code::empty) {
+                    continue;
+                }
+                any_capture = true;
+                std::uint8_t value;
+                if (!value_after_move(current, pieces, legal_move, value)) {
+                    missing_table = true;
+                    return;
+                }
+                if (is_loss(value)) {
+                    capture_win_round = capture_win_round ? std::min(capture_win_round, plies_of(value) + 1) : plies_of(value) + 1;
+                }
+                else if (is_win(value)) {
+                    capture_loss_round = std::max(capture_loss_round, plies_of(value) + 1);
+                }
+                else {
+                    capture_draw = true;
+                }
+            }
+            if (capture_win_round) {
+                slice_capture_rounds[slice].push_back({ capture_win_round, index });
+            }
+            else if (any_capture && !capture_draw) {
+                slice_capture_rounds[slice].push_back({ capture_loss_round, index });
+            }
+        }
+    });
+    if (missing_table) {
+        throw std::logic_error("Error: the tables of fewer pieces must be generated before " + new_table.material + ".");
+    }
+    std::vector<size_t> last_round{ merge_slices(slice_results) };
+    std::vector<std::pair<int, size_t>> capture_rounds;
+    for (auto& slice : slice_capture_rounds) {
+        capture_rounds.insert(capture_rounds.end(), slice.begin(), slice.end());
+    }
+    std::sort(capture_rounds.begin(), capture_rounds.end());
+    size_t next_capture_round{};
+
+    for (int round{ 1 }; !last_round.empty() || next_capture_round < capture_rounds.size(); round++) {
+        bool win_round{ round % 2 == 1 };
+        //Unmake the moves that lead to the results of the last round
+        pool.parallel_for(last_round.size(), 64, [&](const size_t& slice, const size_t& begin, const size_t& end) {
+            move_list piece_moves;
+            for (size_t entry{ begin }; entry < end; entry++) {
+                piece_list pieces{ new_table.pieces_at(last_round[entry]) };
+                std::array<std::uint8_t, 64> squares{ squares_of(pieces) };
+                position current{ squares, pieces.colour_turn };
+                piece_colour moved_colour{ opposite_colour(pieces.colour_turn) };
+                auto add_previous = [&](int* moved_square, const int& from) {
+                    int to{ *moved_square };
+                    *moved_square = from;
+                    pieces.colour_turn = moved_colour;
+                    size_t previous_index{ new_table.index_of(pieces) };
+                    *moved_square = to;
+                    pieces.colour_turn = opposite_colour(moved_colour);
+                    if (values[previous_index] == draw_value) {
+                        slice_results[slice].push_back(previous_index);
+                    }
+                };
+                auto unmake_moves_of = [&](int* moved_square, const std::uint8_t& code) {
+                    if (is_pawn(code)) {
+                        int step{ piece_code::colour_of(code) == piece_colour::white ? 8 : -8 };
+                        int from{ *moved_square - step };
+                        if (from < 0 || from > 63 || squares[from] != piece_code::empty) {
+                            return;
+                        }
+                        add_previous(moved_square, from);
+                        int double_step_row{ piece_code::colour_of(code) == piece_colour::white ? 3 : 4 };
+                        if (*moved_square / 8 == double_step_row && squares[from - step] == piece_code::empty) {
+                            add_previous(moved_square, from - step);
+                        }
+                        return;
+                    }
+                    //The other pieces move the same way back and forth
+                    piece_moves.clear();
+                    current.generate_piece_moves(*moved_square, piece_moves);
+                    for (const chess_move& piece_move : piece_moves) {
+                        if (squares[piece_move.to] == piece_code::empty) {
+                            add_previous(moved_square, piece_move.to);
+                        }
+                    }
+                };
+                unmake_moves_of(moved_colour == piece_colour::white ? &pieces.white_king : &pieces.black_king,
+                    moved_colour == piece_colour::white ? white_king : black_king);
+                for (int other{}; other < pieces.number_of_others; other++) {
+                    if (piece_code::colour_of(pieces.codes[other]) == moved_colour) {
+                        unmake_moves_of(&pieces.squares[other], pieces.codes[other]);
+                    }
+                }
+            }
+        });
+        for (; next_capture_round < capture_rounds.size() && capture_rounds[next_capture_round].first == round; next_capture_round++) {
+            if (values[capture_rounds[next_capture_round].second] == draw_value) {
+                slice_results[0].push_back(capture_rounds[next_capture_round].second);
+            }
+        }
+        std::vector<size_t> candidates{ merge_slices(slice_results) };
+
+        if (win_round) {
+            for (const size_t& index : candidates) {
+                values[index] = win_value(round);
+            }
+            last_round = std::move(candidates);
+            continue;
+        }
+        //A candidate is lost if all its moves lead to wins for the other colour
+        pool.parallel_for(candidates.size(), 64, [&](const size_t& slice, const size_t& begin, const size_t& end) {
+            move_list legal_moves;
+            for (size_t entry{ begin }; entry < end; entry++) {
+                piece_list pieces{ new_table.pieces_at(candidates[entry]) };
+                position current{ squares_of(pieces), pieces.colour_turn };
+                legal_moves.clear();
+                current.generate_legal_moves(legal_moves);
+                bool all_moves_lose{ true };
+                for (const chess_move& legal_move : legal_moves) {
+                    std::uint8_t value{};
+                    value_after_move(current, pieces, legal_move, value);
+                    if (!is_win(value) || plies_of(value) > round - 1) {
+                        all_moves_lose = false;
+                        break;
+                    }
+                }
+                if (all_moves_lose) {
+                    slice_results[slice].push_back(candidates[entry]);
+                }
+            }
+        });
+        last_round = merge_slices(slice_results);
+        for (const size_t& index : last_round) {
+            values[index] = loss_value(round);
+        }
+    }
+}
+
+void tablebase::generate(const std::string& material, thread_pool& pool) {
+    std::vector<std::uint8_t> codes{ canonical_codes(parse_material(material)) };
+    std::array<std::uint8_t, 2> key_codes{};
+    std::copy(codes.begin(), codes.end(), key_codes.begin());
+    int key{ material_key(static_cast<int>(codes.size()), key_codes) };
+    if (key == 0 || tables_by_material[key].material_table) {
+        return; //two lone kings need no table
+    }
+    for (size_t captured{}; captured < codes.size(); captured++) {
+        std::vector<std::uint8_t> smaller_codes{ codes };
+        smaller_codes.erase(smaller_codes.begin() + static_cast<std::ptrdiff_t>(captured));
+        generate(name_of(smaller_codes), pool);
+    }
+    auto new_table{ std::make_unique<table>(codes) };
+    generate_table(*new_table, pool);
+
+    //The same material with the colours swapped is read from the table by mirroring the board
+    std::array<std::uint8_t, 2> swapped_codes{};
+    for (size_t other{}; other < codes.size(); other++) {
+        swapped_codes[other] = swap_colour(codes[other]);
+    }
+    std::sort(swapped_codes.begin(), swapped_codes.begin() + static_cast<std::ptrdiff_t>(codes.size()));
+    int swapped_key{ material_key(static_cast<int>(codes.size()), swapped_codes) };
+    if (swapped_key != key) {
+        tables_by_material[swapped_key] = { new_table.get(), true };
+    }
+    tables_by_material[key] = { new_table.get(), false };
+    tables.push_back(std::move(new_table));
+}
+
+void tablebase::generate_all(const int& number_of_pieces, thread_pool& pool) {
+    constexpr std::array<piece_symbol, 5> symbols{ piece_symbol::pawn, piece_symbol::rook, piece_symbol::knight, piece_symbol::bishop, piece_symbol::queen };
+    std::vector<std::uint8_t> codes;
+    for (const piece_colour& colour : { piece_colour::white, piece_colour::black }) {
+        for (const piece_symbol& symbol : symbols) {
+            codes.push_back(piece_code::make(colour, symbol));
+        }
+    }
+    for (size_t first{}; first < codes.size() && number_of_pieces >= 3; first++) {
+        generate(name_of({ codes[first] }), pool);
+        for (size_t second{ first }; second < codes.size() && number_of_pieces >= 4; second++) {
+            generate(name_of({ codes[first], codes[second] }), pool);
+        }
+    }
+}
+
+std::string tablebase::material_of(const position& probe_position) {
+    std::vector<std::uint8_t> codes;
+    for (const std::uint8_t& code : probe_position.get_squares()) {
+        if (code != piece_code::empty && piece_code::symbol_of(code) != piece_symbol::king) {
+            codes.push_back(code);
+        }
+    }
+    return name_of(canonical_codes(codes));
+}
+
+bool tablebase::has_table(const std::string& material) const {
+    return std::any_of(tables.begin(), tables.end(), [&material](const std::unique_ptr<table>& existing_table) {
+        return existing_table->material == material;
+    });
+}
+
+bool tablebase::probe(const position& probe_position, tablebase_result& result) const {
+    piece_list pieces;
+    pieces.colour_turn = probe_position.get_colour_turn();
+    pieces.white_king = probe_position.get_king_square(piece_colour::white);
+    pieces.black_king = probe_position.get_king_square(piece_colour::black);
+    for (int square{}; square < 64; square++) {
+        const std::uint8_t& code{ probe_position.get_square(square) };
+        if (code == piece_code::empty || piece_code::symbol_of(code) == piece_symbol::king) {
+            continue;
+        }
+        if (pieces.number_of_others == 2) {
+            return false; //more than 4 pieces
+        }
+        pieces.codes[pieces.number_of_others] = code;
+        pieces.squares[pieces.number_of_others++] = square;
+    }
+    std::uint8_t value;
+    if (!find_value(pieces, value) || value == invalid_value) {
+        return false;
+    }
+    result.wdl = is_win(value) ? tablebase_wdl::win : (is_loss(value) ? tablebase_wdl::loss : tablebase_wdl::draw);
+    result.plies_to_mate = (value == draw_value) ? 0 : plies_of(value);
+    return true;
+}
+
+bool tablebase::best_move(const position& probe_position, chess_move& chosen_move) const {
+    move_list legal_moves;
+    probe_position.generate_legal_moves(legal_moves);
+    position next{ probe_position };
+    int best_score{ std::numeric_limits<int>::min() };
+    for (const chess_move& legal_move : legal_moves) {
+        std::uint8_t captured{ next.make_move(legal_move) };
+        tablebase_result next_result;
+        bool found{ probe(next, next_result) };
+        next.unmake_move(legal_move, captured);
+        if (!found) {
+            return false;
+        }
+        //From the point of view of the colour that moves: the fastest win, then a draw, then the slowest loss
+        int score{ next_result.wdl == tablebase_wdl::loss ? 1000 - next_result.plies_to_mate :
+            (next_result.wdl == tablebase_wdl::win ? -1000 + next_result.plies_to_mate : 0) };
+        if (score > best_score) {
+            best_score = score;
+            chosen_move = legal_move;
+        }
+    }
+    return !legal_moves.empty();
+}
+
+std::vector<tablebase_table_info> tablebase::get_table_info() const {
+    std::vector<tablebase_table_info> info;
+    for (const std::unique_ptr<table>& existing_table : tables) {
+        tablebase_table_info table_info;
+        table_info.material = existing_table->material;
+        for (const std::uint8_t& value : existing_table->values) {
+            if (value == invalid_value) {
+                continue;
+            }
+            table_info.positions++;
+            if (is_win(value)) {
+                table_info.wins++;
+                table_info.longest_mate = std::max(table_info.longest_mate, plies_of(value));
+            }
+            else if (is_loss(value)) {
+                table_info.losses++;
+                table_info.longest_mate = std::max(table_info.longest_mate, plies_of(value));
+            }
+            else {
+                table_info.draws++;
+            }
+        }
+        info.push_back(table_info);
+    }
+    return info;
+}
+
+size_t tablebase::memory_usage() const noexcept {
+    size_t bytes{};
+    for (const std::unique_ptr<table>& existing_table : tables) {
+        bytes += existing_table->values.size();
+    }
+    return bytes;
+}
@@ -0,0 +1,67 @@
+/*
+This file contains the implementation of the thread pool.
+*/
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <vector>
+
+thread_pool::thread_pool(const size_t& number_of_threads) {
+    size_t threads_to_start{ std::max<size_t>(1, number_of_threads) };
+    for (size_t i{}; i < threads_to_start; i++) {
+        workers.emplace_back(&thread_pool::worker_loop, this);
+    }
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> lock{ tasks_mutex };
+        stopping = true;
+    }
+    tasks_available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void thread_pool::worker_loop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock{ tasks_mutex };
+            tasks_available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void thread_pool::parallel_for(const size_t& number_of_items, const size_t& chunk_size,
+    const std::function<void(const size_t& slice, const size_t& begin, const size_t& end)>& function) {
+    size_t step{ std::max<size_t>(1, chunk_size) };
+    size_t number_of_chunks{ (number_of_items + step - 1) / step };
+    size_t number_of_slices{ std::min(size(), number_of_chunks) };
+    std::atomic<size_t> next_chunk{};
+    std::vector<std::future<void>> slices;
+    for (size_t slice{}; slice < number_of_slices; slice++) {
+        slices.push_back(submit([&, slice]() {
+            for (size_t chunk{ next_chunk++ }; chunk < number_of_chunks; chunk = next_chunk++) {
+                function(slice, chunk * step, std::min(number_of_items, (chunk + 1) * step));
+            }
+        }));
+    }
+    for (auto& slice_result : slices) {
+        slice_result.wait(); //All the slices must finish before returning, since they refer to local variables
+    }
+    for (auto& slice_result : slices) {
+        slice_result.get(); //Rethrows any exception thrown by the function
+    }
+}
\ No newline at end of file
@@ -0,0 +1,594 @@
+/*
+Opening book builder. It replays the games of a PGN file with the rules of the engine and counts, for every position of
+the first plies of each game, how many times each move was played and with which results. The counts are written as a
+book file (see opening_book.h) whose weights follow the Polyglot convention: 2 per win and 1 per draw of the side that
+played the move.
+The games are read in batches by the main thread while the previous batch is replayed on all the cores. Every thread
+counts into its own hash map, and a map that grows beyond its share of the memory budget is sorted and spilled to a
+temporary file (a run). At the end the maps left are spilled as well and the runs are merged, adding up the counts of
+the same moves, straight into the book file, so the memory used does not depend on the number of games. At most
+max_runs_per_merge runs are open at once: if there are more, they are first merged in groups into longer runs, as many
+times as needed, and the read buffers of the merges share the memory budget.
+The moves are replayed with position, which follows the same rules as the board (see tools/movegen_stress.cpp). As there
+is no castling, en passant or promotion, a game is only replayed up to the first such move.
+
+Options:
+    --pgn=<file>            games to read (required)
+    --output=<file>         book to write (default book.bin)
+    --max_plies=<n>         plies of each game added to the book (default 24)
+    --min_games=<n>         leave out the moves played in fewer games (default 1)
+    --weights=<results|games>   weight the moves by their results (default) or by the number of games
+    --threads=<n>           number of threads (default: all the cores)
+    --memory_mb=<n>         memory budget of the hash maps of all the threads, and then of the merge (default 1024)
+    --temp_dir=<dir>        directory of the temporary runs (default .)
+Build on Linux (from the repository root):
+    g++ -std=c++17 -O2 -pthread -Iinclude tools/book_builder.cpp $(find src -name '*.cpp' ! -name main.cpp) -o book_builder
+    ./book_builder --pgn=games.pgn --output=book.bin --max_plies=24
+*/
+
+#include "position.h"
+#include "opening_book.h"
+#include "thread_pool.h"
+#include "enum_attributes.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    enum class game_result {
+        white_wins,
+        black_wins,
+        draw,
+        unknown,
+    };
+
+    struct pgn_game {
+        std::string movetext;
+        game_result result{ game_result::unknown };
+    };
+
+    struct move_key {
+        std::uint64_t hash{};
+        std::uint8_t from{};
+        std::uint8_t to{};
+    };
+
+    bool operator==(const move_key& lhs, const move_key& rhs) {
+        return lhs.hash == rhs.hash && lhs.from == rhs.from && lhs.to == rhs.to;
+    }
+
+    bool operator<(const move_key& lhs, const move_key& rhs) {
+        return lhs.hash != rhs.hash ? lhs.hash < rhs.hash : (lhs.from != rhs.from ? lhs.from < rhs.from : lhs.to < rhs.to);
+    }
+
+    struct move_key_hash {
+        size_t operator()(const move_key& key) const noexcept {
+            //The position hash is already uniform, the squares only tell apart the moves of the same position
+            return static_cast<size_t>(key.hash ^ (std::uint64_t{ key.from } << 8 | key.to) * 0x9E3779B97F4A7C15ULL);
+        }
+    };
+
+    //Counts from the point of view of the side that played the move
+    struct move_stats {
+        std::uint32_t games{};
+        std::uint32_t wins{};
+        std::uint32_t draws{};
+        std::uint32_t losses{};
+    };
+
+    //Record of the temporary runs, sorted by key
+    struct run_record {
+        move_key key;
+        move_stats stats;
+    };
+
+    using move_map = std::unordered_map<move_key, move_stats, move_key_hash>;
+
+    //Merge sorted runs, calling add_record once for each move with its counts added up over the runs, in the order of
+    //the keys. The runs are removed once merged
+    template <class c_function> void merge_run_files(const std::vector<std::string>& paths, const size_t& records_per_read, c_function&& add_record) {
+        struct run_cursor {
+            std::FILE* file{ nullptr };
+            std::vector<run_record> buffer;
+            size_t position{};
+
+            bool refill(const size_t& records_per_read) {
+                buffer.resize(records_per_read);
+                buffer.resize(std::fread(buffer.data(), sizeof(run_record), records_per_read, file));
+                position = 0;
+                return !buffer.empty();
+            }
+        };
+        std::vector<run_cursor> cursors(paths.size());
+        auto close_runs = [&cursors]() {
+            for (run_cursor& cursor : cursors) {
+                if (cursor.file) {
+                    std::fclose(cursor.file);
+                }
+            }
+        };
+        auto greater_key = [&cursors](const size_t& lhs, const size_t& rhs) {
+            return cursors[rhs].buffer[cursors[rhs].position].key < cursors[lhs].buffer[cursors[lhs].position].key;
+        };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(greater_key)> next_run{ greater_key };
+        for (size_t run{}; run < paths.size(); run++) {
+            cursors[run].file = std::fopen(paths[run].c_str(), "rb");
+            if (!cursors[run].file) {
+                close_runs();
+                throw std::runtime_error("Error: could not read the temporary run " + paths[run] + ".");
+            }
+            if (cursors[run].refill(records_per_read)) {
+                next_run.push(run);
+            }
+        }
+
+        bool has_current{ false };
+        run_record current{};
+        while (!next_run.empty()) {
+            size_t run{ next_run.top() };
+            next_run.pop();
+            run_cursor& cursor{ cursors[run] };
+            const run_record& record{ cursor.buffer[cursor.position] };
+            if (has_current && current.key == record.key) {
+                current.stats.games += record.stats.games;
+                current.stats.wins += record.stats.wins;
+                current.stats.draws += record.stats.draws;
+                current.stats.losses += record.stats.losses;
+            }
+            else {
+                if (has_current) {
+                    add_record(current);
+                }
+                current = record;
+                has_current = true;
+            }
+            cursor.position++;
+            if (cursor.position < cursor.buffer.size() || cursor.refill(records_per_read)) {
+                next_run.push(run);
+            }
+        }
+        if (has_current) {
+            add_record(current);
+        }
+        close_runs();
+        for (const std::string& path : paths) {
+            std::remove(path.c_str());
+        }
+    }
+
+    //Rough size of a map entry: the node, with its key, value, hash and pointer, and its share of the buckets
+    constexpr size_t bytes_per_map_entry{ 80 };
+    constexpr size_t games_per_batch{ 4096 };
+    constexpr size_t games_per_chunk{ 64 };
+    //Far below the usual limit of 1024 open files, as each run being merged keeps its file open
+    constexpr size_t max_runs_per_merge{ 128 };
+    constexpr size_t min_records_per_read{ 256 };
+
+    struct options {
+        std::string pgn_path;
+        std::string output_path{ "book.bin" };
+        int max_plies{ 24 };
+        std::uint32_t min_games{ 1 };
+        bool weights_from_results{ true };
+        size_t threads{ std::max(1u, std::thread::hardware_concurrency()) };
+        size_t memory_mb{ 1024 };
+        std::string temp_dir{ "." };
+    };
+
+    struct build_statistics {
+        std::atomic<unsigned long long> games{};
+        std::atomic<unsigned long long> games_stopped_early{}; //at a castling, en passant or promotion or an unreadable move
+        std::atomic<unsigned long long> moves{};
+    };
+
+    //Reads the games of a PGN file one at a time. Only the Result tag is kept from the tag pairs
+    class pgn_reader {
+    private:
+        std::ifstream file;
+        std::string line;
+        bool line_pending{ false };
+    public:
+        pgn_reader(const std::string& path) : file{ path } {
+            if (!file) {
+                throw std::runtime_error("Error: could not open " + path + ".");
+            }
+        }
+
+        bool read_game(pgn_game& game) {
+            game.movetext.clear();
+            game.result = game_result::unknown;
+            bool in_movetext{ false };
+            bool found_anything{ false };
+            while (line_pending || std::getline(file, line)) {
+                line_pending = false;
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                if (!line.empty() && line[0] == '[') {
+                    if (in_movetext) {
+                        line_pending = true; //tag of the next game
+                        return true;
+                    }
+                    found_anything = true;
+                    if (line.rfind("[Result \"", 0) == 0) {
+                        std::string_view value{ std::string_view{ line }.substr(9) };
+                        if (value.rfind("1-0", 0) == 0) {
+                            game.result = game_result::white_wins;
+                        }
+                        else if (value.rfind("0-1", 0) == 0) {
+                            game.result = game_result::black_wins;
+                        }
+                        else if (value.rfind("1/2-1/2", 0) == 0) {
+                            game.result = game_result::draw;
+                        }
+                    }
+                }
+                else if (!line.empty() && line[0] != '%') { //lines starting with % are escaped
+                    in_movetext = true;
+                    found_anything = true;
+                    game.movetext += line;
+                    game.movetext += '\n';
+                }
+            }
+            return found_anything;
+        }
+    };
+
+    //Find the legal move written in standard algebraic notation (e.g. "Nbd7", "exd5", "Qh4+")
+    bool find_san_move(const position& game_position, std::string_view san, chess_move& found_move) {
+        while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?')) {
+            san.remove_suffix(1);
+        }
+        if (san.size() < 2 || san[0] == 'O' || san[0] == '0' || san.find('=') != std::string_view::npos) {
+            return false; //castling and promotion do not exist under these rules
+        }
+        piece_symbol symbol{ piece_symbol::pawn };
+        switch (san[0]) {
+        case 'K': symbol = piece_symbol::king; break;
+        case 'Q': symbol = piece_symbol::queen; break;
+        case 'R': symbol = piece_symbol::rook; break;
+        case 'B': symbol = piece_symbol::bishop; break;
+        case 'N': symbol = piece_symbol::knight; break;
+        default: break;
+        }
+        if (symbol != piece_symbol::pawn) {
+            san.remove_prefix(1);
+        }
+        char to_column{ san[san.size() - 2] };
+        char to_row{ san[san.size() - 1] };
+        if (to_column < 'a' || to_column > 'h' || to_row < '1' || to_row > '8') {
+            return false;
+        }
+        int to{ 8 * (to_row - '1') + (to_column - 'a') };
+        int from_column{ -1 };
+        int from_row{ -1 };
+        for (const char& disambiguation : san.substr(0, san.size() - 2)) {
+            if ('a' <= disambiguation && disambiguation <= 'h') {
+                from_column = disambiguation - 'a';
+            }
+            else if ('1' <= disambiguation && disambiguation <= '8') {
+                from_row = disambiguation - '1';
+            }
+            else if (disambiguation != 'x' && disambiguation != '-') {
+                return false;
+            }
+        }
+        //Legality is only checked for the moves that match the text
+        move_list pseudo_legal_moves;
+        game_position.generate_pseudo_legal_moves(pseudo_legal_moves);
+        int matches{};
+        for (const chess_move& candidate : pseudo_legal_moves) {
+            if (candidate.to == to && piece_code::symbol_of(game_position.get_square(candidate.from)) == symbol &&
+                (from_column < 0 || candidate.from % 8 == from_column) && (from_row < 0 || candidate.from / 8 == from_row) &&
+                game_position.is_legal(candidate)) {
+                found_move = candidate;
+                matches++;
+            }
+        }
+        return matches == 1;
+    }
+
+    //Split the movetext into its moves, leaving out the move numbers, comments, variations, annotations and the result
+    template <class c_function> void for_each_san_move(const std::string& movetext, c_function&& function) {
+        size_t index{};
+        int variation_depth{};
+        while (index < movetext.size()) {
+            char current{ movetext[index] };
+            if (current == '{') {
+                size_t end{ movetext.find('}', index) };
+                index = (end == std::string::npos) ? movetext.size() : end + 1;
+                continue;
+            }
+            if (current == ';') {
+                size_t end{ movetext.find('\n', index) };
+                index = (end == std::string::npos) ? movetext.size() : end + 1;
+                continue;
+            }
+            if (current == '(' || current == ')') {
+                variation_depth += (current == '(') ? 1 : -1;
+                index++;
+                continue;
+            }
+            if (std::isspace(static_cast<unsigned char>(current))) {
+                index++;
+                continue;
+            }
+            size_t end{ index };
+            while (end < movetext.size() && !std::isspace(static_cast<unsigned char>(movetext[end])) &&
+                movetext[end] != '{' && movetext[end] != '(' && movetext[end] != ')' && movetext[end] != ';') {
+                end++;
+            }
+            std::string_view token{ std::string_view{ movetext }.substr(index, end - index) };
+            index = end;
+            if (variation_depth > 0 || token[0] == '$') {
+                continue;
+            }
+            if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*") {
+                return;
+            }
+            //Move numbers, possibly joined to the move ("12.", "12...", "12.Nf3")
+            size_t move_start{ token.find_first_not_of("0123456789.") };
+            if (move_start == std::string_view::npos) {
+                continue;
+            }
+            if (!function(token.substr(move_start))) {
+                return;
+            }
+        }
+    }
+
+    class book_builder {
+    private:
+        const options& settings;
+        size_t entries_per_map;
+        std::vector<move_map> maps; //one per slice of the thread pool
+        std::mutex runs_mutex;
+        std::vector<std::string> run_paths; //spilled runs, not merged yet
+        size_t runs_created{}; //spilled and merged runs, to name them
+        size_t runs_spilled{};
+        build_statistics statistics;
+
+        std::string new_run_path() {
+            std::lock_guard<std::mutex> lock{ runs_mutex };
+            return settings.temp_dir + "/book_builder_run_" + std::to_string(runs_created++) + ".tmp";
+        }
+
+        void spill(move_map& map) {
+            if (map.empty()) {
+                return;
+            }
+            std::vector<run_record> records;
+            records.reserve(map.size());
+            for (const auto& [key, stats] : map) {
+                records.push_back({ key, stats });
+            }
+            move_map{}.swap(map); //release the nodes and the buckets
+            std::sort(records.begin(), records.end(), [](const run_record& lhs, const run_record& rhs) {
+                return lhs.key < rhs.key;
+            });
+            std::string run_path{ new_run_path() };
+            {
+                std::lock_guard<std::mutex> lock{ runs_mutex };
+                run_paths.push_back(run_path);
+                runs_spilled++;
+            }
+            std::FILE* run{ std::fopen(run_path.c_str(), "wb") };
+            if (!run || std::fwrite(records.data(), sizeof(run_record), records.size(), run) != records.size() || std::fclose(run) != 0) {
+                throw std::runtime_error("Error: could not write the temporary run " + run_path + ".");
+            }
+        }
+
+        void replay_game(const pgn_game& game, move_map& map) {
+            position game_position;
+            int ply{};
+            bool stopped_early{ false };
+            for_each_san_move(game.movetext, [&](std::string_view san) {
+                if (ply >= settings.max_plies) {
+                    return false;
+                }
+                chess_move game_move;
+                if (!find_san_move(game_position, san, game_move)) {
+                    stopped_early = true;
+                    return false;
+                }
+                move_stats& stats{ map[{ game_position.get_hash(), game_move.from, game_move.to }] };
+                stats.games++;
+                bool white_moves{ game_position.get_colour_turn() == piece_colour::white };
+                switch (game.result) {
+                case game_result::white_wins: (white_moves ? stats.wins : stats.losses)++; break;
+                case game_result::black_wins: (white_moves ? stats.losses : stats.wins)++; break;
+                case game_result::draw: stats.draws++; break;
+                default: break;
+                }
+                game_position.make_move(game_move);
+                ply++;
+                return true;
+            });
+            statistics.games++;
+            statistics.games_stopped_early += stopped_early;
+            statistics.moves += ply;
+        }
+
+        std::uint16_t weight(const move_stats& stats) const {
+            std::uint64_t value{ settings.weights_from_results ? 2ULL * stats.wins + stats.draws : stats.games };
+            return static_cast<std::uint16_t>(std::min<std::uint64_t>(value, 0xFFFF));
+        }
+
+        //Merge the runs, in groups of at most max_runs_per_merge, until they can be merged at once into the book
+        std::uint64_t merge_runs() {
+            //Records are read in blocks, one buffer per run merged at once and one more to write the merged run
+            size_t records_per_read{ std::max(min_records_per_read, settings.memory_mb * 1024 * 1024 / (max_runs_per_merge + 1) / sizeof(run_record)) };
+            std::vector<std::string> runs;
+            runs.swap(run_paths);
+            while (runs.size() > max_runs_per_merge) {
+                std::vector<std::string> merged_runs;
+                for (size_t first{}; first < runs.size(); first += max_runs_per_merge) {
+                    std::vector<std::string> group(runs.begin() + first, runs.begin() + std::min(runs.size(), first + max_runs_per_merge));
+                    if (group.size() == 1) {
+                        merged_runs.push_back(group[0]);
+                        continue;
+                    }
+                    std::string merged_path{ new_run_path() };
+                    std::FILE* merged{ std::fopen(merged_path.c_str(), "wb") };
+                    if (!merged) {
+                        throw std::runtime_error("Error: could not write the temporary run " + merged_path + ".");
+                    }
+                    std::vector<run_record> output;
+                    output.reserve(records_per_read);
+                    bool written{ true };
+                    auto write_output = [&]() {
+                        written = written && std::fwrite(output.data(), sizeof(run_record), output.size(), merged) == output.size();
+                        output.clear();
+                    };
+                    merge_run_files(group, records_per_read, [&](const run_record& record) {
+                        output.push_back(record);
+                        if (output.size() == records_per_read) {
+                            write_output();
+                        }
+                    });
+                    write_output();
+                    if (std::fclose(merged) != 0 || !written) {
+                        throw std::runtime_error("Error: could not write the temporary run " + merged_path + ".");
+                    }
+                    merged_runs.push_back(merged_path);
+                }
+                runs.swap(merged_runs);
+            }
+
+            opening_book_writer writer{ settings.output_path };
+            merge_run_files(runs, records_per_read, [&](const run_record& record) {
+                if (record.stats.games >= settings.min_games && weight(record.stats) > 0) {
+                    writer.add({ record.key.hash, record.key.from, record.key.to, weight(record.stats) });
+                }
+            });
+            writer.finish();
+            return writer.size();
+        }
+    public:
+        book_builder(const options& settings_in, const size_t& number_of_slices) : settings{ settings_in },
+            entries_per_map{ std::max<size_t>(1024, settings_in.memory_mb * 1024 * 1024 / bytes_per_map_entry / number_of_slices) },
+            maps(number_of_slices) {}
+
+        void add_games(thread_pool& pool, const std::vector<pgn_game>& games) {
+            pool.parallel_for(games.size(), games_per_chunk, [this, &games](const size_t& slice, const size_t& begin, const size_t& end) {
+                for (size_t index{ begin }; index < end; index++) {
+                    replay_game(games[index], maps[slice]);
+                }
+                if (maps[slice].size() >= entries_per_map) {
+                    spill(maps[slice]);
+                }
+            });
+        }
+
+        std::uint64_t finish() {
+            for (move_map& map : maps) {
+                spill(map);
+            }
+            return merge_runs();
+        }
+
+        size_t number_of_runs() const noexcept { return runs_spilled; }
+        const build_statistics& get_statistics() const noexcept { return statistics; }
+    };
+
+    options parse_options(const int& argc, char** argv) {
+        options settings;
+        for (int i{ 1 }; i < argc; i++) {
+            std::string argument{ argv[i] };
+            auto value = [&argument](const std::string& name) { return argument.substr(name.size()); };
+            if (argument.rfind("--pgn=", 0) == 0) {
+                settings.pgn_path = value("--pgn=");
+            }
+            else if (argument.rfind("--output=", 0) == 0) {
+                settings.output_path = value("--output=");
+            }
+            else if (argument.rfind("--max_plies=", 0) == 0) {
+                settings.max_plies = std::max(1, std::atoi(value("--max_plies=").c_str()));
+            }
+            else if (argument.rfind("--min_games=", 0) == 0) {
+                settings.min_games = static_cast<std::uint32_t>(std::max(1, std::atoi(value("--min_games=").c_str())));
+            }
+            else if (argument.rfind("--weights=", 0) == 0) {
+                settings.weights_from_results = value("--weights=") != "games";
+            }
+            else if (argument.rfind("--threads=", 0) == 0) {
+                settings.threads = static_cast<size_t>(std::max(1, std::atoi(value("--threads=").c_str())));
+            }
+            else if (argument.rfind("--memory_mb=", 0) == 0) {
+                settings.memory_mb = static_cast<size_t>(std::max(1, std::atoi(value("--memory_mb=").c_str())));
+            }
+            else if (argument.rfind("--temp_dir=", 0) == 0) {
+                settings.temp_dir = value("--temp_dir=");
+            }
+            else {
+                throw std::invalid_argument("Unknown option " + argument);
+            }
+        }
+        if (settings.pgn_path.empty()) {
+            throw std::invalid_argument("The PGN file must be given with --pgn=<file>");
+        }
+        return settings;
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        options settings{ parse_options(argc, argv) };
+        auto start{ std::chrono::steady_clock::now() };
+        thread_pool pool{ settings.threads };
+        book_builder builder{ settings, pool.size() };
+        pgn_reader reader{ settings.pgn_path };
+
+        //The next batch is read while the current one is replayed
+        std::vector<pgn_game> reading_batch(games_per_batch);
+        std::vector<pgn_game> replaying_batch;
+        std::future<void> replaying;
+        bool more_games{ true };
+        while (more_games) {
+            size_t games_read{};
+            while (games_read < games_per_batch && reader.read_game(reading_batch[games_read])) {
+                games_read++;
+            }
+            more_games = games_read == games_per_batch;
+            reading_batch.resize(games_read);
+            if (replaying.valid()) {
+                replaying.get();
+            }
+            std::swap(reading_batch, replaying_batch);
+            reading_batch.resize(games_per_batch);
+            replaying = std::async(std::launch::async, [&pool, &builder, &replaying_batch]() {
+                builder.add_games(pool, replaying_batch);
+            });
+        }
+        replaying.get();
+        std::uint64_t number_of_entries{ builder.finish() };
+
+        double elapsed{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+        const build_statistics& statistics{ builder.get_statistics() };
+        std::cout << "Replayed " << statistics.games << " games (" << statistics.games_stopped_early
+            << " stopped before the last ply at a move the rules do not have) and " << statistics.moves << " moves in "
+            << elapsed << " s, with " << builder.number_of_runs() << " temporary runs." << std::endl
+            << "Wrote " << number_of_entries << " book entries to " << settings.output_path << "." << std::endl;
+    }
+    catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,433 @@
+/*
+Differential stress tester of the move generators. It plays random legal games on all the cores and, at every position,
+compares the moves generated by the fast path (position::generate_legal_moves) with those of the reference path
+(board::get_piece_allowed_moves, called for every piece of the colour turn), as well as the check status given by
+position::in_check and board::check_for_check. It also checks that the material and piece-square score that the
+position updates incrementally matches the one recomputed from scratch, after making and unmaking every legal move, and
+the same for the hash, which must also be equal to the one the board computes from its pieces, and that the move picker
+(move_picker.h), given random hints, hands out each legal move exactly once.
+Before the games, the occupancy kernels (occupancy.h) are run at every SIMD level the processor supports on the
+positions of random games, and their results compared with those of the scalar versions. The level is global, so this
+part runs on the main thread only.
+When the two disagree, the position is shrunk by removing pieces for as long as the disagreement persists, and the
+minimal position is reported as a FEN string together with the moves that differ.
+
+Options:
+    --seconds=<n>       duration of the run (default 60)
+    --threads=<n>       number of threads (default: all the cores)
+    --seed=<n>          seed of the random games (default 1)
+    --max_plies=<n>     maximum length of a game (default 300)
+    --max_reports=<n>   stop after this many distinct disagreements (default 10)
+Build on Linux (from the repository root):
+    g++ -std=c++17 -O2 -pthread -Iinclude tools/movegen_stress.cpp $(find src -name '*.cpp' ! -name main.cpp) -o movegen_stress
+*/
+
+#include "board.h"
+#include "position.h"
+#include "coordinate_transforms.h"
+#include "enum_attributes.h"
+#include "evaluation.h"
+#include "move_picker.h"
+#include "occupancy.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct stress_options {
+        double seconds{ 60 };
+        unsigned int threads{ std::max(1u, std::thread::hardware_concurrency()) };
+        unsigned long long seed{ 1 };
+        int max_plies{ 300 };
+        int max_reports{ 10 };
+    };
+
+    //Square (0 to 63) that the piece of the opposite colour moved to in the last move, or -1 at the start of the game
+    struct last_move_info {
+        int square{ -1 };
+    };
+
+    std::string square_name(const int& square) {
+        std::pair<char, int> coords{ coordinates::to_board_coordinates(square + 1) };
+        return std::string(1, coords.first) + std::to_string(coords.second);
+    }
+
+    //Compare both generators on a position. Returns an empty string if they agree, otherwise a description of the differences
+    std::string compare_generators(const position& fast_position, const last_move_info& last_move) {
+        std::ostringstream differences;
+        try {
+            board reference_board{ fast_position.to_fen() };
+            bool last_move_check{ false };
+            if (last_move.square >= 0) {
+                bool reference_check{ reference_board.check_for_check(coordinates::to_board_coordinates(last_move.square + 1), last_move_check) };
+                if (reference_check != fast_position.in_check()) {
+                    differences << "check: reference " << reference_check << ", fast " << fast_position.in_check() << "; ";
+                }
+            }
+            if (reference_board.get_hash(fast_position.get_colour_turn()) != fast_position.get_hash()) {
+                differences << "hash: reference and fast differ; ";
+            }
+            move_list fast_moves;
+            fast_position.generate_legal_moves(fast_moves);
+            for (int square{}; square < 64; square++) {
+                std::uint8_t code{ fast_position.get_square(square) };
+                if (code == piece_code::empty || piece_code::colour_of(code) != fast_position.get_colour_turn()) {
+                    continue;
+                }
+                std::list<int> reference_locations{ reference_board.get_piece_allowed_moves(coordinates::to_board_coordinates(square + 1),
+                    last_move_check, last_move.square + 1) };
+                std::vector<int> reference_squares;
+                for (const int& location : reference_locations) {
+                    reference_squares.push_back(location - 1);
+                }
+                std::vector<int> fast_squares;
+                for (const chess_move& fast_move : fast_moves) {
+                    if (fast_move.from == square) {
+                        fast_squares.push_back(fast_move.to);
+                    }
+                }
+                std::sort(reference_squares.begin(), reference_squares.end());
+                std::sort(fast_squares.begin(), fast_squares.end());
+                std::vector<int> only_reference;
+                std::vector<int> only_fast;
+                std::set_difference(reference_squares.begin(), reference_squares.end(), fast_squares.begin(), fast_squares.end(), std::back_inserter(only_reference));
+                std::set_difference(fast_squares.begin(), fast_squares.end(), reference_squares.begin(), reference_squares.end(), std::back_inserter(only_fast));
+                for (const int& to : only_reference) {
+                    differences << "only reference: " << square_name(square) << "-" << square_name(to) << "; ";
+                }
+                for (const int& to : only_fast) {
+                    differences << "only fast: " << square_name(square) << "-" << square_name(to) << "; ";
+                }
+            }
+        }
+        catch (const std::exception& reference_err) {
+            differences << "reference threw: " << reference_err.what() << "; ";
+        }
+        return differences.str();
+    }
+
+    bool same_score(const material_pst_score& lhs, const material_pst_score& rhs) {
+        return lhs.middlegame == rhs.middlegame && lhs.endgame == rhs.endgame && lhs.phase == rhs.phase;
+    }
+
+    //A position built again from its FEN computes the hash from scratch
+    bool same_hash_from_scratch(const position& game_position) {
+        return game_position.get_hash() == position{ game_position.to_fen() }.get_hash();
+    }
+
+    //Check the incremental material and piece-square score and hash after making and after unmaking each of the moves
+    std::string compare_incremental_score(position game_position, const move_list& moves) {
+        material_pst_score original_score{ game_position.get_material_pst() };
+        std::uint64_t original_hash{ game_position.get_hash() };
+        if (!same_score(original_score, evaluation::material_pst_from_scratch(game_position))) {
+            return "incremental score differs from the recomputed one; ";
+        }
+        if (!same_hash_from_scratch(game_position)) {
+            return "incremental hash differs from the recomputed one; ";
+        }
+        for (const chess_move& legal_move : moves) {
+            std::uint8_t captured{ game_position.make_move(legal_move) };
+            bool score_after_make_ok{ same_score(game_position.get_material_pst(), evaluation::material_pst_from_scratch(game_position)) };
+            bool hash_after_make_ok{ same_hash_from_scratch(game_position) };
+            game_position.unmake_move(legal_move, captured);
+            if (!score_after_make_ok || !same_score(game_position.get_material_pst(), original_score)) {
+                return "incremental score differs after making or unmaking " + square_name(legal_move.from) + "-" + square_name(legal_move.to) + "; ";
+            }
+            if (!hash_after_make_ok || game_position.get_hash() != original_hash) {
+                return "incremental hash differs after making or unmaking " + square_name(legal_move.from) + "-" + square_name(legal_move.to) + "; ";
+            }
+        }
+        return "";
+    }
+
+    //The picker must hand out the legal moves, each once, whatever its hints: legal moves, moves of other positions or
+    //moves that cannot be played at all
+    std::string compare_picker(const position& game_position, const move_list& moves, std::mt19937_64& random_engine) {
+        auto random_hint = [&]() {
+            if (!moves.empty() && random_engine() % 2 == 0) {
+                return moves[random_engine() % moves.size()];
+            }
+            return chess_move{ static_cast<std::uint8_t>(random_engine() % 64), static_cast<std::uint8_t>(random_engine() % 64) };
+        };
+        std::array<int, 64 * 64> history;
+        for (int& score : history) {
+            score = static_cast<int>(random_engine() % 2001) - 1000;
+        }
+        move_picker_hints hints;
+        hints.hash_move = random_hint();
+        hints.killers = { random_hint(), random_hint() };
+        hints.countermove = random_hint();
+        hints.history = &history;
+        move_picker picker{ game_position, hints };
+        std::set<std::pair<int, int>> expected;
+        for (const chess_move& legal_move : moves) {
+            expected.insert({ legal_move.from, legal_move.to });
+        }
+        chess_move picked_move;
+        while (picker.next(picked_move)) {
+            if (expected.erase({ picked_move.from, picked_move.to }) == 0) {
+                return "move picker handed out " + square_name(picked_move.from) + "-" + square_name(picked_move.to) + " twice or though it is not legal; ";
+            }
+        }
+        if (!expected.empty()) {
+            return "move picker did not hand out " + std::to_string(expected.size()) + " legal moves; ";
+        }
+        return "";
+    }
+
+    //Remove pieces one at a time, keeping each removal after which the generators still disagree
+    position shrink(position failing_position, last_move_info& last_move) {
+        bool removed_piece{ true };
+        while (removed_piece) {
+            removed_piece = false;
+            for (int square{}; square < 64; square++) {
+                std::uint8_t code{ failing_position.get_square(square) };
+                if (code == piece_code::empty || piece_code::symbol_of(code) == piece_symbol::king) {
+                    continue;
+                }
+                position candidate{ failing_position };
+                candidate.set_square(square, piece_code::empty);
+                last_move_info candidate_last_move{ square == last_move.square ? last_move_info{} : last_move };
+                if (!compare_generators(candidate, candidate_last_move).empty()) {
+                    failing_position = candidate;
+                    last_move = candidate_last_move;
+                    removed_piece = true;
+                }
+            }
+        }
+        return failing_position;
+    }
+
+    //Positions of random games, to feed the occupancy kernels
+    std::vector<position> random_positions(const size_t& number_of_positions, const unsigned long long& seed) {
+        std::mt19937_64 random_engine{ seed };
+        std::vector<position> positions;
+        move_list moves;
+        while (positions.size() < number_of_positions) {
+            position game_position;
+            for (int ply{}; ply < 200 && positions.size() < number_of_positions; ply++) {
+                positions.push_back(game_position);
+                game_position.generate_legal_moves(moves);
+                if (moves.empty()) {
+                    break;
+                }
+                game_position.make_move(moves[std::uniform_int_distribution<size_t>{ 0, moves.size() - 1 }(random_engine)]);
+            }
+        }
+        return positions;
+    }
+
+    std::array<board_occupation, 64> board_matrix_of(const position& game_position) {
+        std::array<board_occupation, 64> board_matrix;
+        for (int square{}; square < 64; square++) {
+            std::uint8_t code{ game_position.get_square(square) };
+            board_matrix[square] = code == piece_code::empty ? board_occupation::empty : static_cast<board_occupation>(piece_code::colour_of(code));
+        }
+        return board_matrix;
+    }
+
+    //Results of all the occupancy kernels on the same input, at the current SIMD level. The batches take every length
+    //up to batch_lengths, so that the tails the vector versions leave to scalar code are covered too
+    struct kernel_results {
+        static constexpr size_t batch_lengths{ 40 };
+
+        std::vector<std::uint64_t> from_board_matrix; //white and black mask of each position
+        std::vector<std::uint64_t> from_squares;
+        std::vector<std::uint8_t> popcounts;
+        std::vector<size_t> equal_positions;
+        std::vector<bool> positions_equal;
+        std::vector<int> mobility;
+
+        explicit kernel_results(const std::vector<position>& positions) {
+            for (const position& game_position : positions) {
+                occupancy_masks matrix_masks{ occupancy::from_board_matrix(board_matrix_of(game_position)) };
+                occupancy_masks square_masks{ occupancy::from_squares(game_position.get_squares()) };
+                from_board_matrix.insert(from_board_matrix.end(), { matrix_masks.white, matrix_masks.black });
+                from_squares.insert(from_squares.end(), { square_masks.white, square_masks.black });
+            }
+            const std::vector<std::uint64_t>& masks{ from_squares };
+            popcounts.resize(masks.size());
+            occupancy::popcount_batch(masks.data(), masks.size(), popcounts.data());
+            for (size_t length{}; length <= batch_lengths && length <= positions.size(); length++) {
+                std::vector<position> batch(positions.begin(), positions.begin() + length);
+                std::vector<std::uint8_t> counts(length);
+                occupancy::popcount_batch(masks.data(), length, counts.data());
+                popcounts.insert(popcounts.end(), counts.begin(), counts.end());
+                std::vector<int> batch_mobility;
+                occupancy::batch_mobility(batch, batch_mobility);
+                mobility.insert(mobility.end(), batch_mobility.begin(), batch_mobility.end());
+                //Each game starts from the same position, so the batches hold equal positions too
+                for (size_t needle{}; needle < length; needle++) {
+                    equal_positions.push_back(occupancy::count_equal_positions(positions[needle], batch));
+                    positions_equal.push_back(occupancy::positions_equal(positions[needle], positions[length - 1]));
+                }
+            }
+            std::vector<int> all_mobility;
+            occupancy::batch_mobility(positions, all_mobility);
+            mobility.insert(mobility.end(), all_mobility.begin(), all_mobility.end());
+        }
+    };
+
+    //Compare the kernels at every supported SIMD level with the scalar ones. Returns a description of the differences
+    std::string compare_simd_levels(const std::vector<position>& positions) {
+        occupancy::simd_level original_level{ occupancy::get_simd_level() };
+        occupancy::set_simd_level(occupancy::simd_level::scalar);
+        kernel_results scalar_results{ positions };
+        std::ostringstream differences;
+        for (int level{ static_cast<int>(occupancy::simd_level::scalar) + 1 }; level <= static_cast<int>(occupancy::get_supported_simd_level()); level++) {
+            occupancy::set_simd_level(static_cast<occupancy::simd_level>(level));
+            kernel_results results{ positions };
+            const char* name{ occupancy::simd_level_name(occupancy::get_simd_level()) };
+            auto compare = [&](const char* kernel, const auto& expected, const auto& actual) {
+                if (expected != actual) {
+                    differences << kernel << ": " << name << " differs from scalar; ";
+                }
+            };
+            compare("from_board_matrix", scalar_results.from_board_matrix, results.from_board_matrix);
+            compare("from_squares", scalar_results.from_squares, results.from_squares);
+            compare("popcount_batch", scalar_results.popcounts, results.popcounts);
+            compare("count_equal_positions", scalar_results.equal_positions, results.equal_positions);
+            compare("positions_equal", scalar_results.positions_equal, results.positions_equal);
+            compare("batch_mobility", scalar_results.mobility, results.mobility);
+        }
+        occupancy::set_simd_level(original_level);
+        return differences.str();
+    }
+
+    class stress_tester {
+    private:
+        stress_options options;
+        std::atomic<unsigned long long> positions_tested{};
+        std::atomic<unsigned long long> games_played{};
+        std::atomic<int> reports{};
+        std::atomic<bool> stop{ false };
+        std::mutex output_mutex;
+        std::set<std::string> reported_positions;
+
+        void report(const position& failing_position, const last_move_info& last_move) {
+            last_move_info minimal_last_move{ last_move };
+            position minimal_position{ shrink(failing_position, minimal_last_move) };
+            std::lock_guard<std::mutex> lock{ output_mutex };
+            if (!reported_positions.insert(minimal_position.to_fen()).second) {
+                return; //The same minimal reproduction was already reported
+            }
+            if (++reports >= options.max_reports) {
+                stop = true;
+            }
+            std::cout << "MISMATCH " << minimal_position.to_fen();
+            if (minimal_last_move.square >= 0) {
+                std::cout << " (last move to " << square_name(minimal_last_move.square) << ")";
+            }
+            std::cout << std::endl << "    " << compare_generators(minimal_position, minimal_last_move) << std::endl
+                << "    found in " << failing_position.to_fen() << std::endl;
+        }
+
+        void play_games(const unsigned int& thread_index) {
+            std::mt19937_64 random_engine{ options.seed * 1000003 + thread_index };
+            move_list moves;
+            while (!stop) {
+                position game_position;
+                last_move_info last_move;
+                for (int ply{}; ply < options.max_plies && !stop; ply++) {
+                    if (!compare_generators(game_position, last_move).empty()) {
+                        report(game_position, last_move);
+                        break;
+                    }
+                    positions_tested++;
+                    game_position.generate_legal_moves(moves);
+                    std::string score_error{ compare_incremental_score(game_position, moves) };
+                    if (score_error.empty()) {
+                        score_error = compare_picker(game_position, moves, random_engine);
+                    }
+                    if (!score_error.empty()) {
+                        std::lock_guard<std::mutex> lock{ output_mutex };
+                        std::cout << "MISMATCH " << game_position.to_fen() << std::endl << "    " << score_error << std::endl;
+                        if (++reports >= options.max_reports) {
+                            stop = true;
+                        }
+                        break;
+                    }
+                    if (moves.empty()) { //checkmate or stalemate
+                        break;
+                    }
+                    chess_move random_move{ moves[std::uniform_int_distribution<size_t>{ 0, moves.size() - 1 }(random_engine)] };
+                    game_position.make_move(random_move);
+                    last_move.square = random_move.to;
+                }
+                games_played++;
+            }
+        }
+    public:
+        stress_tester(const stress_options& options_in) : options{ options_in } {}
+
+        int run() {
+            std::vector<position> kernel_positions{ random_positions(2000, options.seed) };
+            std::string simd_error{ compare_simd_levels(kernel_positions) };
+            std::cout << "Compared the occupancy kernels up to " << occupancy::simd_level_name(occupancy::get_supported_simd_level())
+                << " with the scalar ones on " << kernel_positions.size() << " positions" << std::endl;
+            if (!simd_error.empty()) {
+                std::cout << "MISMATCH occupancy kernels" << std::endl << "    " << simd_error << std::endl;
+                reports++;
+            }
+            std::cout << "Running on " << options.threads << " threads for " << options.seconds << " s (seed " << options.seed << ")" << std::endl;
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for (unsigned int thread_index{}; thread_index < options.threads; thread_index++) {
+                threads.emplace_back(&stress_tester::play_games, this, thread_index);
+            }
+            while (!stop && std::chrono::steady_clock::now() - start < std::chrono::duration<double>(options.seconds)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+            stop = true;
+            for (auto& worker : threads) {
+                worker.join();
+            }
+            double elapsed{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+            std::cout << "Tested " << positions_tested << " positions in " << games_played << " games ("
+                << static_cast<unsigned long long>(60 * positions_tested / elapsed) << " positions per minute), "
+                << reports << " distinct mismatches." << std::endl;
+            return reports ? 1 : 0;
+        }
+    };
+}
+
+int main(int argc, char** argv) {
+    stress_options options;
+    for (int i{ 1 }; i < argc; i++) {
+        std::string argument{ argv[i] };
+        std::string value{ argument.substr(argument.find('=') + 1) };
+        if (argument.rfind("--seconds=", 0) == 0) {
+            options.seconds = std::atof(value.c_str());
+        }
+        else if (argument.rfind("--threads=", 0) == 0) {
+            options.threads = std::max(1, std::atoi(value.c_str()));
+        }
+        else if (argument.rfind("--seed=", 0) == 0) {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (argument.rfind("--max_plies=", 0) == 0) {
+            options.max_plies = std::atoi(value.c_str());
+        }
+        else if (argument.rfind("--max_reports=", 0) == 0) {
+            options.max_reports = std::max(1, std::atoi(value.c_str()));
+        }
+        else {
+            std::cerr << "Unknown option " << argument << std::endl;
+            return 1;
+        }
+    }
+    stress_tester tester{ options };
+    return tester.run();
+}
\ No newline at end of file
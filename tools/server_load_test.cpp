@@ -0,0 +1,297 @@
+/*
+Load test of the game server. It starts a server in this process, opens a number of client connections and creates
+many games spread over them, then plays random games on all of them at once, one request in flight per connection.
+It reports:
+    -the memory of an idle game: growth of the resident memory of the process while the games are created, divided by
+     the number of games (the clients only keep the game numbers, so nearly all of it is the server's)
+    -the latency of a move request as the clients see it (round trip over the socket, including the wait for a worker),
+     and the server's own figures from the stats command
+Options:
+    --sessions=<n>      number of games (default 10000)
+    --connections=<n>   number of client connections, each one played from its own thread (default 32)
+    --plies=<n>         moves played in each game, unless it ends before (default 40)
+    --threads=<n>       worker threads of the server (default: all the cores)
+    --socket=<path>     socket of the server (default /tmp/chess_server_load_test.sock)
+Build on Linux (from the repository root):
+    g++ -std=c++17 -O2 -pthread -Iinclude tools/server_load_test.cpp $(find src -name '*.cpp' ! -name main.cpp) -o server_load_test
+    ./server_load_test --sessions=20000
+*/
+
+#include "game_server.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    struct options {
+        size_t sessions{ 10000 };
+        size_t connections{ 32 };
+        int plies{ 40 };
+        size_t threads{ std::max(1u, std::thread::hardware_concurrency()) };
+        std::string socket_path{ "/tmp/chess_server_load_test.sock" };
+    };
+
+    options parse_options(const int& argc, char** argv) {
+        options settings;
+        for (int i{ 1 }; i < argc; i++) {
+            std::string argument{ argv[i] };
+            if (argument.rfind("--sessions=", 0) == 0) {
+                settings.sessions = static_cast<size_t>(std::max(1, std::atoi(argument.c_str() + 11)));
+            }
+            else if (argument.rfind("--connections=", 0) == 0) {
+                settings.connections = static_cast<size_t>(std::max(1, std::atoi(argument.c_str() + 14)));
+            }
+            else if (argument.rfind("--plies=", 0) == 0) {
+                settings.plies = std::max(0, std::atoi(argument.c_str() + 8));
+            }
+            else if (argument.rfind("--threads=", 0) == 0) {
+                settings.threads = static_cast<size_t>(std::max(1, std::atoi(argument.c_str() + 10)));
+            }
+            else if (argument.rfind("--socket=", 0) == 0) {
+                settings.socket_path = argument.substr(9);
+            }
+            else {
+                throw std::invalid_argument("Unknown option " + argument);
+            }
+        }
+        settings.connections = std::min(settings.connections, settings.sessions);
+        return settings;
+    }
+
+    size_t resident_memory_kib() {
+        size_t total_pages{};
+        size_t resident_pages{};
+        std::FILE* statm{ std::fopen("/proc/self/statm", "r") };
+        if (statm) {
+            if (std::fscanf(statm, "%zu %zu", &total_pages, &resident_pages) != 2) {
+                resident_pages = 0;
+            }
+            std::fclose(statm);
+        }
+        return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+    }
+
+    //Blocking client connection that sends lines and reads the answers
+    class client {
+    private:
+        int fd{ -1 };
+        std::string buffer;
+    public:
+        client(const std::string& socket_path) {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+            fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+                throw std::runtime_error("Could not connect to " + socket_path);
+            }
+        }
+        ~client() {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        client(const client&) = delete;
+        client& operator=(const client&) = delete;
+
+        void send_line(const std::string& line) {
+            std::string text{ line + '\n' };
+            size_t sent{};
+            while (sent < text.size()) {
+                ssize_t written{ send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL) };
+                if (written <= 0) {
+                    throw std::runtime_error("The server closed the connection");
+                }
+                sent += static_cast<size_t>(written);
+            }
+        }
+        std::string read_line() {
+            size_t end;
+            while ((end = buffer.find('\n')) == std::string::npos) {
+                char chunk[4096];
+                ssize_t bytes_read{ recv(fd, chunk, sizeof(chunk), 0) };
+                if (bytes_read <= 0) {
+                    throw std::runtime_error("The server closed the connection");
+                }
+                buffer.append(chunk, static_cast<size_t>(bytes_read));
+            }
+            std::string line{ buffer.substr(0, end) };
+            buffer.erase(0, end + 1);
+            return line;
+        }
+        std::string request(const std::string& line) {
+            send_line(line);
+            return read_line();
+        }
+    };
+
+    std::vector<std::string> split_words(const std::string& line) {
+        std::vector<std::string> words;
+        size_t start{ line.find_first_not_of(' ') };
+        while (start != std::string::npos) {
+            size_t end{ line.find(' ', start) };
+            words.push_back(line.substr(start, end - start));
+            start = line.find_first_not_of(' ', end);
+        }
+        return words;
+    }
+
+    struct client_results {
+        std::vector<double> move_latencies_us;
+        size_t finished_games{};
+        std::string error;
+    };
+
+    //Play random moves on the games of one connection, one game after the other in each round
+    void play_games(client& connection, const std::vector<std::string>& game_ids, const int& plies, const unsigned& seed, client_results& results) {
+        std::mt19937 random_generator{ seed };
+        std::vector<bool> finished(game_ids.size(), false);
+        try {
+            for (int ply{}; ply < plies; ply++) {
+                for (size_t game{}; game < game_ids.size(); game++) {
+                    if (finished[game]) {
+                        continue;
+                    }
+                    std::vector<std::string> moves{ split_words(connection.request("moves " + game_ids[game])) };
+                    if (moves.size() < 3 || moves[0] != "ok") {
+                        finished[game] = true;
+                        results.finished_games++;
+                        continue;
+                    }
+                    const std::string& chosen{ moves[2 + random_generator() % (moves.size() - 2)] };
+                    auto start{ std::chrono::steady_clock::now() };
+                    std::vector<std::string> answer{ split_words(connection.request(
+                        "move " + game_ids[game] + ' ' + chosen.substr(0, 2) + ' ' + chosen.substr(2, 2))) };
+                    results.move_latencies_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+                    if (answer.size() < 3 || answer[0] != "ok") {
+                        throw std::runtime_error("Move refused: " + (answer.empty() ? std::string{} : answer.back()));
+                    }
+                    if (answer[2] != "playing") {
+                        finished[game] = true;
+                        results.finished_games++;
+                    }
+                }
+            }
+        }
+        catch (const std::exception& play_err) {
+            results.error = play_err.what();
+        }
+    }
+
+    //Runs the server on its own thread, and stops it when leaving the scope, also after an error
+    class server_thread {
+    private:
+        game_server& server;
+        std::thread thread;
+    public:
+        server_thread(game_server& server_in) : server{ server_in }, thread{ [this]() { server.run(); } } {}
+        ~server_thread() {
+            server.stop();
+            thread.join();
+        }
+    };
+
+    double percentile(std::vector<double>& values, const double& fraction) {
+        if (values.empty()) {
+            return 0;
+        }
+        size_t index{ std::min(values.size() - 1, static_cast<size_t>(fraction * values.size())) };
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        options settings{ parse_options(argc, argv) };
+        thread_pool pool{ settings.threads };
+        game_server server{ settings.socket_path, pool };
+        server_thread running_server{ server };
+
+        std::vector<std::unique_ptr<client>> connections;
+        for (size_t connection{}; connection < settings.connections; connection++) {
+            connections.push_back(std::make_unique<client>(settings.socket_path));
+        }
+        //Create the games with all the requests of a connection sent at once, in batches
+        std::vector<std::vector<std::string>> game_ids(settings.connections);
+        size_t memory_before{ resident_memory_kib() };
+        auto creation_start{ std::chrono::steady_clock::now() };
+        constexpr size_t batch_size{ 1000 };
+        for (size_t created{}; created < settings.sessions; ) {
+            size_t batch_end{ std::min(settings.sessions, created + batch_size * settings.connections) };
+            for (size_t game{ created }; game < batch_end; game++) {
+                connections[game % settings.connections]->send_line("new");
+            }
+            for (size_t game{ created }; game < batch_end; game++) {
+                std::vector<std::string> answer{ split_words(connections[game % settings.connections]->read_line()) };
+                if (answer.size() != 2 || answer[0] != "ok") {
+                    throw std::runtime_error("Could not create a game");
+                }
+                game_ids[game % settings.connections].push_back(answer[1]);
+            }
+            created = batch_end;
+        }
+        double creation_time{ std::chrono::duration<double>(std::chrono::steady_clock::now() - creation_start).count() };
+        size_t memory_after{ resident_memory_kib() };
+        std::cout << "Created " << settings.sessions << " games over " << settings.connections << " connections in "
+            << creation_time << " s. Memory of an idle game: "
+            << (memory_after - memory_before) * 1024.0 / settings.sessions << " bytes (resident memory "
+            << memory_before / 1024 << " MiB -> " << memory_after / 1024 << " MiB)" << std::endl;
+
+        std::vector<client_results> results(settings.connections);
+        std::vector<std::thread> players;
+        auto play_start{ std::chrono::steady_clock::now() };
+        for (size_t connection{}; connection < settings.connections; connection++) {
+            players.emplace_back(play_games, std::ref(*connections[connection]), std::cref(game_ids[connection]),
+                settings.plies, static_cast<unsigned>(connection + 1), std::ref(results[connection]));
+        }
+        for (std::thread& player : players) {
+            player.join();
+        }
+        double play_time{ std::chrono::duration<double>(std::chrono::steady_clock::now() - play_start).count() };
+
+        std::vector<double> latencies;
+        size_t finished_games{};
+        for (const client_results& result : results) {
+            if (!result.error.empty()) {
+                throw std::runtime_error(result.error);
+            }
+            latencies.insert(latencies.end(), result.move_latencies_us.begin(), result.move_latencies_us.end());
+            finished_games += result.finished_games;
+        }
+        size_t moves_played{ latencies.size() };
+        std::cout << "Played " << moves_played << " moves (" << finished_games << " games ended) in " << play_time << " s: "
+            << moves_played / play_time << " moves/s with " << settings.connections << " requests in flight and "
+            << pool.size() << " worker threads" << std::endl;
+        std::cout << "Move round trip: p50 " << percentile(latencies, 0.5) << " us, p90 " << percentile(latencies, 0.9)
+            << " us, p99 " << percentile(latencies, 0.99) << " us, max " << percentile(latencies, 1.0) << " us" << std::endl;
+        std::cout << "Server stats: " << connections[0]->request("stats") << std::endl;
+    }
+    catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+#else
+int main() {
+    std::cout << "The server load test only supports Linux" << std::endl;
+    return 0;
+}
+#endif
@@ -0,0 +1,191 @@
+/*
+Endgame tablebase generator. It generates the tables of the given materials (or every table up to a number of pieces) on
+all the cores, prints the number of wins, draws and losses and the longest mate of each one, and checks a sample of
+positions: the result of each one must follow from the results of the positions after its moves (a checkmate is a loss
+in 0 plies, a win is one ply longer than the fastest loss it can move to, and so on).
+
+Options:
+    --pieces=<n>        generate every table with up to n pieces, from 3 to 4 (default 3)
+    --material=<name>   generate only this table and the ones it needs, e.g. KQK or KRKP (can be repeated)
+    --threads=<n>       number of threads (default: all the cores)
+    --verify=<n>        positions checked per table (default 100000)
+Build on Linux (from the repository root):
+    g++ -std=c++17 -O2 -pthread -Iinclude tools/tablebase_generator.cpp $(find src -name '*.cpp' ! -name main.cpp) -o tablebase_generator
+    ./tablebase_generator --pieces=4
+*/
+
+#include "tablebase.h"
+#include "position.h"
+#include "thread_pool.h"
+#include "enum_attributes.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct options {
+        int pieces{ 3 };
+        std::vector<std::string> materials;
+        size_t threads{ std::max(1u, std::thread::hardware_concurrency()) };
+        size_t positions_to_verify{ 100000 };
+    };
+
+    options parse_options(const int& argc, char** argv) {
+        options settings;
+        for (int i{ 1 }; i < argc; i++) {
+            std::string argument{ argv[i] };
+            if (argument.rfind("--pieces=", 0) == 0) {
+                settings.pieces = std::clamp(std::atoi(argument.c_str() + 9), 3, tablebase::max_pieces);
+            }
+            else if (argument.rfind("--material=", 0) == 0) {
+                settings.materials.push_back(argument.substr(11));
+            }
+            else if (argument.rfind("--threads=", 0) == 0) {
+                settings.threads = static_cast<size_t>(std::max(1, std::atoi(argument.c_str() + 10)));
+            }
+            else if (argument.rfind("--verify=", 0) == 0) {
+                settings.positions_to_verify = static_cast<size_t>(std::max(0, std::atoi(argument.c_str() + 9)));
+            }
+            else {
+                throw std::invalid_argument("Unknown option " + argument);
+            }
+        }
+        return settings;
+    }
+
+    //Random legal position of a material, e.g. "KRKP"
+    bool random_position(const std::string& material, std::mt19937_64& random_generator, position& random_position_out) {
+        std::array<std::uint8_t, 64> squares{};
+        piece_colour colour{ piece_colour::white };
+        for (size_t index{}; index < material.size(); index++) {
+            if (index > 0 && material[index] == 'K') {
+                colour = piece_colour::black;
+            }
+            piece_symbol symbol{ piece_symbol::king };
+            switch (material[index]) {
+            case 'Q': symbol = piece_symbol::queen; break;
+            case 'R': symbol = piece_symbol::rook; break;
+            case 'B': symbol = piece_symbol::bishop; break;
+            case 'N': symbol = piece_symbol::knight; break;
+            case 'P': symbol = piece_symbol::pawn; break;
+            default: break;
+            }
+            int square;
+            do {
+                square = static_cast<int>(random_generator() % 64);
+            } while (squares[square] != piece_code::empty ||
+                (symbol == piece_symbol::pawn && square / 8 == (colour == piece_colour::white ? 0 : 7)));
+            squares[square] = piece_code::make(colour, symbol);
+        }
+        piece_colour colour_turn{ random_generator() % 2 ? piece_colour::white : piece_colour::black };
+        random_position_out = position{ squares, colour_turn };
+        //The colour that just moved cannot have left its king in check
+        return !random_position_out.is_attacked(random_position_out.get_king_square(opposite_colour(colour_turn)), colour_turn);
+    }
+
+    //Returns an empty string if the result of the position follows from the results after its moves
+    std::string check_position(const tablebase& tables, const position& checked_position) {
+        tablebase_result result;
+        if (!tables.probe(checked_position, result)) {
+            return "no result";
+        }
+        move_list legal_moves;
+        checked_position.generate_legal_moves(legal_moves);
+        tablebase_result expected;
+        if (legal_moves.empty()) {
+            expected.wdl = checked_position.in_check() ? tablebase_wdl::loss : tablebase_wdl::draw;
+        }
+        else {
+            int fastest_win{ -1 };
+            int slowest_loss{ -1 };
+            bool any_draw{ false };
+            position next{ checked_position };
+            for (const chess_move& legal_move : legal_moves) {
+                std::uint8_t captured{ next.make_move(legal_move) };
+                tablebase_result next_result;
+                bool found{ tables.probe(next, next_result) };
+                next.unmake_move(legal_move, captured);
+                if (!found) {
+                    return "no result after a move";
+                }
+                if (next_result.wdl == tablebase_wdl::loss) {
+                    fastest_win = (fastest_win < 0) ? next_result.plies_to_mate + 1 : std::min(fastest_win, next_result.plies_to_mate + 1);
+                }
+                else if (next_result.wdl == tablebase_wdl::draw) {
+                    any_draw = true;
+                }
+                else {
+                    slowest_loss = std::max(slowest_loss, next_result.plies_to_mate + 1);
+                }
+            }
+            if (fastest_win >= 0) {
+                expected = { tablebase_wdl::win, fastest_win };
+            }
+            else if (!any_draw) {
+                expected = { tablebase_wdl::loss, slowest_loss };
+            }
+        }
+        if (expected.wdl != result.wdl || expected.plies_to_mate != result.plies_to_mate) {
+            return "stored " + std::to_string(static_cast<int>(result.wdl)) + " in " + std::to_string(result.plies_to_mate) +
+                ", expected " + std::to_string(static_cast<int>(expected.wdl)) + " in " + std::to_string(expected.plies_to_mate);
+        }
+        return "";
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        options settings{ parse_options(argc, argv) };
+        thread_pool pool{ settings.threads };
+        tablebase tables;
+        auto start{ std::chrono::steady_clock::now() };
+        if (settings.materials.empty()) {
+            tables.generate_all(settings.pieces, pool);
+        }
+        for (const std::string& material : settings.materials) {
+            tables.generate(material, pool);
+        }
+        double elapsed{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+        std::cout << "Generated " << tables.get_table_info().size() << " tables (" << tables.memory_usage() / 1024
+            << " KiB) in " << elapsed << " s on " << pool.size() << " threads." << std::endl;
+
+        std::mt19937_64 random_generator{ 1 };
+        int failures{};
+        for (const tablebase_table_info& info : tables.get_table_info()) {
+            std::cout << info.material << ": " << info.positions << " positions, " << info.wins << " wins, " << info.draws
+                << " draws, " << info.losses << " losses, longest mate " << info.longest_mate << " plies" << std::endl;
+            size_t checked{};
+            while (checked < settings.positions_to_verify) {
+                position checked_position;
+                if (!random_position(info.material, random_generator, checked_position)) {
+                    continue;
+                }
+                checked++;
+                std::string error{ check_position(tables, checked_position) };
+                if (!error.empty()) {
+                    std::cout << "    WRONG RESULT " << checked_position.to_fen() << ": " << error << std::endl;
+                    if (++failures >= 10) {
+                        return 1;
+                    }
+                }
+            }
+        }
+        if (failures > 0) {
+            return 1;
+        }
+        std::cout << "All the positions checked agree with the results after their moves." << std::endl;
+    }
+    catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}